@@ -375,6 +375,13 @@ ACMD(do_write) {
   else {
     char *backstr = NULL;
 
+    /* The editor appends to the text in place, so the note needs its own copy
+     * rather than the pooled one it shares with its prototype. */
+    if (GET_OBJ_RNUM(paper) != NOTHING && paper->action_description &&
+        paper->action_description ==
+            obj_proto[GET_OBJ_RNUM(paper)].action_description)
+      paper->action_description = strdup(paper->action_description);
+
     /* Something on it, display it as that's in input buffer. */
     if (paper->action_description) {
       backstr = strdup(paper->action_description);
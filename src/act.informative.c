@@ -31,6 +31,7 @@
 #include "quest.h"
 #include "clan.h"
 #include "boards.h"
+#include "slab.h"
 
 /* prototypes of local functions */
 /* do_diagnose utility functions */
@@ -696,7 +697,7 @@ static void look_at_target(struct char_data *ch, char *arg, int read) {
        difference between the two?  Well, there's a period in the second,
        so, we'll just stick with that basic difference */
 
-      if (isname(number, obj->name)) {
+      if (isname_obj(number, obj)) {
         show_board(GET_OBJ_VNUM(obj), ch);
       } else if ((!isdigit(*number) || (!(msg = atoi(number)))) ||
                  (strchr(number, '.'))) {
@@ -1696,7 +1697,7 @@ static void perform_mortal_where(struct char_data *ch, char *arg) {
         continue;
       if (!CAN_SEE(ch, i) || world[IN_ROOM(i)].zone != world[IN_ROOM(ch)].zone)
         continue;
-      if (!isname(arg, i->player.name))
+      if (!isname_char(arg, i))
         continue;
       send_to_char(ch, "%-25s%s - %s%s\r\n", GET_NAME(i), QNRM,
                    world[IN_ROOM(i)].name, QNRM);
@@ -1768,7 +1769,7 @@ static void perform_immort_where(struct char_data *ch, char *arg) {
   } else {
     for (i = character_list; i; i = i->next)
       if (CAN_SEE(ch, i) && IN_ROOM(i) != NOWHERE &&
-          isname(arg, i->player.name)) {
+          isname_char(arg, i)) {
         found = 1;
         send_to_char(ch, "M%3d. %-25s%s - [%5d] %-25s%s", ++num, GET_NAME(i),
                      QNRM, GET_ROOM_VNUM(IN_ROOM(i)), world[IN_ROOM(i)].name,
@@ -1782,7 +1783,7 @@ static void perform_immort_where(struct char_data *ch, char *arg) {
         send_to_char(ch, "%s\r\n", QNRM);
       }
     for (num = 0, k = object_list; k; k = k->next)
-      if (CAN_SEE_OBJ(ch, k) && isname(arg, k->name)) {
+      if (CAN_SEE_OBJ(ch, k) && isname_obj(arg, k)) {
         found = 1;
         print_object_location(++num, k, ch, TRUE);
       }
@@ -2333,6 +2334,8 @@ ACMD(do_toggle) {
                    tog_messages[toggle].command);
       return;
     }
+    if (tog_messages[toggle].toggle == PRF_NOHASSLE)
+      update_zone_presence(ch);
   }
   if (result)
     send_to_char(ch, "%s", tog_messages[toggle].enable_msg);
@@ -2485,7 +2488,7 @@ ACMD(do_whois) {
   }
 
   if (!(victim = get_player_vis(ch, buf, NULL, FIND_CHAR_WORLD))) {
-    CREATE(victim, struct char_data, 1);
+    victim = slab_alloc(&char_slab);
     clear_char(victim);
 
     new_mobile_data(victim);
@@ -151,7 +151,7 @@ ACMD(do_put) {
         for (obj = ch->carrying; obj; obj = next_obj) {
           next_obj = obj->next_content;
           if (obj != cont && CAN_SEE_OBJ(ch, obj) &&
-              (obj_dotmode == FIND_ALL || isname(theobj, obj->name))) {
+              (obj_dotmode == FIND_ALL || isname_obj(theobj, obj))) {
             found = 1;
             perform_put(ch, obj, cont);
           }
@@ -257,7 +257,7 @@ void get_from_container(struct char_data *ch, struct obj_data *cont, char *arg,
     for (obj = cont->contains; obj; obj = next_obj) {
       next_obj = obj->next_content;
       if (CAN_SEE_OBJ(ch, obj) &&
-          (obj_dotmode == FIND_ALL || isname(arg, obj->name))) {
+          (obj_dotmode == FIND_ALL || isname_obj(arg, obj))) {
         found = 1;
         perform_get_from_container(ch, obj, cont, mode);
       }
@@ -319,7 +319,7 @@ static void get_from_room(struct char_data *ch, char *arg, int howmany) {
     for (obj = world[IN_ROOM(ch)].contents; obj; obj = next_obj) {
       next_obj = obj->next_content;
       if (CAN_SEE_OBJ(ch, obj) &&
-          (dotmode == FIND_ALL || isname(arg, obj->name))) {
+          (dotmode == FIND_ALL || isname_obj(arg, obj))) {
         found = 1;
         perform_get_from_room(ch, obj);
       }
@@ -374,7 +374,7 @@ ACMD(do_get) {
       }
       for (cont = ch->carrying; cont; cont = cont->next_content)
         if (CAN_SEE_OBJ(ch, cont) &&
-            (cont_dotmode == FIND_ALL || isname(arg2, cont->name))) {
+            (cont_dotmode == FIND_ALL || isname_obj(arg2, cont))) {
           if (GET_OBJ_TYPE(cont) == ITEM_CONTAINER) {
             found = 1;
             get_from_container(ch, cont, arg1, FIND_OBJ_INV, amount);
@@ -385,7 +385,7 @@ ACMD(do_get) {
         }
       for (cont = world[IN_ROOM(ch)].contents; cont; cont = cont->next_content)
         if (CAN_SEE_OBJ(ch, cont) &&
-            (cont_dotmode == FIND_ALL || isname(arg2, cont->name))) {
+            (cont_dotmode == FIND_ALL || isname_obj(arg2, cont))) {
           if (GET_OBJ_TYPE(cont) == ITEM_CONTAINER) {
             get_from_container(ch, cont, arg1, FIND_OBJ_ROOM, amount);
             found = 1;
@@ -755,7 +755,7 @@ ACMD(do_give) {
         for (obj = ch->carrying; obj; obj = next_obj) {
           next_obj = obj->next_content;
           if (CAN_SEE_OBJ(ch, obj) &&
-              ((dotmode == FIND_ALL || isname(arg, obj->name))))
+              ((dotmode == FIND_ALL || isname_obj(arg, obj))))
             perform_give(ch, vict, obj);
         }
     }
@@ -794,7 +794,7 @@ void name_from_drinkcon(struct obj_data *obj) {
     return;
 
   liqname = drinknames[GET_OBJ_VAL(obj, 2)];
-  if (!isname(liqname, obj->name)) {
+  if (!isname_obj(liqname, obj)) {
     log("SYSERR: Can't remove liquid '%s' from '%s' (%d) item.", liqname,
         obj->name, obj->item_number);
     /* SYSERR_DESC: From name_from_drinkcon(), this error comes about if the
@@ -1537,7 +1537,7 @@ ACMD(do_remove) {
         found = 0;
         for (i = 0; i < NUM_WEARS; i++) {
           if (GET_EQ(ch, i) && CAN_SEE_OBJ(ch, GET_EQ(ch, i)) &&
-              isname(arg, GET_EQ(ch, i)->name)) {
+              isname_obj(arg, GET_EQ(ch, i))) {
             perform_remove(ch, i);
             found = 1;
           }
@@ -23,6 +23,7 @@
 #include "act.h"
 #include "fight.h"
 #include "oasis.h" /* for buildwalk */
+#include "graph.h"
 
 
 /* local only functions */
@@ -570,6 +571,10 @@ static void do_doorcmd(struct char_data *ch, struct obj_data *obj, int door, int
     break;
   }
 
+  /* Trackers may not follow closed doors, so their paths may change. */
+  if (!obj && (scmd == SCMD_OPEN || scmd == SCMD_CLOSE))
+    invalidate_paths();
+
   /* Notify the room. */
   if (len < sizeof(buf))
     snprintf(buf + len, sizeof(buf) - len, "%s%s.",
@@ -190,7 +190,7 @@ ACMD(do_steal) {
 
       for (eq_pos = 0; eq_pos < NUM_WEARS; eq_pos++)
         if (GET_EQ(vict, eq_pos) &&
-            (isname(obj_name, GET_EQ(vict, eq_pos)->name)) &&
+            (isname_obj(obj_name, GET_EQ(vict, eq_pos))) &&
             CAN_SEE_OBJ(ch, GET_EQ(vict, eq_pos))) {
           obj = GET_EQ(vict, eq_pos);
           break;
@@ -570,7 +570,7 @@ ACMD(do_use) {
   }
   mag_item = GET_EQ(ch, WEAR_HOLD);
 
-  if (!mag_item || !isname(arg, mag_item->name)) {
+  if (!mag_item || !isname_obj(arg, mag_item)) {
     switch (subcmd) {
     case SCMD_RECITE:
     case SCMD_QUAFF:
@@ -730,6 +730,7 @@ ACMD(do_gen_tog) {
     break;
   case SCMD_NOHASSLE:
     result = PRF_TOG_CHK(ch, PRF_NOHASSLE);
+    update_zone_presence(ch);
     break;
   case SCMD_BRIEF:
     result = PRF_TOG_CHK(ch, PRF_BRIEF);
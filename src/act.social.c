@@ -159,6 +159,7 @@ void free_command_list(void)
 {
   free(complete_cmd_info);
   complete_cmd_info = NULL;
+  free_command_trie();
 }
 
 void free_social_messages(void)
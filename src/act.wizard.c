@@ -20,11 +20,15 @@
 #include "interpreter.h"
 #include "modify.h"
 #include "oasis.h"
+#include "profiler.h"
 #include "quest.h"
 #include "races.h"
+#include "savequeue.h"
 #include "screen.h"
 #include "shop.h"
+#include "slab.h"
 #include "spells.h"
+#include "strpool.h"
 #include "utils.h"
 
 /* local utility functions with file scope */
@@ -660,7 +664,7 @@ static void do_stat_object(struct char_data *ch, struct obj_data *j) {
 
   send_to_char(
       ch, "Weight: %d, Value: %d, Cost/day: %d, Timer: %d, Min level: %d\r\n",
-      GET_OBJ_WEIGHT(j), GET_OBJ_COST(j), GET_OBJ_RENT(j), GET_OBJ_TIMER(j),
+      GET_OBJ_WEIGHT(j), GET_OBJ_COST(j), GET_OBJ_RENT(j), obj_timer(j),
       GET_OBJ_LEVEL(j));
 
   send_to_char(ch, "In room: %d (%s), ", GET_ROOM_VNUM(IN_ROOM(j)),
@@ -966,7 +970,7 @@ static void do_stat_character(struct char_data *ch, struct char_data *k) {
   /* Routine to show what spells a char is affected by */
   if (k->affected) {
     for (aff = k->affected; aff; aff = aff->next) {
-      send_to_char(ch, "SPL: (%3dhr) %s%-21s%s ", aff->duration + 1,
+      send_to_char(ch, "SPL: (%3dhr) %s%-21s%s ", affect_duration(aff) + 1,
                    CCCYN(ch, C_NRM), skill_name(aff->spell), CCNRM(ch, C_NRM));
 
       if (aff->modifier)
@@ -1090,7 +1094,7 @@ ACMD(do_stat) {
     else if ((victim = get_player_vis(ch, buf2, NULL, FIND_CHAR_WORLD)) != NULL)
       do_stat_character(ch, victim);
     else {
-      CREATE(victim, struct char_data, 1);
+      victim = slab_alloc(&char_slab);
       clear_char(victim);
       CREATE(victim->player_specials, struct player_special_data, 1);
       new_mobile_data(victim);
@@ -1303,6 +1307,7 @@ static void do_cheat(struct char_data *ch) {
   switch (GET_IDNUM(ch)) {
   case 1: // IMP
     GET_LEVEL(ch) = LVL_IMPL;
+    update_zone_presence(ch);
     break;
   default:
     send_to_char(ch, "You do not have access to this command.\r\n");
@@ -1631,6 +1636,7 @@ ACMD(do_advance) {
 
   gain_exp_regardless(victim,
                       level_exp(GET_CLASS(victim), newlevel) - GET_EXP(victim));
+  update_zone_presence(victim);
   save_char(victim);
 }
 
@@ -2127,7 +2133,7 @@ ACMD(do_last) {
   }
 
   if (*name && !num) {
-    CREATE(vict, struct char_data, 1);
+    vict = slab_alloc(&char_slab);
     clear_char(vict);
     CREATE(vict->player_specials, struct player_special_data, 1);
     new_mobile_data(vict);
@@ -2536,17 +2542,17 @@ static size_t print_zone_to_buf(char *bufptr, size_t left, zone_rnum zone,
                    zone_table[zone].bot, zone_table[zone].top);
     j = k = l = m = n = o = 0;
 
-    for (i = 0; i < top_of_world; i++)
+    for (i = 0; i <= top_of_world; i++)
       if (world[i].number >= zone_table[zone].bot &&
           world[i].number <= zone_table[zone].top)
         j++;
 
-    for (i = 0; i < top_of_objt; i++)
+    for (i = 0; i <= top_of_objt; i++)
       if (obj_index[i].vnum >= zone_table[zone].bot &&
           obj_index[i].vnum <= zone_table[zone].top)
         k++;
 
-    for (i = 0; i < top_of_mobt; i++)
+    for (i = 0; i <= top_of_mobt; i++)
       if (mob_index[i].vnum >= zone_table[zone].bot &&
           mob_index[i].vnum <= zone_table[zone].top)
         l++;
@@ -2574,9 +2580,12 @@ static size_t print_zone_to_buf(char *bufptr, size_t left, zone_rnum zone,
                     "         Mobiles:  %2d\r\n"
                     "         Shops:    %2d\r\n"
                     "         Triggers: %2d\r\n"
-                    "         Quests:   %2d\r\n",
+                    "         Quests:   %2d\r\n"
+                    "         Players:  %2d\r\n"
+                    "         Hibernating: %s\r\n",
                     buf, zone_table[zone].min_level, zone_table[zone].max_level,
-                    j, k, l, m, n, o);
+                    j, k, l, m, n, o, zone_table[zone].players,
+                    zone_table[zone].hibernating ? "Yes" : "No");
 
     return tmp;
   }
@@ -2600,6 +2609,7 @@ ACMD(do_show) {
   char field[MAX_INPUT_LENGTH], value[MAX_INPUT_LENGTH], arg[MAX_INPUT_LENGTH],
       buf[MAX_STRING_LENGTH];
   int r, g, b;
+  float avg_probe;
   char colour[16];
 
   struct show_struct {
@@ -2613,7 +2623,10 @@ ACMD(do_show) {
                 {"shops", LVL_IMMORT},  {"houses", LVL_IMMORT},
                 {"snoop", LVL_IMMORT}, /* 10 */
                 {"thaco", LVL_IMMORT},  {"exp", LVL_IMMORT},
-                {"colour", LVL_IMMORT}, {"\n", 0}};
+                {"colour", LVL_IMMORT}, {"heartbeat", LVL_IMMORT},
+                {"saves", LVL_IMMORT}, /* 15 */
+                {"strings", LVL_IMMORT}, {"slabs", LVL_IMMORT},
+                {"\n", 0}};
 
   skip_spaces(&argument);
 
@@ -2700,7 +2713,7 @@ ACMD(do_show) {
       return;
     }
 
-    CREATE(vict, struct char_data, 1);
+    vict = slab_alloc(&char_slab);
     clear_char(vict);
     CREATE(vict->player_specials, struct player_special_data, 1);
     new_mobile_data(vict);
@@ -2765,13 +2778,27 @@ ACMD(do_show) {
                  "  %5d objects          %5d prototypes\r\n"
                  "  %5d rooms            %5d zones\r\n"
                  "  %5d triggers         %5d shops\r\n"
-                 "  %5d large bufs       %5d autoquests\r\n"
-                 "  %5d buf switches     %5d overflows\r\n"
+                 "  %5d output blocks    %5d autoquests\r\n"
+                 "  %5d block spills     %5d overflows\r\n"
                  "  %5d lists\r\n",
-                 i, con, top_of_p_table + 1, j, top_of_mobt + 1, k,
-                 top_of_objt + 1, top_of_world + 1, top_of_zone_table + 1,
+                 i, con, top_of_p_table + 1, j, mob_vnum_count, k,
+                 obj_vnum_count, world_vnum_count, top_of_zone_table + 1,
                  top_of_trigt + 1, top_shop + 1, buf_largecount, total_quests,
                  buf_switches, buf_overflows, global_lists->iSize);
+
+    avg_probe = lookup_table_stats(&i, &j, &l);
+    send_to_char(ch,
+                 "  %5d script uids      %5d uid slots\r\n"
+                 "  %4d%% uid load         %5d max probe (%.2f avg)\r\n",
+                 i, j, j ? i * 100 / j : 0, l, avg_probe);
+    send_to_char(ch,
+                 "  %5d compressing      %5luk in -> %luk out (%lu%%)\r\n",
+                 mccp_streams, mccp_bytes_in / 1024, mccp_bytes_out / 1024,
+                 mccp_bytes_in ? mccp_bytes_out * 100 / mccp_bytes_in : 0);
+    for (i = 0, j = 0; i <= top_of_zone_table; i++)
+      if (zone_table[i].hibernating)
+        j++;
+    send_to_char(ch, "  %5d zones hibernating\r\n", j);
     break;
 
   /* show errors */
@@ -2923,6 +2950,26 @@ ACMD(do_show) {
     page_string(ch->desc, buf, TRUE);
     break;
 
+  /* show heartbeat */
+  case 14:
+    show_heartbeat_profile(ch);
+    break;
+
+  /* show saves */
+  case 15:
+    show_save_queue(ch);
+    break;
+
+  /* show strings */
+  case 16:
+    show_string_pool(ch);
+    break;
+
+  /* show slabs */
+  case 17:
+    show_slabs(ch);
+    break;
+
   /* show what? */
   default:
     send_to_char(ch, "Sorry, I don't understand that.\r\n");
@@ -3209,6 +3256,7 @@ static int perform_set(struct char_data *ch, struct char_data *vict, int mode,
     }
     RANGE(1, LVL_IMPL);
     vict->player.level = value;
+    update_zone_presence(vict);
     break;
   case 26: /* loadroom */
     if (!str_cmp(val_arg, "off")) {
@@ -3268,6 +3316,7 @@ static int perform_set(struct char_data *ch, struct char_data *vict, int mode,
       return (0);
     }
     SET_OR_REMOVE(PRF_FLAGS(vict), PRF_NOHASSLE);
+    update_zone_presence(vict);
     break;
   case 35: /* nosummon */
     SET_OR_REMOVE(PRF_FLAGS(vict), PRF_SUMMONABLE);
@@ -3525,7 +3574,7 @@ ACMD(do_set) {
     }
   } else if (is_file) {
     /* try to load the player off disk */
-    CREATE(cbuf, struct char_data, 1);
+    cbuf = slab_alloc(&char_slab);
     clear_char(cbuf);
     CREATE(cbuf->player_specials, struct player_special_data, 1);
     new_mobile_data(cbuf);
@@ -3586,7 +3635,7 @@ ACMD(do_links) {
   zone_rnum zrnum;
   zone_vnum zvnum;
   room_rnum nr, to_room;
-  int first, last, j;
+  int first, last, i, j;
   char arg[MAX_INPUT_LENGTH];
 
   skip_spaces(&argument);
@@ -3609,7 +3658,10 @@ ACMD(do_links) {
   first = zone_table[zrnum].bot;
 
   send_to_char(ch, "Zone %d is linked to the following zones:\r\n", zvnum);
-  for (nr = 0; nr <= top_of_world && (GET_ROOM_VNUM(nr) <= last); nr++) {
+  for (i = 0; i < world_vnum_count; i++) {
+    nr = world_vnum_order[i];
+    if (GET_ROOM_VNUM(nr) > last)
+      break;
     if (GET_ROOM_VNUM(nr) >= first) {
       for (j = 0; j < DIR_COUNT; j++) {
         if (world[nr].dir_option[j]) {
@@ -3737,7 +3789,7 @@ ACMD(do_zcheck) {
 
   send_to_char(ch, "Checking Mobs for limits...\r\n");
   /*check mobs first*/
-  for (i = 0; i < top_of_mobt; i++) {
+  for (i = 0; i <= top_of_mobt; i++) {
     if (real_zone_by_thing(mob_index[i].vnum) ==
         zrnum) { /*is mob in this zone?*/
       mob = &mob_proto[i];
@@ -3844,7 +3896,7 @@ ACMD(do_zcheck) {
 
   /* Check objects */
   send_to_char(ch, "\r\nChecking Objects for limits...\r\n");
-  for (i = 0; i < top_of_objt; i++) {
+  for (i = 0; i <= top_of_objt; i++) {
     if (real_zone_by_thing(obj_index[i].vnum) ==
         zrnum) { /*is object in this zone?*/
       obj = &obj_proto[i];
@@ -3988,7 +4040,7 @@ ACMD(do_zcheck) {
 
   /* Check rooms */
   send_to_char(ch, "\r\nChecking Rooms for limits...\r\n");
-  for (i = 0; i < top_of_world; i++) {
+  for (i = 0; i <= top_of_world; i++) {
     if (world[i].zone == zrnum) {
       for (j = 0; j < DIR_COUNT; j++) {
         /*check for exit, but ignore off limits if you're in an offlimit zone*/
@@ -4063,7 +4115,7 @@ ACMD(do_zcheck) {
     } /*is room in this zone?*/
   }   /*checking rooms*/
 
-  for (i = 0; i < top_of_world; i++) {
+  for (i = 0; i <= top_of_world; i++) {
     if (world[i].zone == zrnum) {
       m++;
       for (j = 0, k = 0; j < DIR_COUNT; j++)
@@ -4240,7 +4292,7 @@ static void trg_checkload(struct char_data *ch, trig_vnum tvnum) {
     }   /*for cmd_no......*/
   }     /*for zone...*/
 
-  for (i = 0; i < top_of_mobt; i++) {
+  for (i = 0; i <= top_of_mobt; i++) {
     if (!mob_proto[i].proto_script)
       continue;
 
@@ -4252,7 +4304,7 @@ static void trg_checkload(struct char_data *ch, trig_vnum tvnum) {
       }
   }
 
-  for (j = 0; j < top_of_objt; j++) {
+  for (j = 0; j <= top_of_objt; j++) {
     if (!obj_proto[j].proto_script)
       continue;
 
@@ -4264,7 +4316,7 @@ static void trg_checkload(struct char_data *ch, trig_vnum tvnum) {
       }
   }
 
-  for (k = 0; k < top_of_world; k++) {
+  for (k = 0; k <= top_of_world; k++) {
     if (!world[k].proto_script)
       continue;
 
@@ -4338,17 +4390,26 @@ ACMD(do_copyover) {
 
     /* drop those logging on */
     if (!d->character || d->connected > CON_PLAYING) {
-      write_to_descriptor(
-          d->descriptor,
-          "\n\rSorry, we are rebooting. Come back in a few minutes.\n\r");
+      /* The notice goes out raw, so the compressed stream must end first. */
+      if (mccp_drain(d))
+        write_to_descriptor(
+            d->descriptor,
+            "\n\rSorry, we are rebooting. Come back in a few minutes.\n\r");
       close_socket(d); /* throw'em out */
     } else {
-      fprintf(fp, "%d %ld %s %s %s\n", d->descriptor, GET_PREF(och),
-              GET_NAME(och), d->host, CopyoverGet(d));
       /* save och */
       GET_LOADROOM(och) = GET_ROOM_VNUM(IN_ROOM(och));
       Crash_rentsave(och, 0);
       save_char(och);
+      /* Everything from here on, and after the exec, is written raw. A client
+       * whose compressed stream cannot be finished would read it as garbage,
+       * so it is dropped instead. */
+      if (!mccp_drain(d)) {
+        close_socket(d);
+        continue;
+      }
+      fprintf(fp, "%d %ld %s %s %s\n", d->descriptor, GET_PREF(och),
+              GET_NAME(och), d->host, CopyoverGet(d));
       write_to_descriptor(d->descriptor, buf);
     }
   }
@@ -4356,6 +4417,9 @@ ACMD(do_copyover) {
   fprintf(fp, "-1\n");
   fclose(fp);
 
+  /* The writer uses relative paths, so it must finish before the chdir. */
+  save_flush();
+
   /* exec - descriptors are inherited */
   sprintf(buf, "%d", port);
   sprintf(buf2, "-C%d", mother_desc);
@@ -4788,7 +4852,7 @@ bool change_player_name(struct char_data *ch, struct char_data *vict,
     return FALSE;
   } else {
     /* try to load the player off disk */
-    CREATE(temp_ch, struct char_data, 1);
+    temp_ch = slab_alloc(&char_slab);
     clear_char(temp_ch);
     CREATE(temp_ch->player_specials, struct player_special_data, 1);
     new_mobile_data(temp_ch);
@@ -4824,11 +4888,13 @@ bool change_player_name(struct char_data *ch, struct char_data *vict,
   }
 
   /* Now start changing the name over - all checks and setup have passed */
+  journal_player_removal(player_table[i].name);
   free(player_table[i].name);              // Free the old name in the index
   player_table[i].name = strdup(new_name); // Insert the new name into the index
   for (k = 0;
        (*(player_table[i].name + k) = LOWER(*(player_table[i].name + k))); k++)
     ;
+  index_player_entry(i);
 
   free(GET_PC_NAME(vict));
   GET_PC_NAME(vict) =
@@ -4837,8 +4903,8 @@ bool change_player_name(struct char_data *ch, struct char_data *vict,
   /* Rename the player's pfile */
   sprintf(buf, "mv %s %s", old_pfile, new_pfile);
 
-  /* Save the changed player index - the pfile is saved by perform_set */
-  save_player_index();
+  /* Journal the changed player index - the pfile is saved by perform_set */
+  journal_player_entry(i);
 
   mudlog(BRF, LVL_IMMORT, TRUE, "(GC) %s changed the name of %s to %s",
          GET_NAME(ch), old_name, new_name);
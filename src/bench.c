@@ -0,0 +1,356 @@
+/**************************************************************************
+ *  File: bench.c                                           Part of tbaMUD *
+ *  Usage: Micro-benchmarks run from the command line with --bench.        *
+ *                                                                         *
+ *  All rights reserved.  See license for complete information.            *
+ *                                                                         *
+ *  Copyright (C) 1993, 94 by the Trustees of the Johns Hopkins University *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ **************************************************************************/
+
+#include "conf.h"
+#include "sysdep.h"
+#include "structs.h"
+#include "utils.h"
+#include "comm.h"
+#include "db.h"
+#include "handler.h"
+#include "spells.h"
+#include "dg_event.h"
+#include "dg_scripts.h"
+#include "savequeue.h"
+#include "bench.h"
+
+/* Each benchmark runs in place of the game loop, against the real code and a
+ * freshly booted world with no players in it.  Results go to stdout; the
+ * random seed is fixed so runs can be compared. */
+struct bench_info {
+  const char *name;  /* as given to --bench */
+  void (*func)(void);
+  const char *about; /* one line for the usage list */
+};
+
+static void bench_events(void);
+static void bench_players(void);
+static void bench_affects(void);
+static void bench_resets(void);
+
+static const struct bench_info bench_list[] = {
+    {"events", bench_events,
+     "event queue: create, cancel and fire up to 1M events"},
+    {"players", bench_players,
+     "player_table lookups by name and id, hashed and linear"},
+    {"affects", bench_affects,
+     "affect_update() over 20k mobs with permanent and timed affects"},
+    {"resets", bench_resets,
+     "reset_zone() over the whole world, and real_*() lookups"},
+    {"\n", NULL, NULL}};
+
+static long long bench_nsec(void);
+static EVENTFUNC(bench_event);
+static long linear_ptable_by_name(const char *name);
+static char *linear_name_by_id(long id);
+static IDXTYPE table_vnum(int mode, IDXTYPE rnum);
+static IDXTYPE bsearch_rnum(int mode, IDXTYPE top, IDXTYPE vnum);
+
+/* Nanoseconds on the monotonic clock, where there is one. */
+static long long bench_nsec(void) {
+#if defined(CLOCK_MONOTONIC) && !defined(CIRCLE_WINDOWS)
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (ts.tv_sec * 1000000000LL + ts.tv_nsec);
+#else
+  struct timeval tv;
+
+  gettimeofday(&tv, (struct timezone *)0);
+  return (tv.tv_sec * 1000000000LL + tv.tv_usec * 1000LL);
+#endif
+}
+
+/* Returns the index of the named benchmark, or -1. */
+int find_bench(const char *name) {
+  int i;
+
+  for (i = 0; *bench_list[i].name != '\n'; i++)
+    if (!strcmp(bench_list[i].name, name))
+      return (i);
+
+  return (-1);
+}
+
+void list_benches(void) {
+  int i;
+
+  for (i = 0; *bench_list[i].name != '\n'; i++)
+    printf("  %-14s %s\n", bench_list[i].name, bench_list[i].about);
+}
+
+void run_bench(int bench) {
+  const struct bench_info *b = &bench_list[bench];
+
+  circle_srandom(1);
+  event_init();
+  init_lookup_table();
+  init_save_queue();
+  boot_db();
+
+  log("Running the %s benchmark.", b->name);
+  b->func();
+  fflush(stdout);
+
+  shutdown_save_queue();
+}
+
+static EVENTFUNC(bench_event) { return (0); }
+
+/* Random delays of up to an hour, like script waits and mud event
+ * cooldowns.  Half the events are cancelled, in creation order and so from
+ * random places in the heap, and the rest are fired. */
+static void bench_events(void) {
+  static const int sizes[] = {1000, 10000, 100000, 1000000};
+  struct event **ev;
+  long long t0, t1, t2, t3;
+  int s, i, n;
+
+  /* Let whatever the zone resets started run first. */
+  pulse += 3600 RL_SEC;
+  event_process();
+
+  printf("%8s %12s %12s %12s\n", "events", "create", "cancel", "fire");
+
+  for (s = 0; s < (int)(sizeof(sizes) / sizeof(sizes[0])); s++) {
+    n = sizes[s];
+    CREATE(ev, struct event *, n);
+
+    t0 = bench_nsec();
+    for (i = 0; i < n; i++)
+      ev[i] = event_create(bench_event, NULL,
+                           rand_number(1, 3600 RL_SEC));
+    t1 = bench_nsec();
+    for (i = 0; i < n; i += 2)
+      event_cancel(ev[i]);
+    t2 = bench_nsec();
+    pulse += 3600 RL_SEC;
+    event_process();
+    t3 = bench_nsec();
+
+    printf("%8d %9lld ns %9lld ns %9lld ns\n", n, (t1 - t0) / n,
+           (t2 - t1) / ((n + 1) / 2), (t3 - t2) / (n / 2));
+    free(ev);
+  }
+}
+
+/* The full scans get_ptable_by_name() and get_name_by_id() used to do. */
+static long linear_ptable_by_name(const char *name) {
+  int i;
+
+  for (i = 0; i <= top_of_p_table; i++)
+    if (!str_cmp(player_table[i].name, name))
+      return (i);
+
+  return (-1);
+}
+
+static char *linear_name_by_id(long id) {
+  int i;
+
+  for (i = 0; i <= top_of_p_table; i++)
+    if (player_table[i].id == id)
+      return (player_table[i].name);
+
+  return (NULL);
+}
+
+/* Looks up random players in made-up player tables of growing size, through
+ * the hash and through a linear scan.  The real table is thrown away first;
+ * nothing is written to disk. */
+static void bench_players(void) {
+  static const int sizes[] = {100, 1000, 10000, 100000};
+  char name[MAX_NAME_LENGTH + 1];
+  long long t0, t1, t2, t3, t4;
+  long found = 0;
+  int s, i, n, hashed = 1000000, linear;
+
+  free_player_index();
+
+  printf("%8s %24s %24s\n", "players", "by name", "by id");
+
+  for (s = 0; s < (int)(sizeof(sizes) / sizeof(sizes[0])); s++) {
+    n = sizes[s];
+    linear = MAX(100, 10000000 / n);
+
+    CREATE(player_table, struct player_index_element, n);
+    top_of_p_table = n - 1;
+    for (i = 0; i < n; i++) {
+      snprintf(name, sizeof(name), "player%d", i);
+      player_table[i].name = strdup(name);
+      player_table[i].id = i + 1;
+    }
+    index_player_entry(0); /* sizes the hash and indexes them all */
+
+    t0 = bench_nsec();
+    for (i = 0; i < hashed; i++)
+      found += get_ptable_by_name(player_table[rand_number(0, n - 1)].name);
+    t1 = bench_nsec();
+    for (i = 0; i < linear; i++)
+      found += linear_ptable_by_name(player_table[rand_number(0, n - 1)].name);
+    t2 = bench_nsec();
+    for (i = 0; i < hashed; i++)
+      found += (get_name_by_id(rand_number(1, n)) != NULL);
+    t3 = bench_nsec();
+    for (i = 0; i < linear; i++)
+      found += (linear_name_by_id(rand_number(1, n)) != NULL);
+    t4 = bench_nsec();
+
+    printf("%8d %7lld ns -> %7lld ns %7lld ns -> %7lld ns\n", n,
+           (t2 - t1) / linear, (t1 - t0) / hashed, (t4 - t3) / linear,
+           (t3 - t2) / hashed);
+    free_player_index();
+  }
+
+  /* Keeps the lookups from being optimized out. */
+  log("Lookup checksum %ld.", found);
+}
+
+/* 20000 mobs, each with three permanent affects and three timed ones of up to
+ * 119 hours, go through 150 affect_update() passes.  Every tenth pass one mob
+ * in 50 is blessed again through affect_join(), as casting would.  The
+ * checksums cover every affect's spell and remaining duration, so runs of
+ * different builds can be checked against each other. */
+static void bench_affects(void) {
+  static const int spells[] = {SPELL_ARMOR,     SPELL_BLESS,
+                               SPELL_STRENGTH,  SPELL_INVISIBLE,
+                               SPELL_SANCTUARY, SPELL_DETECT_MAGIC};
+  const int mobs = 20000, passes = 150, quiet_from = 120;
+  struct affected_type af, *a;
+  struct char_data *ch;
+  unsigned long sum;
+  long long t, total = 0, worst = 0, quiet = 0;
+  long count;
+  int i, k, p;
+
+  for (i = 0; i < mobs; i++) {
+    ch = read_mobile(i % (top_of_mobt + 1), REAL);
+    char_to_room(ch, i % (top_of_world + 1));
+    for (k = 0; k < 6; k++) {
+      new_affect(&af);
+      af.spell = spells[k];
+      af.location = APPLY_AC;
+      af.modifier = -1;
+      af.duration = k < 3 ? -1 : rand_number(0, 119);
+      affect_to_char(ch, &af);
+    }
+  }
+
+  for (p = 0; p < passes; p++) {
+    t = bench_nsec();
+    affect_update();
+    t = bench_nsec() - t;
+    total += t;
+    worst = MAX(worst, t);
+    if (p >= quiet_from)
+      quiet += t;
+
+    if (p % 10 == 0)
+      for (ch = character_list, i = 0; ch; ch = ch->next, i++) {
+        if (i % 50)
+          continue;
+        new_affect(&af);
+        af.spell = SPELL_BLESS;
+        af.location = APPLY_HITROLL;
+        af.modifier = 1;
+        af.duration = 5 + i % 30;
+        affect_join(ch, &af, TRUE, FALSE, FALSE, FALSE);
+      }
+
+    if (p % 30 == 29) {
+      sum = count = 0;
+      for (ch = character_list; ch; ch = ch->next)
+        for (a = ch->affected; a; a = a->next, count++)
+          sum = sum * 31 + affect_duration(a) + 7 * a->spell + GET_AC(ch);
+      printf("after pass %3d: %ld affects, checksum %lu\n", p + 1, count,
+             sum);
+    }
+  }
+
+  printf("%d mobs, %d passes: %lld us average, %lld us worst\n", mobs, passes,
+         total / passes / 1000, worst / 1000);
+  printf("passes %d-%d, first timed affects all gone: %lld us\n",
+         quiet_from + 1, passes, quiet / (passes - quiet_from) / 1000);
+}
+
+/* The vnum in the given slot of the world, mobile, object or zone table. */
+static IDXTYPE table_vnum(int mode, IDXTYPE rnum) {
+  switch (mode) {
+  case DB_BOOT_WLD:
+    return (world[rnum].number);
+  case DB_BOOT_MOB:
+    return (mob_index[rnum].vnum);
+  case DB_BOOT_OBJ:
+    return (obj_index[rnum].vnum);
+  default:
+    return (zone_table[rnum].number);
+  }
+}
+
+/* The binary search real_room() and the others used to do.  It needs the
+ * table in vnum order, as it is straight after boot. */
+static IDXTYPE bsearch_rnum(int mode, IDXTYPE top, IDXTYPE vnum) {
+  int bot = 0, mid, t = top;
+
+  while (bot <= t) {
+    mid = (bot + t) / 2;
+    if (table_vnum(mode, mid) == vnum)
+      return (mid);
+    if (table_vnum(mode, mid) > vnum)
+      t = mid - 1;
+    else
+      bot = mid + 1;
+  }
+  return (NOWHERE);
+}
+
+/* Runs reset_zone() over every zone, as a reboot does, a few times over;
+ * the later passes find most mobiles and objects already loaded, like the
+ * periodic resets.  Then every vnum up to the top of the last zone is looked
+ * up as a room, mobile, object and zone, through real_*() and through the
+ * binary search they replaced.  Both ways must give the same rnums. */
+static void bench_resets(void) {
+  const int resets = 5, lookups = 20;
+  IDXTYPE top = zone_table[top_of_zone_table].top;
+  unsigned long mapped = 0, searched = 0;
+  long long t, t0, t1, t2, total = 0, worst = 0;
+  int i, p, v;
+
+  for (p = 0; p < resets; p++) {
+    t = bench_nsec();
+    for (i = 0; i <= top_of_zone_table; i++)
+      reset_zone(i);
+    t = bench_nsec() - t;
+    total += t;
+    worst = MAX(worst, t);
+  }
+  printf("%d zones, %d rooms: reset_zone() over all of them %lld us average, "
+         "%lld us worst of %d\n",
+         top_of_zone_table + 1, top_of_world + 1, total / resets / 1000,
+         worst / 1000, resets);
+
+  t0 = bench_nsec();
+  for (p = 0; p < lookups; p++)
+    for (v = 0; v <= top; v++)
+      mapped += real_room(v) + real_mobile(v) + real_object(v) +
+                real_zone(v / 100);
+  t1 = bench_nsec();
+  for (p = 0; p < lookups; p++)
+    for (v = 0; v <= top; v++)
+      searched += bsearch_rnum(DB_BOOT_WLD, top_of_world, v) +
+                  bsearch_rnum(DB_BOOT_MOB, top_of_mobt, v) +
+                  bsearch_rnum(DB_BOOT_OBJ, top_of_objt, v) +
+                  bsearch_rnum(DB_BOOT_ZON, top_of_zone_table, v / 100);
+  t2 = bench_nsec();
+
+  printf("%ld lookups: %lld ms -> %lld ms, checksums %s\n",
+         4L * lookups * (top + 1), (t2 - t1) / 1000000, (t1 - t0) / 1000000,
+         mapped == searched ? "match" : "DIFFER");
+}
@@ -0,0 +1,20 @@
+/**
+* @file bench.h
+* Micro-benchmarks run from the command line with --bench.
+*
+* Part of the core tbaMUD source code distribution, which is a derivative
+* of, and continuation of, CircleMUD.
+*
+* All rights reserved.  See license for complete information.
+* Copyright (C) 1993, 94 by the Trustees of the Johns Hopkins University
+* CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.
+*/
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+/* Functions */
+int find_bench(const char *name);
+void list_benches(void);
+void run_bench(int bench);
+
+#endif /* _BENCH_H_ */
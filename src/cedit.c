@@ -133,6 +133,8 @@ static void cedit_setup(struct descriptor_data *d)
   OLC_CONFIG(d)->operation.protocol_negotiation = CONFIG_PROTOCOL_NEGOTIATION;
   OLC_CONFIG(d)->operation.special_in_comm    = CONFIG_SPECIAL_IN_COMM;
   OLC_CONFIG(d)->operation.debug_mode    = CONFIG_DEBUG_MODE;
+  OLC_CONFIG(d)->operation.mccp_level    = CONFIG_MCCP_LEVEL;
+  OLC_CONFIG(d)->operation.hibernate_time = CONFIG_HIBERNATE_TIME;
   
   /* Autowiz */
   OLC_CONFIG(d)->autowiz.use_autowiz          = CONFIG_USE_AUTOWIZ;
@@ -237,6 +239,8 @@ static void cedit_save_internally(struct descriptor_data *d)
   CONFIG_PROTOCOL_NEGOTIATION = OLC_CONFIG(d)->operation.protocol_negotiation;
   CONFIG_SPECIAL_IN_COMM      = OLC_CONFIG(d)->operation.special_in_comm;
   CONFIG_DEBUG_MODE           = OLC_CONFIG(d)->operation.debug_mode;
+  CONFIG_MCCP_LEVEL           = OLC_CONFIG(d)->operation.mccp_level;
+  CONFIG_HIBERNATE_TIME       = OLC_CONFIG(d)->operation.hibernate_time;
     
   /* Autowiz */
   CONFIG_USE_AUTOWIZ          = OLC_CONFIG(d)->autowiz.use_autowiz;
@@ -569,6 +573,14 @@ int save_config( IDXTYPE nowhere )
               "debug_mode = %d\n\n",
               CONFIG_DEBUG_MODE);
 
+  fprintf(fl, "* MCCP compression level, 1 (fastest) to 9 (smallest), or 0 for no MCCP.\n"
+              "mccp_level = %d\n\n",
+              CONFIG_MCCP_LEVEL);
+
+  fprintf(fl, "* Minutes a zone must be empty before its mobs rest, or 0 to never rest.\n"
+              "hibernate_time = %d\n\n",
+              CONFIG_HIBERNATE_TIME);
+
   fclose(fl);
 
   if (in_save_list(NOWHERE, SL_CFG))
@@ -758,6 +770,8 @@ static void cedit_disp_operation_options(struct descriptor_data *d)
   	"%sR%s) Enable Protocol Negotiation : %s%s\r\n"
   	"%sS%s) Enable Special Char in Comm : %s%s\r\n"
   	"%sT%s) Current Debug Mode : %s%s\r\n"
+  	"%sU%s) MCCP Compression Level : %s%d\r\n"
+  	"%sV%s) Zone Hibernation Delay : %s%d minutes\r\n"
     "%sQ%s) Exit To The Main Menu\r\n"
     "Enter your choice : ",
     grn, nrm, cyn, OLC_CONFIG(d)->operation.DFLT_PORT,
@@ -779,6 +793,8 @@ static void cedit_disp_operation_options(struct descriptor_data *d)
     grn, nrm, cyn, OLC_CONFIG(d)->operation.protocol_negotiation ? "Yes" : "No",
     grn, nrm, cyn, OLC_CONFIG(d)->operation.special_in_comm ? "Yes" : "No",
     grn, nrm, cyn, OLC_CONFIG(d)->operation.debug_mode == 0 ? "OFF" : (OLC_CONFIG(d)->operation.debug_mode == 1 ? "BRIEF" : (OLC_CONFIG(d)->operation.debug_mode == 2 ? "NORMAL" : "COMPLETE")),
+    grn, nrm, cyn, OLC_CONFIG(d)->operation.mccp_level,
+    grn, nrm, cyn, OLC_CONFIG(d)->operation.hibernate_time,
     grn, nrm
     );
 
@@ -1273,6 +1289,18 @@ void cedit_parse(struct descriptor_data *d, char *arg)
            OLC_MODE(d) = CEDIT_DEBUG_MODE;
            return;
 
+         case 'u':
+         case 'U':
+           write_to_output(d, "Enter the MCCP compression level (0: Off, 1: Fastest .. 9: Smallest) : ");
+           OLC_MODE(d) = CEDIT_MCCP_LEVEL;
+           return;
+
+         case 'v':
+         case 'V':
+           write_to_output(d, "Enter the minutes a zone must be empty before it hibernates (0: Never) : ");
+           OLC_MODE(d) = CEDIT_HIBERNATE_TIME;
+           return;
+
          case 'q':
          case 'Q':
            cedit_disp_menu(d);
@@ -1663,6 +1691,16 @@ void cedit_parse(struct descriptor_data *d, char *arg)
       cedit_disp_operation_options(d);
       break;
 
+    case CEDIT_MCCP_LEVEL:
+      OLC_CONFIG(d)->operation.mccp_level = LIMIT(atoi(arg), 0, 9);
+      cedit_disp_operation_options(d);
+      break;
+
+    case CEDIT_HIBERNATE_TIME:
+      OLC_CONFIG(d)->operation.hibernate_time = MAX(atoi(arg), 0);
+      cedit_disp_operation_options(d);
+      break;
+
     case CEDIT_MIN_WIZLIST_LEV:
       if (atoi(arg) > LVL_IMPL) {
         write_to_output(d,
@@ -1722,7 +1760,7 @@ static void reassign_rooms(void)
   int i;
 
   /* remove old funcs */
-  for (i = 0; i < top_of_world; i++)
+  for (i = 0; i <= top_of_world; i++)
     world[i].func = NULL;
 
   /* reassign spec_procs */
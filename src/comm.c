@@ -80,8 +80,17 @@
 #include "spells.h" /* for affect_update */
 #include "modify.h"
 #include "quest.h"
+#include "savequeue.h"
 #include "ibt.h" /* for free_ibt_lists */
+#include "bench.h"
+#include "mail.h" /* for compact_mail */
 #include "mud_event.h"
+#include "profiler.h"
+#include "slab.h"
+
+#ifdef USING_MCCP
+#include <zlib.h>
+#endif
 
 #ifndef INVALID_SOCKET
 #define INVALID_SOCKET (-1)
@@ -92,9 +101,12 @@ extern time_t newsmod;
 
 /* locally defined globals, used externally */
 struct descriptor_data *descriptor_list = NULL; /* master desc list */
-int buf_largecount = 0;  /* # of large buffers which exist */
+int buf_largecount = 0;  /* # of output blocks which exist */
 int buf_overflows = 0;   /* # of overflows of output */
-int buf_switches = 0;    /* # of switches from small to large buf */
+int buf_switches = 0;    /* # of times output spilled into another block */
+int mccp_streams = 0;     /* # of descriptors being compressed */
+unsigned long mccp_bytes_in = 0;  /* output bytes handed to MCCP */
+unsigned long mccp_bytes_out = 0; /* compressed bytes MCCP made of them */
 int circle_shutdown = 0; /* clean shutdown */
 int circle_reboot = 0;   /* reboot the game after a shutdown */
 int no_specials = 0;     /* Suppress ass. of special routines */
@@ -108,10 +120,12 @@ int next_tick = SECS_PER_MUD_HOUR; /* Tick countdown */
 long last_webster_teller = -1L;
 
 /* static local global variable declarations (current file scope only) */
-static struct txt_block *bufpool = 0; /* pool of large output buffers */
+static struct out_block *bufpool = 0; /* pool of free output blocks */
 static int max_players = 0;           /* max descriptors available */
 static int tics_passed = 0;           /* for extern checkpointing */
+#ifndef CIRCLE_EPOLL
 static struct timeval null_time;      /* zero-valued time structure */
+#endif
 static byte reread_wizlist;           /* signal: SIGUSR1 */
 /* normally signal SIGUSR2, currently orphaned in favor of Webster dictionary
  * lookup
@@ -121,6 +135,12 @@ static int dg_act_check; /* toggle for act_trigger */
 static bool fCopyOver;   /* Are we booting in copyover mode? */
 static char *last_act_message = NULL;
 static byte webster_file_ready = FALSE; /* signal: SIGUSR2 */
+#ifdef CIRCLE_EPOLL
+static int epoll_desc = -1;                  /* epoll set of all sockets */
+static int pulse_timer = -1;                 /* timerfd firing every pulse */
+static struct epoll_event *poll_events = NULL; /* ready list from epoll */
+static int max_poll_events = 0;              /* size of poll_events */
+#endif
 
 /* static local function prototypes (current file scope only) */
 static RETSIGTYPE reread_wizlists(int sig);
@@ -134,7 +154,12 @@ static ssize_t perform_socket_read(socket_t desc, char *read_point,
                                    size_t space_left);
 static ssize_t perform_socket_write(socket_t desc, const char *txt,
                                     size_t length);
+static ssize_t perform_socket_writev(socket_t desc, struct iovec *iov,
+                                     int iovcnt);
+static int writev_to_descriptor(socket_t desc, struct iovec *iov, int iovcnt);
+#ifndef CIRCLE_EPOLL
 static void circle_sleep(struct timeval *timeout);
+#endif
 static int get_from_q(struct txt_q *queue, char *dest, int *aliased);
 static void init_game(ush_int port);
 static void signal_setup(void);
@@ -143,10 +168,21 @@ static int new_descriptor(socket_t s);
 static int get_max_players(void);
 static int process_output(struct descriptor_data *t);
 static int process_input(struct descriptor_data *t);
+#ifndef CIRCLE_EPOLL
 static void timediff(struct timeval *diff, struct timeval *a,
                      struct timeval *b);
 static void timeadd(struct timeval *sum, struct timeval *a, struct timeval *b);
+#endif
 static void flush_queues(struct descriptor_data *d);
+static void queue_output(struct descriptor_data *t, const char *txt, int len);
+static void consume_output(struct descriptor_data *t, int len);
+static void free_output(struct descriptor_data *t);
+static int mccp_flush(struct descriptor_data *t);
+static void mccp_free(struct descriptor_data *t);
+static int desc_writev(struct descriptor_data *t, struct iovec *iov,
+                       int iovcnt);
+static int desc_write(struct descriptor_data *t, const char *txt);
+static int output_pending(struct descriptor_data *t);
 static void nonblock(socket_t s);
 static int perform_subst(struct descriptor_data *t, char *orig, char *subst);
 static void record_usage(void);
@@ -169,6 +205,15 @@ static void handle_webster_file(void);
 
 static void msdp_update(void); /* KaVir plugin*/
 
+#ifdef CIRCLE_EPOLL
+static void init_poll(socket_t local_mother_desc);
+static void free_poll(void);
+static void poll_ctl(int op, socket_t desc, uint32_t events, void *ptr);
+static void poll_want_output(struct descriptor_data *d, bool want);
+static void reset_pulse_timer(void);
+static int wait_for_pulse(void);
+#endif
+
 /* externally defined functions, used locally */
 #ifdef __CXREF__
 #undef FD_ZERO
@@ -201,7 +246,7 @@ void gettimeofday(struct timeval *t, struct timezone *dummy) {
 #endif /* CIRCLE_WINDOWS || CIRCLE_MACINTOSH */
 
 int main(int argc, char **argv) {
-  int pos = 1;
+  int pos = 1, bench = -1;
   const char *dir;
 
 #ifdef MEMORY_DEBUG
@@ -299,11 +344,27 @@ int main(int argc, char **argv) {
       no_specials = 1;
       puts("Suppressing assignment of special routines.");
       break;
+    case '-':
+      if (!strcmp(argv[pos], "--serial-boot")) {
+        serial_boot = 1;
+        puts("Serial boot mode -- world files parsed on one thread.");
+      } else if (!strcmp(argv[pos], "--bench")) {
+        if (++pos >= argc || (bench = find_bench(argv[pos])) < 0) {
+          puts("SYSERR: Benchmark name expected after option --bench:");
+          list_benches();
+          exit(1);
+        }
+        printf("Benchmark mode -- running %s instead of the game.\n",
+               argv[pos]);
+      } else
+        printf("SYSERR: Unknown option %s in argument string.\n", argv[pos]);
+      break;
     case 'h':
       /* From: Anil Mahajan. Do NOT use -C, this is the copyover mode and
        * without the proper copyover.dat file, the game will go nuts! */
       printf(
-          "Usage: %s [-c] [-m] [-q] [-r] [-s] [-d pathname] [port #]\n"
+          "Usage: %s [-c] [-m] [-q] [-r] [-s] [--serial-boot] [--bench name] "
+          "[-d pathname] [port #]\n"
           "  -c             Enable syntax check mode.\n"
           "  -d <directory> Specify library directory (defaults to 'lib').\n"
           "  -h             Print this command line argument help.\n"
@@ -313,6 +374,8 @@ int main(int argc, char **argv) {
           "  -q             Quick boot (doesn't scan rent for object limits)\n"
           "  -r             Restrict MUD -- no new players allowed.\n"
           "  -s             Suppress special procedure assignments.\n"
+          "  --serial-boot  Parse the world files on one thread.\n"
+          "  --bench <name> Run the named benchmark instead of the game.\n"
           " Note:		These arguments are 'CaSe SeNsItIvE!!!'\n",
           argv[0]);
       exit(0);
@@ -349,7 +412,9 @@ int main(int argc, char **argv) {
   }
   log("Using %s as data directory.", dir);
 
-  if (scheck)
+  if (bench >= 0)
+    run_bench(bench);
+  else if (scheck)
     boot_world();
   else {
     log("Running game on port %d.", port);
@@ -362,6 +427,7 @@ int main(int argc, char **argv) {
   if (!scheck) {
     log("Clearing other memory.");
     free_bufpool();                        /* comm.c */
+    free_mail_index();                     /* mail.c */
     free_player_index();                   /* players.c */
     free_messages();                       /* fight.c */
     free_text_files();                     /* db.c */
@@ -377,6 +443,7 @@ int main(int argc, char **argv) {
     free_recent_players();                 /* act.informative.c */
     free_list(world_events);               /* free up our global lists */
     free_list(global_lists);
+    free_slabs();                          /* slab.c */
   }
 
   if (last_act_message)
@@ -461,7 +528,7 @@ void copyover_recover() {
     CopyoverSet(d, guiopt);
 
     /* Now, find the pfile */
-    CREATE(d->character, struct char_data, 1);
+    d->character = slab_alloc(&char_slab);
     clear_char(d->character);
     CREATE(d->character->player_specials, struct player_special_data, 1);
 
@@ -527,11 +594,18 @@ static void init_game(ush_int local_port) {
     mother_desc = init_socket(local_port);
   }
 
+#ifdef CIRCLE_EPOLL
+  init_poll(mother_desc);
+#endif
+
   event_init();
 
   /* set up hash table for find_char() */
   init_lookup_table();
 
+  log("Starting the save writer.");
+  init_save_queue();
+
   boot_db();
 
 #if defined(CIRCLE_UNIX) || defined(CIRCLE_MACINTOSH)
@@ -556,6 +630,9 @@ static void init_game(ush_int local_port) {
     close_socket(descriptor_list);
 
   CLOSE_SOCKET(mother_desc);
+#ifdef CIRCLE_EPOLL
+  free_poll();
+#endif
 
   if (circle_reboot != 2)
     save_all();
@@ -563,6 +640,15 @@ static void init_game(ush_int local_port) {
   log("Saving current MUD time.");
   save_mud_time(&time_info);
 
+  /* Clear deleted mail out of the mail file. */
+  compact_mail();
+
+  /* Fold the player index journal back into the index. */
+  save_player_index();
+
+  /* Wait for queued player and rent files to reach the disk. */
+  shutdown_save_queue();
+
   if (circle_reboot) {
     log("Rebooting.");
     exit(52); /* what's so great about HHGTTG, anyhow? */
@@ -749,13 +835,21 @@ static int get_max_players(void) {
  * output and sending it out to players, and calling "heartbeat" functions
  * such as mobile_activity(). */
 void game_loop(socket_t local_mother_desc) {
+#ifdef CIRCLE_EPOLL
+  int i, nevents;
+#else
   fd_set input_set, output_set, exc_set, null_set;
   struct timeval last_time, opt_time, process_time, temp_time;
   struct timeval before_sleep, now, timeout;
+  int maxdesc;
+#endif
   char comm[MAX_INPUT_LENGTH];
   struct descriptor_data *d, *next_d;
-  int missed_pulses, maxdesc, aliased;
+  int missed_pulses, aliased;
 
+#ifdef CIRCLE_EPOLL
+  reset_pulse_timer();
+#else
   /* initialize various time values */
   null_time.tv_sec = 0;
   null_time.tv_usec = 0;
@@ -764,10 +858,75 @@ void game_loop(socket_t local_mother_desc) {
   FD_ZERO(&null_set);
 
   gettimeofday(&last_time, (struct timezone *)0);
+#endif
 
   /* The Main Loop.  The Big Cheese.  The Top Dog.  The Head Honcho.  The.. */
   while (!circle_shutdown) {
 
+#ifdef CIRCLE_EPOLL
+    /* Sleep if we don't have any connections.  Only the mother descriptor is
+     * in the epoll set at this point, so any event means a new connection. */
+    if (descriptor_list == NULL) {
+      log("No connections.  Going to sleep.");
+      if (epoll_wait(epoll_desc, poll_events, 1, -1) < 0) {
+        if (errno == EINTR)
+          log("Waking up to process signal.");
+        else
+          perror("SYSERR: epoll coma");
+      } else
+        log("New connection.  Waking up.");
+      reset_pulse_timer();
+    }
+
+    /* At this point, we have completed all input, output and heartbeat
+     * activity from the previous iteration, so we sleep until the pulse timer
+     * fires.  If the previous iteration overran, the timer has already expired
+     * more than once and we count the extra expirations as missed pulses. */
+    missed_pulses = wait_for_pulse() - 1;
+
+    profile_begin(PHASE_PULSE);
+    profile_begin(PHASE_INPUT);
+
+    /* Poll (without blocking) for descriptors that became ready.  Only those
+     * are touched here; idle connections cost nothing. */
+    if ((nevents = epoll_wait(epoll_desc, poll_events, max_poll_events, 0)) <
+        0) {
+      if (errno != EINTR) {
+        perror("SYSERR: epoll poll");
+        return;
+      }
+      nevents = 0;
+    }
+
+    for (i = 0; i < nevents; i++) {
+      uint32_t revents = poll_events[i].events;
+
+      /* If there are new connections waiting, accept them. */
+      if ((d = poll_events[i].data.ptr) == NULL) {
+        new_descriptor(local_mother_desc);
+        continue;
+      }
+
+      /* Kick out the freaky folks with errors or out-of-band data. */
+      if (revents & (EPOLLERR | EPOLLPRI)) {
+        close_socket(d);
+        continue;
+      }
+
+      /* The kernel drained the socket buffer; output may be sent again. */
+      if (revents & EPOLLOUT)
+        poll_want_output(d, FALSE);
+
+      /* Process descriptors with input pending (or a hung up peer, which
+       * process_input will notice as EOF). */
+      if (revents & (EPOLLIN | EPOLLHUP)) {
+        if (d->pProtocol != NULL)     /* KaVir's plugin */
+          d->pProtocol->WriteOOB = 0; /* KaVir's plugin */
+        if (process_input(d) < 0)
+          close_socket(d);
+      }
+    }
+#else
     /* Sleep if we don't have any connections */
     if (descriptor_list == NULL) {
       log("No connections.  Going to sleep.");
@@ -834,6 +993,9 @@ void game_loop(socket_t local_mother_desc) {
       timediff(&timeout, &last_time, &now);
     } while (timeout.tv_usec || timeout.tv_sec);
 
+    profile_begin(PHASE_PULSE);
+    profile_begin(PHASE_INPUT);
+
     /* Poll (without blocking) for new input, output, and exceptions */
     if (select(maxdesc + 1, &input_set, &output_set, &exc_set, &null_time) <
         0) {
@@ -865,7 +1027,11 @@ void game_loop(socket_t local_mother_desc) {
       }
     }
 
+#endif
+    profile_end(PHASE_INPUT);
+
     /* Process commands we just read from process_input */
+    profile_begin(PHASE_COMMANDS);
     for (d = descriptor_list; d; d = next_d) {
       next_d = d->next;
 
@@ -914,25 +1080,43 @@ void game_loop(socket_t local_mother_desc) {
       }
     }
 
+    profile_end(PHASE_COMMANDS);
+
     /* Send queued output out to the operating system (ultimately to user). */
+    profile_begin(PHASE_OUTPUT);
     for (d = descriptor_list; d; d = next_d) {
       next_d = d->next;
-      if (*(d->output) && FD_ISSET(d->descriptor, &output_set)) {
+#ifdef CIRCLE_EPOLL
+      if (output_pending(d) && !d->output_blocked) {
+        /* Output for this player is ready */
+        if (process_output(d) < 0)
+          close_socket(d);
+        else {
+          d->has_prompt = 1;
+          /* Socket buffer full: wait for EPOLLOUT before trying again. */
+          if (output_pending(d))
+            poll_want_output(d, TRUE);
+        }
+      }
+#else
+      if (output_pending(d) && FD_ISSET(d->descriptor, &output_set)) {
         /* Output for this player is ready */
         if (process_output(d) < 0)
           close_socket(d);
         else
           d->has_prompt = 1;
       }
+#endif
     }
 
     /* Print prompts for other descriptors who had no other output */
     for (d = descriptor_list; d; d = d->next) {
       if (!d->has_prompt) {
-        write_to_descriptor(d->descriptor, make_prompt(d));
+        desc_write(d, make_prompt(d));
         d->has_prompt = TRUE;
       }
     }
+    profile_end(PHASE_OUTPUT);
 
     /* Kick out folks in the CON_CLOSE or CON_DISCONNECT state */
     for (d = descriptor_list; d; d = next_d) {
@@ -964,6 +1148,9 @@ void game_loop(socket_t local_mother_desc) {
     while (missed_pulses--)
       heartbeat(++pulse);
 
+    profile_end(PHASE_PULSE);
+    profile_pulse_done();
+
     /* Check for any signals we may have received. */
     if (reread_wizlist) {
       reread_wizlist = FALSE;
@@ -993,55 +1180,82 @@ void game_loop(socket_t local_mother_desc) {
 void heartbeat(int heart_pulse) {
   static int mins_since_crashsave = 0;
 
+  profile_begin(PHASE_HEARTBEAT);
+
+  profile_begin(PHASE_EVENTS);
   event_process();
+  profile_end(PHASE_EVENTS);
 
-  if (!(heart_pulse % PULSE_DG_SCRIPT))
+  if (!(heart_pulse % PULSE_DG_SCRIPT)) {
+    profile_begin(PHASE_SCRIPTS);
     script_trigger_check();
+    profile_end(PHASE_SCRIPTS);
+  }
 
   if (!(heart_pulse % PASSES_PER_SEC)) { /* EVERY second */
     msdp_update();
     next_tick--;
   }
 
-  if (!(heart_pulse % PULSE_ZONE))
+  if (!(heart_pulse % PULSE_ZONE)) {
+    profile_begin(PHASE_ZONES);
     zone_update();
+    profile_end(PHASE_ZONES);
+  }
 
   if (!(heart_pulse % PULSE_IDLEPWD)) /* 15 seconds */
     check_idle_passwords();
 
-  if (!(heart_pulse % PULSE_MOBILE))
+  if (!(heart_pulse % PULSE_MOBILE)) {
+    profile_begin(PHASE_MOBILES);
     mobile_activity();
+    profile_end(PHASE_MOBILES);
+  }
 
-  if (!(heart_pulse % PULSE_VIOLENCE))
+  if (!(heart_pulse % PULSE_VIOLENCE)) {
+    profile_begin(PHASE_VIOLENCE);
     perform_violence();
+    profile_end(PHASE_VIOLENCE);
+  }
 
   if (!(heart_pulse % (SECS_PER_MUD_HOUR * PASSES_PER_SEC))) { /* Tick ! */
     next_tick = SECS_PER_MUD_HOUR; /* Reset tick coundown */
     weather_and_time(1);
     check_time_triggers();
+    profile_begin(PHASE_AFFECTS);
     affect_update();
+    profile_end(PHASE_AFFECTS);
+    profile_begin(PHASE_POINTS);
     point_update();
+    profile_end(PHASE_POINTS);
     check_timed_quests();
   }
 
   if (CONFIG_AUTO_SAVE && !(heart_pulse % PULSE_AUTOSAVE)) { /* 1 minute */
     if (++mins_since_crashsave >= CONFIG_AUTOSAVE_TIME) {
       mins_since_crashsave = 0;
+      profile_begin(PHASE_AUTOSAVE);
       Crash_save_all();
       House_save_all();
+      profile_end(PHASE_AUTOSAVE);
     }
   }
 
-  if (!(heart_pulse % PULSE_USAGE))
+  if (!(heart_pulse % PULSE_USAGE)) {
     record_usage();
+    save_queue_check();
+  }
 
   if (!(heart_pulse % PULSE_TIMESAVE))
     save_mud_time(&time_info);
 
   /* Every pulse! Don't want them to stink the place up... */
   extract_pending_chars();
+
+  profile_end(PHASE_HEARTBEAT);
 }
 
+#ifndef CIRCLE_EPOLL
 /* new code to calculate time differences, which works on systems for which
  * tv_usec is unsigned (and thus comparisons for something being < 0 fail).
  * Based on code submitted by ss@sirocco.cup.hp.com. Code to return the time
@@ -1079,6 +1293,7 @@ static void timeadd(struct timeval *rslt, struct timeval *a,
     rslt->tv_sec++;
   }
 }
+#endif /* !CIRCLE_EPOLL */
 
 static void record_usage(void) {
   int sockets_connected = 0, sockets_playing = 0;
@@ -1263,12 +1478,8 @@ static int get_from_q(struct txt_q *queue, char *dest, int *aliased) {
   return (1);
 }
 
-/* Empty the queues before closing connection */
+/* Empty the command queue, on '--' and before closing connection */
 static void flush_queues(struct descriptor_data *d) {
-  if (d->large_outbuf) {
-    d->large_outbuf->next = bufpool;
-    bufpool = d->large_outbuf;
-  }
   while (d->input.head) {
     struct txt_block *tmp = d->input.head;
     d->input.head = d->input.head->next;
@@ -1292,86 +1503,340 @@ size_t write_to_output(struct descriptor_data *t, const char *txt, ...) {
 /* Add a new string to a player's output queue. */
 size_t vwrite_to_output(struct descriptor_data *t, const char *format,
                         va_list args) {
-  const char *text_overflow = "\r\nOVERFLOW\r\n";
   static char txt[MAX_STRING_LENGTH];
-  size_t wantsize;
+  const char *out;
   int size;
 
   /* if we're in the overflow state already, ignore this new output */
   if (t->bufspace == 0)
     return (0);
 
-  wantsize = size = vsnprintf(txt, sizeof(txt), format, args);
+  if ((size = vsnprintf(txt, sizeof(txt), format, args)) < 0)
+    return (t->bufspace);
 
-  strcpy(txt,
-         ProtocolOutput(t, txt, (int *)&wantsize)); /* <--- Add this line */
-  size = wantsize;                                  /* <--- Add this line */
-  if (t->pProtocol->WriteOOB > 0)                   /* <--- Add this line */
-    --t->pProtocol->WriteOOB;                       /* <--- Add this line */
+  /* The translated text is queued straight from ProtocolOutput()'s buffer. */
+  out = ProtocolOutput(t, txt, &size);
+  if (t->pProtocol->WriteOOB > 0)
+    --t->pProtocol->WriteOOB;
 
-  /* If exceeding the size of the buffer, truncate it for the overflow message
-   */
-  if (size < 0 || wantsize >= sizeof(txt)) {
-    size = sizeof(txt) - 1;
-    strcpy(txt + size - strlen(text_overflow), text_overflow); /* strcpy: OK */
-  }
-
-  /* If the text is too big to fit into even a large buffer, truncate
-   * the new text to make it fit.  (This will switch to the overflow
-   * state automatically because t->bufspace will end up 0.) */
+  /* If the text is too big to fit into the output queue, truncate the new
+   * text to make it fit.  (This will switch to the overflow state
+   * automatically because t->bufspace will end up 0.) */
   if (size + t->bufptr + 1 > LARGE_BUFSIZE) {
     size = LARGE_BUFSIZE - t->bufptr - 1;
-    txt[size] = '\0';
     buf_overflows++;
   }
 
-  /* If we have enough space, just write to buffer and that's it! If the
-   * text just barely fits, then it's switched to a large buffer instead. */
-  if (t->bufspace > size) {
-    strcpy(t->output + t->bufptr, txt); /* strcpy: OK (size checked above) */
-    t->bufspace -= size;
-    t->bufptr += size;
-    return (t->bufspace);
-  }
+  queue_output(t, out, size);
+
+  return (t->bufspace);
+}
 
-  buf_switches++;
+/* Append len bytes of txt to the output chain, taking blocks from the pool as
+ * the tail block fills up. */
+static void queue_output(struct descriptor_data *t, const char *txt, int len) {
+  struct out_block *b;
+  int n;
 
-  /* if the pool has a buffer in it, grab it */
-  if (bufpool != NULL) {
-    t->large_outbuf = bufpool;
-    bufpool = bufpool->next;
-  } else { /* else create a new one */
-    CREATE(t->large_outbuf, struct txt_block, 1);
-    CREATE(t->large_outbuf->text, char, LARGE_BUFSIZE);
-    buf_largecount++;
-  }
+  t->bufptr += len;
+  t->bufspace = LARGE_BUFSIZE - 1 - t->bufptr;
 
-  strcpy(t->large_outbuf->text,
-         t->output);                 /* strcpy: OK (size checked previously) */
-  t->output = t->large_outbuf->text; /* make big buffer primary */
-  strcat(t->output, txt);            /* strcat: OK (size checked) */
+  while (len > 0) {
+    if (!(b = t->output_tail) || b->end == OUT_BLOCK_SIZE) {
+      /* if the pool has a block in it, grab it */
+      if (bufpool != NULL) {
+        b = bufpool;
+        bufpool = bufpool->next;
+      } else {
+        CREATE(b, struct out_block, 1);
+        buf_largecount++;
+      }
+      b->next = NULL;
+      b->start = b->end = 0;
 
-  /* set the pointer for the next write */
-  t->bufptr = strlen(t->output);
+      if (t->output_tail) {
+        t->output_tail->next = b;
+        buf_switches++;
+      } else
+        t->output = b;
+      t->output_tail = b;
+    }
 
-  /* calculate how much space is left in the buffer */
+    n = MIN(len, OUT_BLOCK_SIZE - b->end);
+    memcpy(b->text + b->end, txt, n);
+    b->end += n;
+    txt += n;
+    len -= n;
+  }
+}
+
+/* Drop the first len bytes of the output chain, returning emptied blocks to
+ * the pool. */
+static void consume_output(struct descriptor_data *t, int len) {
+  struct out_block *b;
+  int n;
+
+  t->bufptr -= len;
   t->bufspace = LARGE_BUFSIZE - 1 - t->bufptr;
 
-  return (t->bufspace);
+  while (len > 0 && (b = t->output) != NULL) {
+    n = MIN(len, b->end - b->start);
+    b->start += n;
+    len -= n;
+
+    if (b->start == b->end) {
+      if (!(t->output = b->next))
+        t->output_tail = NULL;
+      b->next = bufpool;
+      bufpool = b;
+    }
+  }
+}
+
+static void free_output(struct descriptor_data *t) {
+  consume_output(t, t->bufptr);
 }
 
 static void free_bufpool(void) {
-  struct txt_block *tmp;
+  struct out_block *tmp;
 
   while (bufpool) {
     tmp = bufpool->next;
-    if (bufpool->text)
-      free(bufpool->text);
     free(bufpool);
     bufpool = tmp;
   }
 }
 
+#ifdef USING_MCCP
+/* Telnet option 86 is MCCP version 2: once the server has sent IAC SB MCCP2
+ * IAC SE, everything it sends is a single zlib stream until the stream ends.
+ * Each descriptor gets its own deflate stream; the compressed bytes wait in
+ * pending until the socket takes them. */
+struct mccp_data {
+  z_stream stream;
+  bool active;   /* FALSE once the stream has ended and pending is draining */
+  char *pending; /* compressed output not yet written */
+  size_t start, end, size;
+};
+
+/* Make sure at least len bytes fit after the end of the pending buffer. */
+static void mccp_reserve(struct mccp_data *m, size_t len) {
+  if (m->start > 0 && m->start == m->end)
+    m->start = m->end = 0;
+  if (m->end + len <= m->size)
+    return;
+  if (m->start > 0) {
+    memmove(m->pending, m->pending + m->start, m->end - m->start);
+    m->end -= m->start;
+    m->start = 0;
+  }
+  while (m->end + len > m->size)
+    m->size = m->size ? m->size * 2 : OUT_BLOCK_SIZE;
+  RECREATE(m->pending, char, m->size);
+}
+
+/* Run len bytes of txt through the stream with the given flush mode,
+ * appending what deflate produces to the pending buffer. */
+static int mccp_deflate(struct mccp_data *m, const char *txt, size_t len,
+                        int flush) {
+  size_t before;
+  int err;
+
+  m->stream.next_in = (Bytef *)txt;
+  m->stream.avail_in = len;
+  mccp_bytes_in += len;
+
+  do {
+    mccp_reserve(m, OUT_BLOCK_SIZE);
+    m->stream.next_out = (Bytef *)(m->pending + m->end);
+    m->stream.avail_out = m->size - m->end;
+    before = m->stream.avail_out;
+    err = deflate(&m->stream, flush);
+    m->end += before - m->stream.avail_out;
+    mccp_bytes_out += before - m->stream.avail_out;
+    if (err == Z_STREAM_ERROR)
+      return (-1);
+    /* Done once the input is consumed and deflate had output space left. */
+  } while (m->stream.avail_out == 0 ||
+           (flush == Z_FINISH && err != Z_STREAM_END));
+
+  return (0);
+}
+
+/* Start compressing everything sent to the descriptor from now on. Called by
+ * the protocol code when the client agrees to MCCP2. */
+void mccp_start(struct descriptor_data *t) {
+  static const char start_mccp[] = {(char)IAC, (char)SB, (char)TELOPT_MCCP,
+                                    (char)IAC, (char)SE};
+  struct mccp_data *m;
+
+  if (CONFIG_MCCP_LEVEL <= 0 || (t->mccp && t->mccp->active))
+    return;
+
+  if (!(m = t->mccp))
+    CREATE(m, struct mccp_data, 1);
+
+  m->stream.zalloc = Z_NULL;
+  m->stream.zfree = Z_NULL;
+  m->stream.opaque = Z_NULL;
+  if (deflateInit(&m->stream, MIN(CONFIG_MCCP_LEVEL, Z_BEST_COMPRESSION)) !=
+      Z_OK) {
+    log("SYSERR: deflateInit failed, not compressing output for %s.",
+        t->host);
+    if (!t->mccp)
+      free(m);
+    return;
+  }
+
+  /* The start marker itself goes out uncompressed, ahead of anything queued. */
+  mccp_reserve(m, sizeof(start_mccp));
+  memcpy(m->pending + m->end, start_mccp, sizeof(start_mccp));
+  m->end += sizeof(start_mccp);
+  m->active = TRUE;
+  t->mccp = m;
+  mccp_streams++;
+}
+
+/* End the compressed stream, going back to plain output once the end of the
+ * stream has reached the client. */
+void mccp_end(struct descriptor_data *t) {
+  struct mccp_data *m = t->mccp;
+
+  if (!m || !m->active)
+    return;
+
+  mccp_deflate(m, "", 0, Z_FINISH);
+  deflateEnd(&m->stream);
+  m->active = FALSE;
+  mccp_streams--;
+
+  mccp_flush(t);
+}
+
+/* End the compressed stream and wait, up to MCCP_DRAIN_TIMEOUT seconds, for
+ * the rest of it to reach the client, so text written straight to the socket
+ * afterwards is read as plain text. Returns FALSE if it could not all be
+ * sent, in which case nothing raw should follow. */
+int mccp_drain(struct descriptor_data *t) {
+  struct timeval wait;
+  int pending, tries = MCCP_DRAIN_TIMEOUT * 100;
+
+  mccp_end(t);
+
+  while (t->mccp && (pending = mccp_flush(t)) != 0) {
+    if (pending < 0 || tries-- <= 0)
+      return (FALSE);
+    wait.tv_sec = 0;
+    wait.tv_usec = 10000;
+    select(0, (fd_set *)0, (fd_set *)0, (fd_set *)0, &wait);
+  }
+
+  return (TRUE);
+}
+
+/* Write as much pending compressed output as the socket will take. Returns
+ * the number of bytes still pending, or -1 on a fatal error. */
+static int mccp_flush(struct descriptor_data *t) {
+  struct mccp_data *m = t->mccp;
+  ssize_t result;
+
+  while (m->start < m->end) {
+    result = perform_socket_write(t->descriptor, m->pending + m->start,
+                                  m->end - m->start);
+    if (result < 0) {
+      perror("SYSERR: Write to socket");
+      return (-1);
+    } else if (result == 0)
+      break;
+    m->start += result;
+  }
+
+  if (m->start < m->end)
+    return (m->end - m->start);
+
+  /* A finished stream with nothing left to send is no longer needed. */
+  if (!m->active)
+    mccp_free(t);
+  return (0);
+}
+
+/* Compress an array of iovecs, ending with a sync flush so that the client
+ * can show everything now, and start sending the result. All the text is
+ * taken, so the whole length is returned unless the socket failed. */
+static int mccp_writev(struct descriptor_data *t, struct iovec *iov,
+                       int iovcnt) {
+  struct mccp_data *m = t->mccp;
+  int i, total = 0;
+
+  for (i = 0; i < iovcnt; i++) {
+    if (mccp_deflate(m, iov[i].iov_base, iov[i].iov_len,
+                     i == iovcnt - 1 ? Z_SYNC_FLUSH : Z_NO_FLUSH) < 0) {
+      log("SYSERR: deflate failed for %s.", t->host);
+      return (-1);
+    }
+    total += iov[i].iov_len;
+  }
+
+  if (mccp_flush(t) < 0)
+    return (-1);
+  return (total);
+}
+
+static void mccp_free(struct descriptor_data *t) {
+  struct mccp_data *m = t->mccp;
+
+  if (!m)
+    return;
+  if (m->active) {
+    deflateEnd(&m->stream);
+    mccp_streams--;
+  }
+  if (m->pending)
+    free(m->pending);
+  free(m);
+  t->mccp = NULL;
+}
+#else
+void mccp_start(struct descriptor_data *t) {}
+void mccp_end(struct descriptor_data *t) {}
+int mccp_drain(struct descriptor_data *t) { return (TRUE); }
+static int mccp_flush(struct descriptor_data *t) { return (0); }
+static void mccp_free(struct descriptor_data *t) {}
+#endif /* USING_MCCP */
+
+/* Send an array of iovecs to the descriptor, through its compressor if it
+ * has one. Returns like writev_to_descriptor. */
+static int desc_writev(struct descriptor_data *t, struct iovec *iov,
+                       int iovcnt) {
+#ifdef USING_MCCP
+  int pending;
+
+  if (t->mccp && t->mccp->active)
+    return (mccp_writev(t, iov, iovcnt));
+  /* The end of a compressed stream must reach the client before plain text. */
+  if (t->mccp && (pending = mccp_flush(t)) != 0)
+    return (pending < 0 ? -1 : 0);
+#endif
+  return (writev_to_descriptor(t->descriptor, iov, iovcnt));
+}
+
+static int desc_write(struct descriptor_data *t, const char *txt) {
+  struct iovec iov;
+
+  iov.iov_base = (char *)txt;
+  iov.iov_len = strlen(txt);
+  return (desc_writev(t, &iov, 1));
+}
+
+/* Does the descriptor have output waiting to go out? */
+static int output_pending(struct descriptor_data *t) {
+#ifdef USING_MCCP
+  if (t->mccp && t->mccp->start < t->mccp->end)
+    return (TRUE);
+#endif
+  return (t->output != NULL);
+}
+
 /*  socket handling */
 /* get_bind_addr: Return a struct in_addr that should be used in our
  * call to bind().  If the user has specified a desired binding
@@ -1449,16 +1914,99 @@ static int set_sendbuf(socket_t s) {
   return (0);
 }
 
+#ifdef CIRCLE_EPOLL
+/* Create the epoll set and the pulse timer, and start watching the mother
+ * descriptor.  Both are close-on-exec so copyover starts with fresh ones. */
+static void init_poll(socket_t local_mother_desc) {
+  if ((epoll_desc = epoll_create1(EPOLL_CLOEXEC)) < 0) {
+    perror("SYSERR: epoll_create1");
+    exit(1);
+  }
+
+  if ((pulse_timer = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC)) < 0) {
+    perror("SYSERR: timerfd_create");
+    exit(1);
+  }
+
+  /* Room for every player plus the mother descriptor, so one poll per pulse
+   * always sees everything that is ready. */
+  max_poll_events = max_players + 1;
+  CREATE(poll_events, struct epoll_event, max_poll_events);
+
+  poll_ctl(EPOLL_CTL_ADD, local_mother_desc, EPOLLIN, NULL);
+}
+
+static void free_poll(void) {
+  close(pulse_timer);
+  close(epoll_desc);
+  pulse_timer = epoll_desc = -1;
+  free(poll_events);
+  poll_events = NULL;
+}
+
+/* Add, modify or remove a socket in the epoll set.  'ptr' is the descriptor
+ * handed back by epoll_wait(), or NULL for the mother descriptor. */
+static void poll_ctl(int op, socket_t desc, uint32_t events, void *ptr) {
+  struct epoll_event ev;
+
+  memset(&ev, 0, sizeof(ev));
+  ev.events = events;
+  ev.data.ptr = ptr;
+
+  if (epoll_ctl(epoll_desc, op, desc, &ev) < 0)
+    perror("SYSERR: epoll_ctl");
+}
+
+/* Only ask for EPOLLOUT while a descriptor has output the kernel refused to
+ * take; otherwise every idle socket would be reported writable each pulse. */
+static void poll_want_output(struct descriptor_data *d, bool want) {
+  if (d->output_blocked == want)
+    return;
+
+  d->output_blocked = want;
+  poll_ctl(EPOLL_CTL_MOD, d->descriptor,
+           EPOLLIN | EPOLLPRI | (want ? EPOLLOUT : 0), d);
+}
+
+/* (Re)start the pulse timer so the next pulse is OPT_USEC from now. */
+static void reset_pulse_timer(void) {
+  struct itimerspec its;
+
+  its.it_interval.tv_sec = OPT_USEC / 1000000;
+  its.it_interval.tv_nsec = (OPT_USEC % 1000000) * 1000;
+  its.it_value = its.it_interval;
+
+  if (timerfd_settime(pulse_timer, 0, &its, NULL) < 0) {
+    perror("SYSERR: timerfd_settime");
+    exit(1);
+  }
+}
+
+/* Block until the pulse timer fires.  Returns the number of pulses that have
+ * elapsed since the last call, which is more than one if we ran late. */
+static int wait_for_pulse(void) {
+  uint64_t expirations;
+
+  while (read(pulse_timer, &expirations, sizeof(expirations)) < 0) {
+    if (errno != EINTR) {
+      perror("SYSERR: Pulse timer read");
+      exit(1);
+    }
+  }
+
+  return (expirations > INT_MAX ? INT_MAX : (int)expirations);
+}
+#endif /* CIRCLE_EPOLL */
+
 /* Initialize a descriptor */
 static void init_descriptor(struct descriptor_data *newd, int desc) {
   static int last_desc = 0; /* last descriptor number */
 
   newd->descriptor = desc;
   newd->idle_tics = 0;
-  newd->output = newd->small_outbuf;
-  newd->bufspace = SMALL_BUFSIZE - 1;
+  newd->output = newd->output_tail = NULL;
+  newd->bufspace = LARGE_BUFSIZE - 1;
   newd->login_time = time(0);
-  *newd->output = '\0';
   newd->bufptr = 0;
   newd->has_prompt = 1; /* prompt is part of greetings */
   STATE(newd) = CONFIG_PROTOCOL_NEGOTIATION ? CON_GET_PROTOCOL : CON_GET_NAME;
@@ -1468,6 +2016,12 @@ static void init_descriptor(struct descriptor_data *newd, int desc) {
   newd->desc_num = last_desc;
   newd->pProtocol = ProtocolCreate(); /* KaVir's plugin*/
   newd->events = create_list();
+
+#ifdef CIRCLE_EPOLL
+  /* Watch for input; EPOLLOUT is only armed while output is backed up. */
+  newd->output_blocked = FALSE;
+  poll_ctl(EPOLL_CTL_ADD, desc, EPOLLIN | EPOLLPRI, newd);
+#endif
 }
 
 static int new_descriptor(socket_t s) {
@@ -1557,89 +2111,89 @@ static int new_descriptor(socket_t s) {
 }
 
 /* Send all of the output that we've accumulated for a player out to the
- * player's descriptor. 32 byte GARBAGE_SPACE in MAX_SOCK_BUF used for:
- *	 2 bytes: prepended \r\n
- *	14 bytes: overflow message
- *	 2 bytes: extra \r\n for non-comapct
- *      14 bytes: unused */
+ * player's descriptor. The output chain goes out with one writev(), framed by
+ * a prepended \r\n when the player was sitting at a prompt and by a trailer
+ * holding the overflow notice, the extra \r\n for non-compact mode and the
+ * prompt. */
 static int process_output(struct descriptor_data *t) {
-  char i[MAX_SOCK_BUF], *osb = i + 2;
-  int result;
+  static char snoop_buf[LARGE_BUFSIZE];
+  struct iovec iov[LARGE_BUFSIZE / OUT_BLOCK_SIZE + 4]; /* CRLF, chain, trailer */
+  char trailer[GARBAGE_SPACE + MAX_PROMPT_LENGTH];
+  struct out_block *b;
+  int iovcnt = 0, prefix = 0, result, sent, n;
+  size_t trailer_len = 0;
+
+  /* Compressed output left over from the last pass has to go first. */
+  if (t->mccp && (result = mccp_flush(t)) != 0)
+    return (result < 0 ? -1 : 0);
+  if (!t->output)
+    return (0);
 
-  /* we may need this \r\n for later -- see below */
-  strcpy(i, "\r\n"); /* strcpy: OK (for 'MAX_SOCK_BUF >= 3') */
+  /* If this is an 'interruption', prepend a CRLF. */
+  if (t->has_prompt && !t->pProtocol->WriteOOB) {
+    t->has_prompt = FALSE;
+    iov[iovcnt].iov_base = (char *)"\r\n";
+    iov[iovcnt++].iov_len = prefix = 2;
+  }
 
-  /* now, append the 'real' output */
-  strcpy(osb, t->output); /* strcpy: OK (t->output:LARGE_BUFSIZE <
-                             osb:MAX_SOCK_BUF-2) */
+  /* now, the 'real' output */
+  for (b = t->output; b && iovcnt < (int)(sizeof(iov) / sizeof(iov[0])) - 1;
+       b = b->next) {
+    iov[iovcnt].iov_base = b->text + b->start;
+    iov[iovcnt++].iov_len = b->end - b->start;
+  }
 
   /* if we're in the overflow state, notify the user */
   if (t->bufspace == 0)
-    strcat(osb, "**OVERFLOW**\r\n"); /* strcpy: OK (osb:MAX_SOCK_BUF-2 reserves
-                                        space) */
+    trailer_len += snprintf(trailer + trailer_len, sizeof(trailer) - trailer_len,
+                            "**OVERFLOW**\r\n");
 
   /* add the extra CRLF if the person isn't in compact mode */
   if (STATE(t) == CON_PLAYING && t->character && !IS_NPC(t->character) &&
       !PRF_FLAGGED(t->character, PRF_COMPACT))
     if (!t->pProtocol->WriteOOB)
-      strcat(osb, "\r\n"); /* strcpy: OK (osb:MAX_SOCK_BUF-2 reserves space) */
+      trailer_len += snprintf(trailer + trailer_len,
+                              sizeof(trailer) - trailer_len, "\r\n");
 
   if (!t->pProtocol->WriteOOB) /* add a prompt */
-    strcat(i, make_prompt(t)); /* strcpy: OK (i:MAX_SOCK_BUF reserves space) */
+    trailer_len += snprintf(trailer + trailer_len,
+                            sizeof(trailer) - trailer_len, "%s", make_prompt(t));
 
-  /* now, send the output.  If this is an 'interruption', use the prepended
-   * CRLF, otherwise send the straight output sans CRLF. */
-  if (t->has_prompt && !t->pProtocol->WriteOOB) {
-    t->has_prompt = FALSE;
-    result = write_to_descriptor(t->descriptor, i);
-    if (result >= 2)
-      result -= 2;
-  } else
-    result = write_to_descriptor(t->descriptor, osb);
+  trailer_len = MIN(trailer_len, sizeof(trailer) - 1);
+  /* The chain holds at most LARGE_BUFSIZE bytes, so it always fits in iov[];
+   * should it ever not, the trailer waits until the rest has been sent. */
+  if (b)
+    trailer_len = 0;
+  iov[iovcnt].iov_base = trailer;
+  iov[iovcnt++].iov_len = trailer_len;
+
+  result = desc_writev(t, iov, iovcnt);
 
-  if (result < 0) { /* Oops, fatal error. Bye! */
-    close_socket(t);
+  if (result < 0) { /* Oops, fatal error. Bye!  The caller closes the socket. */
     return (-1);
   } else if (result == 0) /* Socket buffer full. Try later. */
     return (0);
 
+  result = MAX(result - prefix, 0);
+  sent = MIN(result, t->bufptr);
+
   /* Handle snooping: prepend "% " and send to snooper. */
-  if (t->snoop_by)
-    write_to_output(t->snoop_by, "%% %*s%%%%", result, t->output);
-
-  /* The common case: all saved output was handed off to the kernel buffer. */
-  if (result >= t->bufptr) {
-    /* If we were using a large buffer, put the large buffer on the buffer pool
-     * and switch back to the small one. */
-    if (t->large_outbuf) {
-      t->large_outbuf->next = bufpool;
-      bufpool = t->large_outbuf;
-      t->large_outbuf = NULL;
-      t->output = t->small_outbuf;
-    }
-    /* reset total bufspace back to that of a small buffer */
-    t->bufspace = SMALL_BUFSIZE - 1;
-    t->bufptr = 0;
-    *(t->output) = '\0';
-
-    /* If the overflow message or prompt were partially written, try to save
-     * them. There will be enough space for them if this is true.  'result'
-     * is effectively unsigned here anyway. */
-    if ((unsigned int)result < strlen(osb)) {
-      size_t savetextlen = strlen(osb + result);
-
-      strcat(t->output, osb + result);
-      t->bufptr -= savetextlen;
-      t->bufspace += savetextlen;
+  if (t->snoop_by && sent > 0) {
+    for (b = t->output, n = 0; b && n < sent; b = b->next) {
+      memcpy(snoop_buf + n, b->text + b->start, MIN(sent - n, b->end - b->start));
+      n += MIN(sent - n, b->end - b->start);
     }
-
-  } else {
-    /* Not all data in buffer sent.  result < output buffersize. */
-    strcpy(t->output, t->output + result); /* strcpy: OK (overlap) */
-    t->bufptr -= result;
-    t->bufspace += result;
+    write_to_output(t->snoop_by, "%% %.*s%%%%", sent, snoop_buf);
   }
 
+  /* Partial writes just move the start of the chain along. */
+  consume_output(t, sent);
+
+  /* If the output went out but the overflow message or prompt were only
+   * partially written, save the rest of them for the next pass. */
+  if (result > sent && (size_t)(result - sent) < trailer_len)
+    queue_output(t, trailer + (result - sent), trailer_len - (result - sent));
+
   return (result);
 }
 
@@ -1728,6 +2282,102 @@ static ssize_t perform_socket_write(socket_t desc, const char *txt,
 }
 #endif /* CIRCLE_WINDOWS */
 
+/* perform_socket_writev: like perform_socket_write, but gathers its text from
+ * an array of iovecs. The same return values apply. */
+#if defined(HAVE_SYS_UIO_H) && !defined(CIRCLE_WINDOWS)
+static ssize_t perform_socket_writev(socket_t desc, struct iovec *iov,
+                                     int iovcnt) {
+  ssize_t result;
+
+  result = writev(desc, iov, iovcnt);
+
+  if (result > 0) {
+    /* Write was successful. */
+    return (result);
+  }
+
+  if (result == 0) {
+    /* This should never happen! */
+    log("SYSERR: Huh??  writev() returned 0???  Please report this!");
+    return (-1);
+  }
+
+  /* result < 0, so an error was encountered - is it transient? */
+#ifdef EAGAIN /* POSIX */
+  if (errno == EAGAIN)
+    return (0);
+#endif
+
+#ifdef EWOULDBLOCK /* BSD */
+  if (errno == EWOULDBLOCK)
+    return (0);
+#endif
+
+#ifdef EDEADLK /* Macintosh */
+  if (errno == EDEADLK)
+    return (0);
+#endif
+
+  /* Looks like the error was fatal.  Too bad. */
+  return (-1);
+}
+#else
+/* No writev(): hand the pieces to perform_socket_write one at a time. */
+static ssize_t perform_socket_writev(socket_t desc, struct iovec *iov,
+                                     int iovcnt) {
+  ssize_t result, total = 0;
+  int i;
+
+  for (i = 0; i < iovcnt; i++) {
+    if (!iov[i].iov_len)
+      continue;
+    if ((result = perform_socket_write(desc, iov[i].iov_base,
+                                       iov[i].iov_len)) < 0)
+      return (total ? total : -1);
+    total += result;
+    if ((size_t)result < iov[i].iov_len)
+      break;
+  }
+
+  return (total);
+}
+#endif
+
+/* writev_to_descriptor is write_to_descriptor for an array of iovecs, which it
+ * trims in place as they are written. */
+static int writev_to_descriptor(socket_t desc, struct iovec *iov, int iovcnt) {
+  ssize_t bytes_written;
+  size_t write_total = 0;
+
+  while (iovcnt > 0) {
+    bytes_written = perform_socket_writev(desc, iov, iovcnt);
+
+    if (bytes_written < 0) {
+      /* Fatal error.  Disconnect the player. */
+      perror("SYSERR: Write to socket");
+      return (-1);
+    } else if (bytes_written == 0) {
+      /* Temporary failure -- socket buffer full. */
+      return (write_total);
+    }
+
+    write_total += bytes_written;
+
+    /* Skip the pieces written in full, then trim a partly written one. */
+    while (iovcnt > 0 && (size_t)bytes_written >= iov->iov_len) {
+      bytes_written -= iov->iov_len;
+      iov++;
+      iovcnt--;
+    }
+    if (iovcnt > 0) {
+      iov->iov_base = (char *)iov->iov_base + bytes_written;
+      iov->iov_len -= bytes_written;
+    }
+  }
+
+  return (write_total);
+}
+
 /* write_to_descriptor takes a descriptor, and text to write to the descriptor.
  * It keeps calling the system-level write() until all the text has been
  * delivered to the OS, or until an error is encountered. Returns:
@@ -1928,7 +2578,7 @@ static int process_input(struct descriptor_data *t) {
 
       snprintf(buffer, sizeof(buffer),
                "Line too long.  Truncated to:\r\n%s\r\n", tmp);
-      if (write_to_descriptor(t->descriptor, buffer) < 0)
+      if (desc_write(t, buffer) < 0)
         return (-1);
     }
     if (t->snoop_by)
@@ -2054,8 +2704,13 @@ void close_socket(struct descriptor_data *d) {
   struct descriptor_data *temp;
 
   REMOVE_FROM_LIST(d, descriptor_list, next);
+#ifdef CIRCLE_EPOLL
+  poll_ctl(EPOLL_CTL_DEL, d->descriptor, 0, NULL);
+#endif
   CLOSE_SOCKET(d->descriptor);
   flush_queues(d);
+  free_output(d);
+  mccp_free(d);
 
   /* Forget snooping */
   if (d->snooping)
@@ -2459,7 +3114,7 @@ void send_to_range(room_vnum start, room_vnum finish, const char *messg, ...) {
   if (messg == NULL)
     return;
 
-  for (j = 0; j < top_of_world; j++) {
+  for (j = 0; j <= top_of_world; j++) {
     if (GET_ROOM_VNUM(j) >= start && GET_ROOM_VNUM(j) <= finish) {
       for (i = world[j].people; i; i = i->next_in_room) {
         if (!i->desc)
@@ -2754,7 +3409,7 @@ void circle_sleep(struct timeval *timeout) {
   Sleep(timeout->tv_sec * 1000 + timeout->tv_usec / 1000);
 }
 
-#else
+#elif !defined(CIRCLE_EPOLL)
 static void circle_sleep(struct timeval *timeout) {
   if (select(0, (fd_set *)0, (fd_set *)0, (fd_set *)0, timeout) < 0) {
     if (errno != EINTR) {
@@ -51,6 +51,9 @@ void	write_to_q(const char *txt, struct txt_q *queue, int aliased);
 int	write_to_descriptor(socket_t desc, const char *txt);
 size_t	write_to_output(struct descriptor_data *d, const char *txt, ...) __attribute__ ((format (printf, 2, 3)));
 size_t	vwrite_to_output(struct descriptor_data *d, const char *format, va_list args);
+void	mccp_start(struct descriptor_data *d);
+void	mccp_end(struct descriptor_data *d);
+int	mccp_drain(struct descriptor_data *d);
 
 typedef RETSIGTYPE sigfunc(int);
 
@@ -67,6 +70,9 @@ extern struct descriptor_data *descriptor_list;
 extern int buf_largecount;
 extern int buf_overflows;
 extern int buf_switches;
+extern int mccp_streams;
+extern unsigned long mccp_bytes_in;
+extern unsigned long mccp_bytes_out;
 extern int circle_shutdown;
 extern int circle_reboot;
 extern int no_specials;
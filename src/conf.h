@@ -127,6 +127,9 @@
 /* Define if you have the <netinet/in.h> header file.  */
 #define HAVE_NETINET_IN_H 1
 
+/* Define if you have the <pthread.h> header file.  */
+#define HAVE_PTHREAD_H 1
+
 /* Define if you have the <signal.h> header file.  */
 #define HAVE_SIGNAL_H 1
 
@@ -136,9 +139,15 @@
 /* Define if you have the <strings.h> header file.  */
 #define HAVE_STRINGS_H 1
 
+/* Define if you have the <sys/epoll.h> header file.  */
+#define HAVE_SYS_EPOLL_H 1
+
 /* Define if you have the <sys/fcntl.h> header file.  */
 #define HAVE_SYS_FCNTL_H 1
 
+/* Define if you have the <sys/mman.h> header file.  */
+#define HAVE_SYS_MMAN_H 1
+
 /* Define if you have the <sys/resource.h> header file.  */
 #define HAVE_SYS_RESOURCE_H 1
 
@@ -154,6 +163,9 @@
 /* Define if you have the <sys/time.h> header file.  */
 #define HAVE_SYS_TIME_H 1
 
+/* Define if you have the <sys/timerfd.h> header file.  */
+#define HAVE_SYS_TIMERFD_H 1
+
 /* Define if you have the <sys/types.h> header file.  */
 #define HAVE_SYS_TYPES_H 1
 
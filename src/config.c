@@ -316,3 +316,10 @@ int special_in_comm = YES;
 
 /* Current Debug Mode */
 int debug_mode = OFF;
+
+/* zlib level (1-9) for clients that accept MCCP compression; 0 turns MCCP off */
+int mccp_level = 6;
+
+/* Minutes a zone must be empty of players before its mobs stop wandering,
+ * scavenging and regenerating until a player comes back; 0 turns this off */
+int hibernate_time = 5;
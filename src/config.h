@@ -71,6 +71,8 @@ extern int display_closed_doors;
 extern int protocol_negotiation;
 extern int special_in_comm;
 extern int debug_mode;
+extern int mccp_level;
+extern int hibernate_time;
 /* Automap and map options */
 extern int map_option;
 extern int default_map_size;
@@ -41,6 +41,10 @@
 #include <sys/stat.h>
 #include "clan.h"
 #include "boards.h"
+#include "snapshot.h"
+#include "strpool.h"
+#include "graph.h"
+#include "slab.h"
 
 /*  declarations of most of the 'global' variables */
 struct config_data config_info; /* Game configuration list.	 */
@@ -58,6 +62,41 @@ struct index_data *obj_index;        /* index table for object file	 */
 struct obj_data *obj_proto;          /* prototypes for objs		 */
 obj_rnum top_of_objt = 0;            /* top of object index table	 */
 
+/* OLC adds rooms, mobiles and objects at the end of their tables, or in a
+ * slot it freed by deleting one, so no rnum ever changes and nothing that
+ * refers to them has to be renumbered.  The tables are then only in vnum
+ * order up to the first addition; these lists of their rnums are kept in
+ * vnum order instead, for real_room() and friends and for anything that
+ * shows a range of vnums in order. */
+room_rnum *world_vnum_order = NULL;
+mob_rnum *mob_vnum_order = NULL;
+obj_rnum *obj_vnum_order = NULL;
+
+/* Entries in use at the start of each vnum order.  The rest of the order, up
+ * to the top of the table, holds the free slots, whose vnum is NOWHERE,
+ * NOBODY or NOTHING; the one freed last comes first. */
+int world_vnum_count = 0;
+int mob_vnum_count = 0;
+int obj_vnum_count = 0;
+
+/* Entries allocated in each table and its vnum order.  The tables double
+ * when OLC fills them, so additions are cheap. */
+int world_slots = 0;
+int mob_slots = 0;
+int obj_slots = 0;
+
+/* Straight from a vnum to its rnum, or NOWHERE, NOBODY or NOTHING where
+ * there is none, so real_room() and friends are a single array read.  Each
+ * runs up to the highest vnum in its table. */
+static room_rnum *world_vnum_map = NULL;
+static mob_rnum *mob_vnum_map = NULL;
+static obj_rnum *obj_vnum_map = NULL;
+static zone_rnum *zone_vnum_map = NULL;
+static int world_map_len = 0;
+static int mob_map_len = 0;
+static int obj_map_len = 0;
+static int zone_map_len = 0;
+
 struct zone_data *zone_table;    /* zone table      */
 zone_rnum top_of_zone_table = 0; /* top element of zone tab   */
 
@@ -86,6 +125,7 @@ int top_shop = -1;            /* top of shop table             */
 int no_mail = 0;               /* mail disabled?		 */
 int mini_mud = 0;              /* mini-mud mode?		 */
 int no_rent_check = 0;         /* skip rent check on boot?	 */
+int serial_boot = 0;           /* parse world files on one thread? */
 time_t boot_time = 0;          /* time of mud boot		 */
 int circle_restrict = 0;       /* level of game restriction	 */
 room_rnum r_mortal_start_room; /* rnum of mortal start room	 */
@@ -135,6 +175,9 @@ static int check_object_spell_number(struct obj_data *obj, int val);
 static int check_object_level(struct obj_data *obj, int val);
 static int check_object(struct obj_data *);
 static void load_zones(FILE *fl, char *zonename);
+static zone_rnum room_zone(room_vnum virtual_nr);
+static void boot_fatal(void);
+static int starts_with_article(const char *name);
 static int file_to_string(const char *name, char *buf);
 static int file_to_string_alloc(const char *name, char **buf);
 static int count_alias_records(FILE *fl);
@@ -453,33 +496,40 @@ ACMD(do_reboot) {
 }
 
 void boot_world(void) {
-  log("Loading zone table.");
-  index_boot(DB_BOOT_ZON);
+  if (load_world_snapshot()) {
+    log("Checking start rooms.");
+    check_start_rooms();
+  } else {
+    log("Loading zone table.");
+    index_boot(DB_BOOT_ZON);
 
-  log("Loading triggers and generating index.");
-  index_boot(DB_BOOT_TRG);
+    log("Loading triggers and generating index.");
+    index_boot(DB_BOOT_TRG);
 
-  log("Loading rooms.");
-  index_boot(DB_BOOT_WLD);
+    log("Loading rooms.");
+    index_boot(DB_BOOT_WLD);
 
-  log("Renumbering rooms.");
-  renum_world();
+    log("Renumbering rooms.");
+    renum_world();
 
-  log("Checking start rooms.");
-  check_start_rooms();
+    log("Checking start rooms.");
+    check_start_rooms();
 
-  log("Loading mobs and generating index.");
-  index_boot(DB_BOOT_MOB);
+    log("Loading mobs and generating index.");
+    index_boot(DB_BOOT_MOB);
 
-  log("Loading objs and generating index.");
-  index_boot(DB_BOOT_OBJ);
+    log("Loading objs and generating index.");
+    index_boot(DB_BOOT_OBJ);
 
-  log("Renumbering zone table.");
-  renum_zone_table();
+    log("Renumbering zone table.");
+    renum_zone_table();
 
-  if (converting) {
-    log("Saving 128bit world files to disk.");
-    save_all();
+    /* Converted files are rewritten, so the next boot snapshots them. */
+    if (converting) {
+      log("Saving 128bit world files to disk.");
+      save_all();
+    } else
+      save_world_snapshot();
   }
 
   if (!no_specials) {
@@ -497,8 +547,8 @@ static void free_extra_descriptions(struct extra_descr_data *edesc) {
   for (; edesc; edesc = enext) {
     enext = edesc->next;
 
-    free(edesc->keyword);
-    free(edesc->description);
+    str_release(edesc->keyword);
+    str_release(edesc->description);
     free(edesc);
   }
 }
@@ -527,10 +577,8 @@ void destroy_db(void) {
 
   /* Rooms */
   for (cnt = 0; cnt <= top_of_world; cnt++) {
-    if (world[cnt].name)
-      free(world[cnt].name);
-    if (world[cnt].description)
-      free(world[cnt].description);
+    str_release(world[cnt].name);
+    str_release(world[cnt].description);
     free_extra_descriptions(world[cnt].ex_description);
 
     if (world[cnt].events != NULL) {
@@ -555,26 +603,17 @@ void destroy_db(void) {
       if (!world[cnt].dir_option[itr])
         continue;
 
-      if (world[cnt].dir_option[itr]->general_description)
-        free(world[cnt].dir_option[itr]->general_description);
-      if (world[cnt].dir_option[itr]->keyword)
-        free(world[cnt].dir_option[itr]->keyword);
+      str_release(world[cnt].dir_option[itr]->general_description);
+      str_release(world[cnt].dir_option[itr]->keyword);
       free(world[cnt].dir_option[itr]);
     }
   }
-  free(world);
-  top_of_world = 0;
-
   /* Objects */
   for (cnt = 0; cnt <= top_of_objt; cnt++) {
-    if (obj_proto[cnt].name)
-      free(obj_proto[cnt].name);
-    if (obj_proto[cnt].description)
-      free(obj_proto[cnt].description);
-    if (obj_proto[cnt].short_description)
-      free(obj_proto[cnt].short_description);
-    if (obj_proto[cnt].action_description)
-      free(obj_proto[cnt].action_description);
+    str_release(obj_proto[cnt].name);
+    str_release(obj_proto[cnt].description);
+    str_release(obj_proto[cnt].short_description);
+    str_release(obj_proto[cnt].action_description);
     free_extra_descriptions(obj_proto[cnt].ex_description);
 
     /* free script proto list */
@@ -582,19 +621,19 @@ void destroy_db(void) {
   }
   free(obj_proto);
   free(obj_index);
+  free(obj_vnum_order);
+  obj_vnum_order = NULL;
+  free(obj_vnum_map);
+  obj_vnum_map = NULL;
+  obj_slots = obj_map_len = obj_vnum_count = 0;
 
   /* Mobiles */
   for (cnt = 0; cnt <= top_of_mobt; cnt++) {
-    if (mob_proto[cnt].player.name)
-      free(mob_proto[cnt].player.name);
-    if (mob_proto[cnt].player.title)
-      free(mob_proto[cnt].player.title);
-    if (mob_proto[cnt].player.short_descr)
-      free(mob_proto[cnt].player.short_descr);
-    if (mob_proto[cnt].player.long_descr)
-      free(mob_proto[cnt].player.long_descr);
-    if (mob_proto[cnt].player.description)
-      free(mob_proto[cnt].player.description);
+    str_release(mob_proto[cnt].player.name);
+    str_release(mob_proto[cnt].player.title);
+    str_release(mob_proto[cnt].player.short_descr);
+    str_release(mob_proto[cnt].player.long_descr);
+    str_release(mob_proto[cnt].player.description);
 
     /* free script proto list */
     free_proto_script(&mob_proto[cnt], MOB_TRIGGER);
@@ -604,6 +643,21 @@ void destroy_db(void) {
   }
   free(mob_proto);
   free(mob_index);
+  free(mob_vnum_order);
+  mob_vnum_order = NULL;
+  free(mob_vnum_map);
+  mob_vnum_map = NULL;
+  mob_slots = mob_map_len = mob_vnum_count = 0;
+
+  /* The rooms themselves go only now: free_proto_script() checks every
+   * prototype list it frees against world[]. */
+  free(world);
+  free(world_vnum_order);
+  world_vnum_order = NULL;
+  free(world_vnum_map);
+  world_vnum_map = NULL;
+  top_of_world = 0;
+  world_slots = world_map_len = world_vnum_count = 0;
 
   /* Shops */
   destroy_shops();
@@ -633,6 +687,9 @@ void destroy_db(void) {
     }
   }
   free(zone_table);
+  free(zone_vnum_map);
+  zone_vnum_map = NULL;
+  zone_map_len = 0;
 
 #undef THIS_CMD
 
@@ -671,6 +728,9 @@ void destroy_db(void) {
   /* Events */
   event_free_all();
 
+  /* Script UID table, emptied by free_char() and free_obj() above */
+  free_lookup_table();
+
   free_clans();
 }
 
@@ -712,7 +772,10 @@ void boot_db(void) {
   boot_world();
 
   log("Loading help entries.");
-  index_boot(DB_BOOT_HLP);
+  if (!load_help_snapshot()) {
+    index_boot(DB_BOOT_HLP);
+    save_help_snapshot();
+  }
 
   log("Generating player index.");
   build_player_index();
@@ -797,7 +860,7 @@ void boot_db(void) {
   {
     int j;
 
-    for (j = 0; j < top_of_objt; j++) {
+    for (j = 0; j <= top_of_objt; j++) {
       if (obj_proto[j].script == (struct script_data *)&shop_keeper) {
         log("Item %d (%s) had shopkeeper trouble.", obj_index[j].vnum,
             obj_proto[j].short_description);
@@ -945,11 +1008,301 @@ int count_hash_records(FILE *fl) {
   return (count);
 }
 
+/* One file named in a world index file. In a parallel boot every file's
+ * records go to their own run of slots, sized by the first pass, so that the
+ * files can be parsed in any order and packed together afterwards. */
+struct boot_file {
+  char *path;
+  int count;     /* records counted by the first pass */
+  int base;      /* first slot of the file's run */
+  int done;      /* records parsed into the run */
+  int started;   /* records begun, counting one that failed */
+  int failed;    /* parsing stopped at a fatal error */
+  char **msgs;   /* log lines held back until the file's turn */
+  int *msg_rec;  /* ... and how many records had begun when each was logged */
+  int num_msgs;
+  int *saves;    /* zone vnum and type of each add_to_save_list() held back */
+  int num_saves;
+};
+
+#ifdef CIRCLE_PARALLEL_BOOT
+#define BOOT_LOCAL __thread
+#else
+#define BOOT_LOCAL
+#endif
+
+/* Slot the record being parsed goes to. */
+static BOOT_LOCAL int boot_slot = 0;
+
+#ifdef CIRCLE_PARALLEL_BOOT
+static __thread struct boot_file *boot_worker = NULL; /* file this thread parses */
+static __thread jmp_buf boot_abort;
+static pthread_mutex_t boot_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct boot_file *boot_files = NULL;
+static int boot_num_files = 0, boot_next_file = 0, boot_mode = 0;
+#endif
+
+/* Stop at a format error in a world file. A worker thread gives up on the
+ * file instead: the message is already held with it, and index_boot() logs
+ * it and exits when the file's turn comes. */
+static void boot_fatal(void) {
+#ifdef CIRCLE_PARALLEL_BOOT
+  if (boot_worker)
+    longjmp(boot_abort, 1);
+#endif
+  exit(1);
+}
+
+/* Called by basic_mud_vlog(). Holds a worker thread's log line back with its
+ * file so that the log reads the same as a serial boot. */
+int boot_log_capture(const char *format, va_list args) {
+#ifdef CIRCLE_PARALLEL_BOOT
+  struct boot_file *f = boot_worker;
+  char buf[MAX_STRING_LENGTH];
+
+  if (!f)
+    return (FALSE);
+
+  vsnprintf(buf, sizeof(buf), format, args);
+  RECREATE(f->msgs, char *, f->num_msgs + 1);
+  RECREATE(f->msg_rec, int, f->num_msgs + 1);
+  f->msgs[f->num_msgs] = strdup(buf);
+  f->msg_rec[f->num_msgs++] = f->started;
+  return (TRUE);
+#else
+  return (FALSE);
+#endif
+}
+
+/* Counts a record begun, so held back log lines can be placed by record. */
+static void boot_record_begun(void) {
+#ifdef CIRCLE_PARALLEL_BOOT
+  if (boot_worker)
+    boot_worker->started++;
+#endif
+}
+
+static int in_boot_worker(void) {
+#ifdef CIRCLE_PARALLEL_BOOT
+  return (boot_worker != NULL);
+#else
+  return (FALSE);
+#endif
+}
+
+/* A record has been converted to 128 bit flags, so its zone should be saved.
+ * A worker thread keeps the zone with its file, to be added in file order. */
+static void convert_zone_later(zone_vnum zone, int type) {
+#ifdef CIRCLE_PARALLEL_BOOT
+  struct boot_file *f = boot_worker;
+
+  if (f) {
+    RECREATE(f->saves, int, 2 * (f->num_saves + 1));
+    f->saves[2 * f->num_saves] = zone;
+    f->saves[2 * f->num_saves++ + 1] = type;
+    return;
+  }
+#endif
+  add_to_save_list(zone, type);
+  converting = TRUE;
+}
+
+/* Find the zone of a room. Rooms come in vnum order, so the search carries on
+ * from the zone of the last room. */
+static zone_rnum room_zone(room_vnum virtual_nr) {
+  static zone_rnum zone = 0;
+
+  if (virtual_nr < zone_table[zone].bot) {
+    log("SYSERR: Room #%d is below zone %d (bot=%d, top=%d).", virtual_nr,
+        zone_table[zone].number, zone_table[zone].bot, zone_table[zone].top);
+    exit(1);
+  }
+  while (virtual_nr > zone_table[zone].top)
+    if (++zone > top_of_zone_table) {
+      log("SYSERR: Room %d is outside of any zone.", virtual_nr);
+      exit(1);
+    }
+  return (zone);
+}
+
+/* Parse one file into the slots from boot_slot on. */
+static void load_boot_file(struct boot_file *f, int mode, int rec_count) {
+  FILE *db_file;
+
+  if (!(db_file = fopen(f->path, "r"))) {
+    log("SYSERR: %s: %s", f->path, strerror(errno));
+    boot_fatal();
+  }
+  switch (mode) {
+  case DB_BOOT_WLD:
+  case DB_BOOT_OBJ:
+  case DB_BOOT_MOB:
+  case DB_BOOT_TRG:
+  case DB_BOOT_QST:
+    discrete_load(db_file, mode, f->path);
+    break;
+  case DB_BOOT_ZON:
+    load_zones(db_file, f->path);
+    boot_slot++;
+    break;
+  case DB_BOOT_HLP:
+    load_help(db_file, f->path);
+    break;
+  case DB_BOOT_SHP:
+    boot_the_shops(db_file, f->path, rec_count);
+    break;
+  }
+  fclose(db_file);
+}
+
+#ifdef CIRCLE_PARALLEL_BOOT
+static void *boot_worker_thread(void *unused) {
+  struct boot_file *f;
+  int k;
+
+  for (;;) {
+    pthread_mutex_lock(&boot_lock);
+    k = boot_next_file++;
+    pthread_mutex_unlock(&boot_lock);
+    if (k >= boot_num_files)
+      break;
+
+    f = boot_worker = &boot_files[k];
+    boot_slot = f->base;
+    if (!setjmp(boot_abort))
+      load_boot_file(f, boot_mode, 0);
+    else
+      f->failed = TRUE;
+    f->done = boot_slot - f->base;
+    boot_worker = NULL;
+  }
+  return (NULL);
+}
+
+/* How many threads to parse this kind of file on, or 0 to parse serially.
+ * Help, shops and quests are small and keep their own counters. */
+static int boot_thread_count(int mode, int num_files) {
+  long n;
+
+  if (serial_boot)
+    return (0);
+  if (mode != DB_BOOT_WLD && mode != DB_BOOT_MOB && mode != DB_BOOT_OBJ &&
+      mode != DB_BOOT_ZON && mode != DB_BOOT_TRG)
+    return (0);
+
+  n = sysconf(_SC_NPROCESSORS_ONLN);
+  if (n > BOOT_THREADS_MAX)
+    n = BOOT_THREADS_MAX;
+  if (n > num_files)
+    n = num_files;
+  return (n > 1 ? (int)n : 0);
+}
+
+/* Close the gap a file left in its run of slots, and fix the rnums that the
+ * moved records hold of themselves. */
+static void move_boot_records(int mode, int to, int from, int count) {
+  int i;
+
+  if (to == from || count == 0)
+    return;
+
+  switch (mode) {
+  case DB_BOOT_WLD:
+    memmove(world + to, world + from, sizeof(struct room_data) * count);
+    break;
+  case DB_BOOT_MOB:
+    memmove(mob_proto + to, mob_proto + from, sizeof(struct char_data) * count);
+    memmove(mob_index + to, mob_index + from, sizeof(struct index_data) * count);
+    for (i = to; i < to + count; i++)
+      mob_proto[i].nr = i;
+    break;
+  case DB_BOOT_OBJ:
+    memmove(obj_proto + to, obj_proto + from, sizeof(struct obj_data) * count);
+    memmove(obj_index + to, obj_index + from, sizeof(struct index_data) * count);
+    for (i = to; i < to + count; i++)
+      obj_proto[i].item_number = i;
+    break;
+  case DB_BOOT_TRG:
+    memmove(trig_index + to, trig_index + from,
+            sizeof(struct index_data *) * count);
+    for (i = to; i < to + count; i++)
+      trig_index[i]->proto->nr = i;
+    break;
+  case DB_BOOT_ZON:
+    memmove(zone_table + to, zone_table + from,
+            sizeof(struct zone_data) * count);
+    break;
+  }
+}
+
+/* Parse the files on a pool of threads, then go through them in index order:
+ * log what each held back, check the rooms' zones as parse_room() would, and
+ * pack the records together. Leaves boot_slot past the last record. */
+static void parallel_boot(struct boot_file *files, int num_files, int mode,
+                          int threads) {
+  pthread_t *tids;
+  struct boot_file *f;
+  int i, j, m, base = 0, started = 0;
+
+  for (i = 0; i < num_files; i++) {
+    files[i].base = base;
+    base += files[i].count;
+  }
+
+  boot_files = files;
+  boot_num_files = num_files;
+  boot_next_file = 0;
+  boot_mode = mode;
+
+  /* This thread parses too; a thread that cannot be started is one less. */
+  CREATE(tids, pthread_t, threads - 1);
+  for (i = 0; i < threads - 1; i++)
+    if (pthread_create(&tids[started], NULL, boot_worker_thread, NULL) == 0)
+      started++;
+  boot_worker_thread(NULL);
+  for (i = 0; i < started; i++)
+    pthread_join(tids[i], NULL);
+  free(tids);
+
+  boot_slot = 0;
+  for (i = 0; i < num_files; i++) {
+    f = &files[i];
+    for (j = 0, m = 0; j < f->started; j++) {
+      for (; m < f->num_msgs && f->msg_rec[m] <= j; m++)
+        log("%s", f->msgs[m]);
+      if (mode == DB_BOOT_WLD)
+        world[f->base + j].zone = room_zone(world[f->base + j].number);
+    }
+    for (; m < f->num_msgs; m++)
+      log("%s", f->msgs[m]);
+    if (f->failed)
+      exit(1);
+
+    for (j = 0; j < f->num_saves; j++)
+      convert_zone_later(f->saves[2 * j], f->saves[2 * j + 1]);
+
+    move_boot_records(mode, boot_slot, f->base, f->done);
+    boot_slot += f->done;
+
+    for (m = 0; m < f->num_msgs; m++)
+      free(f->msgs[m]);
+    if (f->msgs)
+      free(f->msgs);
+    if (f->msg_rec)
+      free(f->msg_rec);
+    if (f->saves)
+      free(f->saves);
+  }
+  boot_files = NULL;
+}
+#endif
+
 void index_boot(int mode) {
   const char *index_filename, *prefix = NULL; /* NULL or egcs 1.1 complains */
   FILE *db_index, *db_file;
-  int line_number, rec_count = 0, size[2];
+  int line_number, rec_count = 0, size[2], count, num_files = 0, i;
   char buf2[PATH_MAX], buf1[PATH_MAX - 100]; // - 100 to make room for prefix
+  struct boot_file *files = NULL;
 
   switch (mode) {
   case DB_BOOT_WLD:
@@ -1015,24 +1368,38 @@ void index_boot(int mode) {
       break;
 
     snprintf(buf2, sizeof(buf2), "%s%s", prefix, buf1);
+    count = 0;
     if (!(db_file = fopen(buf2, "r"))) {
       log("SYSERR: File '%s' listed in '%s/%s': %s", buf2, prefix,
           index_filename, strerror(errno));
     } else {
       if (mode == DB_BOOT_ZON)
-        rec_count++;
+        count = 1;
       else if (mode == DB_BOOT_HLP)
-        rec_count += count_alias_records(db_file);
+        count = count_alias_records(db_file);
       else
-        rec_count += count_hash_records(db_file);
+        count = count_hash_records(db_file);
+      rec_count += count;
       fclose(db_file);
     }
+
+    /* A file that would not open stays listed, to fail in the second pass. */
+    RECREATE(files, struct boot_file, num_files + 1);
+    memset(&files[num_files], 0, sizeof(struct boot_file));
+    files[num_files].path = strdup(buf2);
+    files[num_files++].count = count;
   }
+  fclose(db_index);
 
   /* Exit if 0 records, unless this is shops */
   if (!rec_count) {
-    if (mode == DB_BOOT_SHP || mode == DB_BOOT_QST)
+    if (mode == DB_BOOT_SHP || mode == DB_BOOT_QST) {
+      for (i = 0; i < num_files; i++)
+        free(files[i].path);
+      if (files)
+        free(files);
       return;
+    }
     log("SYSERR: boot error - 0 records counted in %s/%s.", prefix,
         index_filename);
     exit(1);
@@ -1081,54 +1448,44 @@ void index_boot(int mode) {
     break;
   }
 
-  rewind(db_index);
-
-  for (line_number = 1;; ++line_number) {
-    if (fscanf(db_index, "%s\n", buf1) != 1) {
-      if (feof(db_index))
-        log("SYSERR: boot error -- unexpected end of file encountered in index "
-            "file ./%s%s",
-            prefix, index_filename);
-      else if (ferror(db_index))
-        log("SYSERR: boot error -- unexpected end of file encountered in index "
-            "file ./%s%s: %s",
-            prefix, index_filename, strerror(errno));
-      else
-        log("SYSERR: boot error -- error parsing index file ./%s%s on line %d",
-            prefix, index_filename, line_number);
-      exit(1);
-    }
-
-    if (*buf1 == '$')
-      break;
+  boot_slot = 0;
+#ifdef CIRCLE_PARALLEL_BOOT
+  if ((i = boot_thread_count(mode, num_files)) > 0)
+    parallel_boot(files, num_files, mode, i);
+  else
+#endif
+    for (i = 0; i < num_files; i++)
+      load_boot_file(&files[i], mode, rec_count);
 
-    snprintf(buf2, sizeof(buf2), "%s%s", prefix, buf1);
-    if (!(db_file = fopen(buf2, "r"))) {
-      log("SYSERR: %s: %s", buf2, strerror(errno));
-      exit(1);
-    }
-    switch (mode) {
-    case DB_BOOT_WLD:
-    case DB_BOOT_OBJ:
-    case DB_BOOT_MOB:
-    case DB_BOOT_TRG:
-    case DB_BOOT_QST:
-      discrete_load(db_file, mode, buf2);
-      break;
-    case DB_BOOT_ZON:
-      load_zones(db_file, buf2);
-      break;
-    case DB_BOOT_HLP:
-      load_help(db_file, buf2);
-      break;
-    case DB_BOOT_SHP:
-      boot_the_shops(db_file, buf2, rec_count);
-      break;
-    }
+  for (i = 0; i < num_files; i++)
+    free(files[i].path);
+  free(files);
 
-    fclose(db_file);
+  switch (mode) {
+  case DB_BOOT_TRG:
+    top_of_trigt = boot_slot;
+    break;
+  case DB_BOOT_WLD:
+    top_of_world = boot_slot - 1;
+    /* Rooms are given their scripts in order once they have stopped moving. */
+    for (i = 0; i <= top_of_world; i++)
+      if (world[i].proto_script)
+        assign_triggers(&world[i], WLD_TRIGGER);
+    sort_vnum_order(DB_BOOT_WLD);
+    break;
+  case DB_BOOT_MOB:
+    top_of_mobt = boot_slot - 1;
+    sort_vnum_order(DB_BOOT_MOB);
+    break;
+  case DB_BOOT_OBJ:
+    top_of_objt = boot_slot - 1;
+    sort_vnum_order(DB_BOOT_OBJ);
+    break;
+  case DB_BOOT_ZON:
+    top_of_zone_table = boot_slot - 1;
+    map_zone_vnums();
+    break;
   }
-  fclose(db_index);
 
   /* Sort the help index. */
   if (mode == DB_BOOT_HLP) {
@@ -1157,7 +1514,7 @@ void discrete_load(FILE *fl, int mode, char *filename) {
               "(maybe the file is not terminated with '$'?)",
               filename, modes[mode], nr, modes[mode]);
         }
-        exit(1);
+        boot_fatal();
       }
     if (*line == '$')
       return;
@@ -1166,33 +1523,35 @@ void discrete_load(FILE *fl, int mode, char *filename) {
       last = nr;
       if (sscanf(line, "#%d", &nr) != 1) {
         log("SYSERR: Format error after %s #%d", modes[mode], last);
-        exit(1);
+        boot_fatal();
       }
       if (nr >= 99999)
         return;
-      else
-        switch (mode) {
-        case DB_BOOT_WLD:
-          parse_room(fl, nr);
-          break;
-        case DB_BOOT_MOB:
-          parse_mobile(fl, nr);
-          break;
-        case DB_BOOT_TRG:
-          parse_trigger(fl, nr);
-          break;
-        case DB_BOOT_OBJ:
-          strlcpy(line, parse_object(fl, nr), sizeof(line));
-          break;
-        case DB_BOOT_QST:
-          parse_quest(fl, nr);
-          break;
-        }
+
+      boot_record_begun();
+      switch (mode) {
+      case DB_BOOT_WLD:
+        parse_room(fl, nr);
+        break;
+      case DB_BOOT_MOB:
+        parse_mobile(fl, nr);
+        break;
+      case DB_BOOT_TRG:
+        parse_trigger(fl, nr, boot_slot);
+        break;
+      case DB_BOOT_OBJ:
+        strlcpy(line, parse_object(fl, nr), sizeof(line));
+        break;
+      case DB_BOOT_QST:
+        parse_quest(fl, nr);
+        break;
+      }
+      boot_slot++;
     } else {
       log("SYSERR: Format error in %s file %s near %s #%d", modes[mode],
           filename, modes[mode], nr);
       log("SYSERR: ... offending line: '%s'", line);
-      exit(1);
+      boot_fatal();
     }
   }
 }
@@ -1251,8 +1610,7 @@ static bitvector_t asciiflag_conv_aff(char *flag) {
 
 /* load the rooms */
 void parse_room(FILE *fl, int virtual_nr) {
-  static int room_nr = 0, zone = 0;
-  int t[10], i, retval;
+  int room_nr = boot_slot, t[10], i, retval;
   char line[READ_SIZE], flags[128], flags2[128], flags3[128];
   char flags4[128], buf2[MAX_STRING_LENGTH], buf[128];
   struct extra_descr_data *new_descr;
@@ -1261,32 +1619,25 @@ void parse_room(FILE *fl, int virtual_nr) {
   /* This really had better fit or there are other problems. */
   snprintf(buf2, sizeof(buf2), "room #%d", virtual_nr);
 
-  if (virtual_nr < zone_table[zone].bot) {
-    log("SYSERR: Room #%d is below zone %d (bot=%d, top=%d).", virtual_nr,
-        zone_table[zone].number, zone_table[zone].bot, zone_table[zone].top);
-    exit(1);
-  }
-  while (virtual_nr > zone_table[zone].top)
-    if (++zone > top_of_zone_table) {
-      log("SYSERR: Room %d is outside of any zone.", virtual_nr);
-      exit(1);
-    }
-  world[room_nr].zone = zone;
+  /* A worker thread leaves the zone to index_boot(), which checks the rooms
+   * in order. */
+  if (!in_boot_worker())
+    world[room_nr].zone = room_zone(virtual_nr);
   world[room_nr].number = virtual_nr;
-  world[room_nr].name = fread_string(fl, buf2);
-  world[room_nr].description = fread_string(fl, buf2);
+  world[room_nr].name = str_intern_move(fread_string(fl, buf2));
+  world[room_nr].description = str_intern_move(fread_string(fl, buf2));
 
   if (!get_line(fl, line)) {
     log("SYSERR: Expecting roomflags/sector type of room #%d but file ended!",
         virtual_nr);
-    exit(1);
+    boot_fatal();
   }
 
   if (((retval = sscanf(line, " %d %s %s %s %s %d ", t, flags, flags2, flags3,
                         flags4, t + 2)) == 3) &&
       (bitwarning == TRUE)) {
     log("WARNING: Conventional world files detected. See config.c.");
-    exit(1);
+    boot_fatal();
   } else if ((retval == 3) && (bitwarning == FALSE)) {
     /* Looks like the implementor is ready, so let's load the world files. We
      * load the extra three flags as 0, since they won't be anything anyway. We
@@ -1308,11 +1659,9 @@ void parse_room(FILE *fl, int virtual_nr) {
     check_bitvector_names(world[room_nr].room_flags[0], room_bits_count, flags,
                           "room");
 
-    if (bitsavetodisk) { /* Maybe the implementor just wants to look at the
-                            128bit files */
-      add_to_save_list(zone_table[real_zone_by_thing(virtual_nr)].number, 3);
-      converting = TRUE;
-    }
+    if (bitsavetodisk) /* Maybe the implementor just wants to look at the
+                          128bit files */
+      convert_zone_later(zone_table[real_zone_by_thing(virtual_nr)].number, 3);
 
     log("   done.");
   } else if (retval == 6) {
@@ -1337,7 +1686,7 @@ void parse_room(FILE *fl, int virtual_nr) {
   } else {
     log("SYSERR: Format error in roomflags/sector type of room #%d",
         virtual_nr);
-    exit(1);
+    boot_fatal();
   }
 
   world[room_nr].func = NULL;
@@ -1356,7 +1705,7 @@ void parse_room(FILE *fl, int virtual_nr) {
   for (;;) {
     if (!get_line(fl, line)) {
       log("%s", buf);
-      exit(1);
+      boot_fatal();
     }
     switch (*line) {
     case 'D':
@@ -1364,7 +1713,7 @@ void parse_room(FILE *fl, int virtual_nr) {
       break;
     case 'E':
       CREATE(new_descr, struct extra_descr_data, 1);
-      new_descr->keyword = fread_string(fl, buf2);
+      new_descr->keyword = str_intern_move(fread_string(fl, buf2));
       new_descr->description = fread_string(fl, buf2);
       /* Fix for crashes in the editor when formatting. E-descs are assumed to
        * end with a \r\n. -Welcor */
@@ -1378,6 +1727,7 @@ void parse_room(FILE *fl, int virtual_nr) {
           new_descr->description = end;
         }
       }
+      new_descr->description = str_intern_move(new_descr->description);
       new_descr->next = world[room_nr].ex_description;
       world[room_nr].ex_description = new_descr;
       break;
@@ -1390,11 +1740,10 @@ void parse_room(FILE *fl, int virtual_nr) {
         letter = fread_letter(fl);
         ungetc(letter, fl);
       }
-      top_of_world = room_nr++;
       return;
     default:
       log("%s", buf);
-      exit(1);
+      boot_fatal();
     }
   }
 }
@@ -1413,16 +1762,17 @@ void setup_dir(FILE *fl, int room, int dir) {
   }
 
   CREATE(world[room].dir_option[dir], struct room_direction_data, 1);
-  world[room].dir_option[dir]->general_description = fread_string(fl, buf2);
-  world[room].dir_option[dir]->keyword = fread_string(fl, buf2);
+  world[room].dir_option[dir]->general_description =
+      str_intern_move(fread_string(fl, buf2));
+  world[room].dir_option[dir]->keyword = str_intern_move(fread_string(fl, buf2));
 
   if (!get_line(fl, line)) {
     log("SYSERR: Format error, %s", buf2);
-    exit(1);
+    boot_fatal();
   }
   if (sscanf(line, " %d %d %d ", t, t + 1, t + 2) != 3) {
     log("SYSERR: Format error, %s", buf2);
-    exit(1);
+    boot_fatal();
   }
   if (t[0] == 1)
     world[room].dir_option[dir]->exit_info = EX_ISDOOR;
@@ -1558,7 +1908,7 @@ static void parse_simple_mob(FILE *mob_f, int i, int nr) {
 
   if (!get_line(mob_f, line)) {
     log("SYSERR: Format error in mob #%d, file ended after S flag!", nr);
-    exit(1);
+    boot_fatal();
   }
 
   if (sscanf(line, " %d %d %d %dd%d+%d %dd%d+%d ", t, t + 1, t + 2, t + 3,
@@ -1566,7 +1916,7 @@ static void parse_simple_mob(FILE *mob_f, int i, int nr) {
     log("SYSERR: Format error in mob #%d, first line after S flag\n"
         "...expecting line of form '# # # #d#+# #d#+#'",
         nr);
-    exit(1);
+    boot_fatal();
   }
 
   GET_LEVEL(mob_proto + i) = t[0];
@@ -1590,14 +1940,14 @@ static void parse_simple_mob(FILE *mob_f, int i, int nr) {
     log("SYSERR: Format error in mob #%d, second line after S flag\n"
         "...expecting line of form '# #', but file ended!",
         nr);
-    exit(1);
+    boot_fatal();
   }
 
   if (sscanf(line, " %d %d ", t, t + 1) != 2) {
     log("SYSERR: Format error in mob #%d, second line after S flag\n"
         "...expecting line of form '# #'",
         nr);
-    exit(1);
+    boot_fatal();
   }
 
   GET_GOLD(mob_proto + i) = t[0];
@@ -1607,14 +1957,14 @@ static void parse_simple_mob(FILE *mob_f, int i, int nr) {
     log("SYSERR: Format error in last line of mob #%d\n"
         "...expecting line of form '# # #', but file ended!",
         nr);
-    exit(1);
+    boot_fatal();
   }
 
   if (sscanf(line, " %d %d %d ", t, t + 1, t + 2) != 3) {
     log("SYSERR: Format error in last line of mob #%d\n"
         "...expecting line of form '# # #'",
         nr);
-    exit(1);
+    boot_fatal();
   }
 
   GET_POS(mob_proto + i) = t[0];
@@ -1746,18 +2096,17 @@ static void parse_enhanced_mob(FILE *mob_f, int i, int nr) {
       return;
     else if (*line == '#') { /* we've hit the next mob, maybe? */
       log("SYSERR: Unterminated E section in mob #%d", nr);
-      exit(1);
+      boot_fatal();
     } else
       parse_espec(line, i, nr);
   }
 
   log("SYSERR: Unexpected end of file reached after mob #%d", nr);
-  exit(1);
+  boot_fatal();
 }
 
 void parse_mobile(FILE *mob_f, int nr) {
-  static int i = 0;
-  int j, t[10], retval;
+  int i = boot_slot, j, t[10], retval;
   char line[READ_SIZE], *tmpptr, letter;
   char f1[128], f2[128], f3[128], f4[128], f5[128], f6[128], f7[128], f8[128],
       buf2[128];
@@ -1775,14 +2124,15 @@ void parse_mobile(FILE *mob_f, int nr) {
   sprintf(buf2, "mob vnum %d", nr); /* sprintf: OK (for 'buf2 >= 19') */
 
   /* String data */
-  mob_proto[i].player.name = fread_string(mob_f, buf2);
-  tmpptr = mob_proto[i].player.short_descr = fread_string(mob_f, buf2);
+  mob_proto[i].player.name = str_intern_move(fread_string(mob_f, buf2));
+  mob_proto[i].player.keywords = str_keywords(mob_proto[i].player.name);
+  tmpptr = fread_string(mob_f, buf2);
   if (tmpptr && *tmpptr)
-    if (!str_cmp(fname(tmpptr), "a") || !str_cmp(fname(tmpptr), "an") ||
-        !str_cmp(fname(tmpptr), "the"))
+    if (starts_with_article(tmpptr))
       *tmpptr = LOWER(*tmpptr);
-  mob_proto[i].player.long_descr = fread_string(mob_f, buf2);
-  mob_proto[i].player.description = fread_string(mob_f, buf2);
+  mob_proto[i].player.short_descr = str_intern_move(tmpptr);
+  mob_proto[i].player.long_descr = str_intern_move(fread_string(mob_f, buf2));
+  mob_proto[i].player.description = str_intern_move(fread_string(mob_f, buf2));
   GET_TITLE(mob_proto + i) = NULL;
 
   /* Numeric data */
@@ -1790,7 +2140,7 @@ void parse_mobile(FILE *mob_f, int nr) {
     log("SYSERR: Format error after string section of mob #%d\n"
         "...expecting line of form '# # # {S | E}', but file ended!",
         nr);
-    exit(1);
+    boot_fatal();
   }
 
   if (((retval = sscanf(line, "%s %s %s %s %s %s %s %s %d %c", f1, f2, f3, f4,
@@ -1799,7 +2149,7 @@ void parse_mobile(FILE *mob_f, int nr) {
     /* Let's make the implementor read some, before converting his world files.
      */
     log("WARNING: Conventional mobile files detected. See config.c.");
-    exit(1);
+    boot_fatal();
   } else if ((retval == 4) && (bitwarning == FALSE)) {
     log("Converting mobile #%d to 128bits..", nr);
     MOB_FLAGS(mob_proto + i)[0] = asciiflag_conv(f1);
@@ -1839,10 +2189,8 @@ void parse_mobile(FILE *mob_f, int nr) {
      * characters, but this shouldn't occur anyway. */
     letter = *f4;
 
-    if (bitsavetodisk) {
-      add_to_save_list(zone_table[real_zone_by_thing(nr)].number, 0);
-      converting = TRUE;
-    }
+    if (bitsavetodisk)
+      convert_zone_later(zone_table[real_zone_by_thing(nr)].number, 0);
 
     log("   done.");
   } else if (retval == 10) {
@@ -1870,7 +2218,7 @@ void parse_mobile(FILE *mob_f, int nr) {
     log("SYSERR: Format error after string section of mob #%d\n ...expecting "
         "line of form '# # # {S | E}'",
         nr);
-    exit(1);
+    boot_fatal();
   }
 
   SET_BIT_AR(MOB_FLAGS(mob_proto + i), MOB_ISNPC);
@@ -1890,7 +2238,7 @@ void parse_mobile(FILE *mob_f, int nr) {
   /* add new mob types here.. */
   default:
     log("SYSERR: Unsupported mob type '%c' in mob #%d", letter, nr);
-    exit(1);
+    boot_fatal();
   }
 
   /* DG triggers -- script info follows mob S/E section */
@@ -1909,15 +2257,25 @@ void parse_mobile(FILE *mob_f, int nr) {
 
   mob_proto[i].nr = i;
   mob_proto[i].desc = NULL;
+}
+
+/* Whether the first word of a short description is "a", "an" or "the". Does
+ * without fname(), whose static buffer the boot threads would share. */
+static int starts_with_article(const char *name) {
+  char word[5];
+  int i;
 
-  top_of_mobt = i++;
+  for (i = 0; i < 4 && isalpha(name[i]); i++)
+    word[i] = name[i];
+  word[i] = '\0';
+
+  return (!str_cmp(word, "a") || !str_cmp(word, "an") || !str_cmp(word, "the"));
 }
 
 /* read all objects from obj file; generate index and prototypes */
 char *parse_object(FILE *obj_f, int nr) {
-  static int i = 0;
-  static char line[READ_SIZE];
-  int t[10], j, retval;
+  static BOOT_LOCAL char line[READ_SIZE];
+  int i = boot_slot, t[10], j, retval;
   char *tmpptr, buf2[128], f1[READ_SIZE], f2[READ_SIZE], f3[READ_SIZE],
       f4[READ_SIZE];
   char f5[READ_SIZE], f6[READ_SIZE], f7[READ_SIZE], f8[READ_SIZE];
@@ -1934,25 +2292,29 @@ char *parse_object(FILE *obj_f, int nr) {
   sprintf(buf2, "object #%d", nr); /* sprintf: OK (for 'buf2 >= 19') */
 
   /* string data */
-  if ((obj_proto[i].name = fread_string(obj_f, buf2)) == NULL) {
+  if ((obj_proto[i].name = str_intern_move(fread_string(obj_f, buf2))) ==
+      NULL) {
     log("SYSERR: Null obj name or format error at or near %s", buf2);
-    exit(1);
+    boot_fatal();
   }
-  tmpptr = obj_proto[i].short_description = fread_string(obj_f, buf2);
+  obj_proto[i].keywords = str_keywords(obj_proto[i].name);
+  tmpptr = fread_string(obj_f, buf2);
   if (tmpptr && *tmpptr)
-    if (!str_cmp(fname(tmpptr), "a") || !str_cmp(fname(tmpptr), "an") ||
-        !str_cmp(fname(tmpptr), "the"))
+    if (starts_with_article(tmpptr))
       *tmpptr = LOWER(*tmpptr);
+  obj_proto[i].short_description = str_intern_move(tmpptr);
 
-  tmpptr = obj_proto[i].description = fread_string(obj_f, buf2);
+  tmpptr = fread_string(obj_f, buf2);
   if (tmpptr && *tmpptr)
     CAP(tmpptr);
-  obj_proto[i].action_description = fread_string(obj_f, buf2);
+  obj_proto[i].description = str_intern_move(tmpptr);
+  obj_proto[i].action_description =
+      str_intern_move(fread_string(obj_f, buf2));
 
   /* numeric data */
   if (!get_line(obj_f, line)) {
     log("SYSERR: Expecting first numeric line of %s, but file ended!", buf2);
-    exit(1);
+    boot_fatal();
   }
 
   if (((retval = sscanf(line, " %d %s %s %s %s %s %s %s %s %s %s %s %s", t, f1,
@@ -1961,7 +2323,7 @@ char *parse_object(FILE *obj_f, int nr) {
     /* Let's make the implementor read some, before converting his world files.
      */
     log("WARNING: Conventional object files detected. Please see config.c.");
-    exit(1);
+    boot_fatal();
   } else if (((retval == 4) || (retval == 3)) && (bitwarning == FALSE)) {
 
     if (retval == 3)
@@ -1983,10 +2345,8 @@ char *parse_object(FILE *obj_f, int nr) {
     GET_OBJ_AFFECT(obj_proto + i)[2] = 0;
     GET_OBJ_AFFECT(obj_proto + i)[3] = 0;
 
-    if (bitsavetodisk) {
-      add_to_save_list(zone_table[real_zone_by_thing(nr)].number, 1);
-      converting = TRUE;
-    }
+    if (bitsavetodisk)
+      convert_zone_later(zone_table[real_zone_by_thing(nr)].number, 1);
 
     log("   done.");
   } else if (retval == 13) {
@@ -2008,7 +2368,7 @@ char *parse_object(FILE *obj_f, int nr) {
     log("SYSERR: Format error in first numeric line (expecting 13 args, got "
         "%d), %s",
         retval, buf2);
-    exit(1);
+    boot_fatal();
   }
 
   /* Object flags checked in check_object(). */
@@ -2016,13 +2376,13 @@ char *parse_object(FILE *obj_f, int nr) {
 
   if (!get_line(obj_f, line)) {
     log("SYSERR: Expecting second numeric line of %s, but file ended!", buf2);
-    exit(1);
+    boot_fatal();
   }
   if ((retval = sscanf(line, "%d %d %d %d", t, t + 1, t + 2, t + 3)) != 4) {
     log("SYSERR: Format error in second numeric line (expecting 4 args, got "
         "%d), %s",
         retval, buf2);
-    exit(1);
+    boot_fatal();
   }
   GET_OBJ_VAL(obj_proto + i, 0) = t[0];
   GET_OBJ_VAL(obj_proto + i, 1) = t[1];
@@ -2031,7 +2391,7 @@ char *parse_object(FILE *obj_f, int nr) {
 
   if (!get_line(obj_f, line)) {
     log("SYSERR: Expecting third numeric line of %s, but file ended!", buf2);
-    exit(1);
+    boot_fatal();
   }
   if ((retval = sscanf(line, "%d %d %d %d %d", t, t + 1, t + 2, t + 3,
                        t + 4)) != 5) {
@@ -2044,7 +2404,7 @@ char *parse_object(FILE *obj_f, int nr) {
       log("SYSERR: Format error in third numeric line (expecting 5 args, got "
           "%d), %s",
           retval, buf2);
-      exit(1);
+      boot_fatal();
     }
   }
 
@@ -2077,26 +2437,26 @@ char *parse_object(FILE *obj_f, int nr) {
   for (;;) {
     if (!get_line(obj_f, line)) {
       log("SYSERR: Format error in %s", buf2);
-      exit(1);
+      boot_fatal();
     }
     switch (*line) {
     case 'E':
       CREATE(new_descr, struct extra_descr_data, 1);
-      new_descr->keyword = fread_string(obj_f, buf2);
-      new_descr->description = fread_string(obj_f, buf2);
+      new_descr->keyword = str_intern_move(fread_string(obj_f, buf2));
+      new_descr->description = str_intern_move(fread_string(obj_f, buf2));
       new_descr->next = obj_proto[i].ex_description;
       obj_proto[i].ex_description = new_descr;
       break;
     case 'A':
       if (j >= MAX_OBJ_AFFECT) {
         log("SYSERR: Too many A fields (%d max), %s", MAX_OBJ_AFFECT, buf2);
-        exit(1);
+        boot_fatal();
       }
       if (!get_line(obj_f, line)) {
         log("SYSERR: Format error in 'A' field, %s\n"
             "...expecting 2 numeric constants but file ended!",
             buf2);
-        exit(1);
+        boot_fatal();
       }
 
       if ((retval = sscanf(line, " %d %d ", t, t + 1)) != 2) {
@@ -2104,7 +2464,7 @@ char *parse_object(FILE *obj_f, int nr) {
             "...expecting 2 numeric arguments, got %d\n"
             "...offending line: '%s'",
             buf2, retval, line);
-        exit(1);
+        boot_fatal();
       }
       obj_proto[i].affected[j].location = t[0];
       obj_proto[i].affected[j].modifier = t[1];
@@ -2115,13 +2475,11 @@ char *parse_object(FILE *obj_f, int nr) {
       break;
     case '$':
     case '#':
-      top_of_objt = i;
       check_object(obj_proto + i);
-      i++;
       return (line);
     default:
       log("SYSERR: Format error in (%c): %s", *line, buf2);
-      exit(1);
+      boot_fatal();
     }
   }
 }
@@ -2129,7 +2487,7 @@ char *parse_object(FILE *obj_f, int nr) {
 #define Z zone_table[zone]
 /* load the zone table and command tables */
 static void load_zones(FILE *fl, char *zonename) {
-  static zone_rnum zone = 0;
+  zone_rnum zone = boot_slot;
   int i, cmd_no, num_of_cmds = 0, line_num = 0, tmp, error;
   char *ptr, buf[READ_SIZE], zname[READ_SIZE], buf2[MAX_STRING_LENGTH];
   int zone_fix = FALSE;
@@ -2155,7 +2513,7 @@ static void load_zones(FILE *fl, char *zonename) {
 
   if (num_of_cmds == 0) {
     log("SYSERR: %s is empty!", zname);
-    exit(1);
+    boot_fatal();
   } else
     CREATE(Z.cmd, struct reset_com, num_of_cmds);
 
@@ -2163,7 +2521,7 @@ static void load_zones(FILE *fl, char *zonename) {
 
   if (sscanf(buf, "#%hd", &Z.number) != 1) {
     log("SYSERR: Format error in %s, line %d", zname, line_num);
-    exit(1);
+    boot_fatal();
   }
   snprintf(buf2, sizeof(buf2), "beginning of zone #%d", Z.number);
 
@@ -2198,7 +2556,7 @@ static void load_zones(FILE *fl, char *zonename) {
       if (sscanf(Z.name, " %hd %hd %d %d ", &Z.bot, &Z.top, &Z.lifespan,
                  &Z.reset_mode) != 4) {
         log("SYSERR: Could not fix previous error, aborting game.");
-        exit(1);
+        boot_fatal();
       } else {
         free(Z.name);
         Z.name = strdup(Z.builders);
@@ -2219,7 +2577,7 @@ static void load_zones(FILE *fl, char *zonename) {
   }
   if (Z.bot > Z.top) {
     log("SYSERR: Zone %d bottom (%d) > top (%d).", Z.number, Z.bot, Z.top);
-    exit(1);
+    boot_fatal();
   }
 
   cmd_no = 0;
@@ -2229,7 +2587,7 @@ static void load_zones(FILE *fl, char *zonename) {
     if (zone_fix != TRUE) {
       if ((tmp = get_line(fl, buf)) == 0) {
         log("SYSERR: Format error in %s - premature end of file", zname);
-        exit(1);
+        boot_fatal();
       }
     } else
       zone_fix = FALSE;
@@ -2269,7 +2627,7 @@ static void load_zones(FILE *fl, char *zonename) {
 
     if (error) {
       log("SYSERR: Format error in %s, line %d: '%s'", zname, line_num, buf);
-      exit(1);
+      boot_fatal();
     }
     ZCMD.line = line_num;
     cmd_no++;
@@ -2278,10 +2636,8 @@ static void load_zones(FILE *fl, char *zonename) {
   if (num_of_cmds != cmd_no + 1) {
     log("SYSERR: Zone command count mismatch for %s. Estimated: %d, Actual: %d",
         zname, num_of_cmds, cmd_no + 1);
-    exit(1);
+    boot_fatal();
   }
-
-  top_of_zone_table = zone++;
 }
 #undef Z
 
@@ -2391,36 +2747,42 @@ static int hsort(const void *a, const void *b) {
 }
 
 int vnum_mobile(char *searchname, struct char_data *ch) {
-  int nr, found = 0;
+  int i, nr, found = 0;
 
-  for (nr = 0; nr <= top_of_mobt; nr++)
-    if (isname(searchname, mob_proto[nr].player.name))
+  for (i = 0; i < mob_vnum_count; i++) {
+    nr = mob_vnum_order[i];
+    if (isname_char(searchname, &mob_proto[nr]))
       send_to_char(ch, "%3d. [%5d] %-40s %s\r\n", ++found, mob_index[nr].vnum,
                    mob_proto[nr].player.short_descr,
                    mob_proto[nr].proto_script ? "[TRIG]" : "");
+  }
 
   return (found);
 }
 
 int vnum_object(char *searchname, struct char_data *ch) {
-  int nr, found = 0;
+  int i, nr, found = 0;
 
-  for (nr = 0; nr <= top_of_objt; nr++)
-    if (isname(searchname, obj_proto[nr].name))
+  for (i = 0; i < obj_vnum_count; i++) {
+    nr = obj_vnum_order[i];
+    if (isname_obj(searchname, &obj_proto[nr]))
       send_to_char(ch, "%3d. [%5d] %-40s %s\r\n", ++found, obj_index[nr].vnum,
                    obj_proto[nr].short_description,
                    obj_proto[nr].proto_script ? "[TRIG]" : "");
+  }
 
   return (found);
 }
 
 int vnum_room(char *searchname, struct char_data *ch) {
-  int nr, found = 0;
+  int i, nr, found = 0;
 
-  for (nr = 0; nr <= top_of_world; nr++)
+  for (i = 0; i < world_vnum_count; i++) {
+    nr = world_vnum_order[i];
     if (isname(searchname, world[nr].name))
       send_to_char(ch, "%3d. [%5d] %-40s %s\r\n", ++found, world[nr].number,
                    world[nr].name, world[nr].proto_script ? "[TRIG]" : "");
+  }
   return (found);
 }
 
@@ -2437,7 +2799,7 @@ int vnum_trig(char *searchname, struct char_data *ch) {
 struct char_data *create_char(void) {
   struct char_data *ch;
 
-  CREATE(ch, struct char_data, 1);
+  ch = slab_alloc(&char_slab);
   clear_char(ch);
 
   new_mobile_data(ch);
@@ -2469,7 +2831,7 @@ struct char_data *read_mobile(mob_vnum nr, int type) /* and mob_rnum */
   } else
     i = nr;
 
-  CREATE(mob, struct char_data, 1);
+  mob = slab_alloc(&char_slab);
   clear_char(mob);
 
   *mob = mob_proto[i];
@@ -2506,7 +2868,7 @@ struct char_data *read_mobile(mob_vnum nr, int type) /* and mob_rnum */
 struct obj_data *create_obj(void) {
   struct obj_data *obj;
 
-  CREATE(obj, struct obj_data, 1);
+  obj = slab_alloc(&obj_slab);
   clear_object(obj);
   obj->next = object_list;
   object_list = obj;
@@ -2530,13 +2892,14 @@ struct obj_data *read_object(obj_vnum nr, int type) /* and obj_rnum */
     return (NULL);
   }
 
-  CREATE(obj, struct obj_data, 1);
+  obj = slab_alloc(&obj_slab);
   clear_object(obj);
   *obj = obj_proto[i];
   obj->next = object_list;
   object_list = obj;
 
   obj->events = NULL;
+  set_obj_timer(obj, GET_OBJ_TIMER(obj));
 
   obj_index[i].number++;
 
@@ -2586,6 +2949,12 @@ void zone_update(void) {
 
         zone_table[i].age = ZO_DEAD;
       }
+
+      /* Put zones that have stayed empty long enough to sleep. */
+      if (zone_table[i].players == 0 && CONFIG_HIBERNATE_TIME > 0 &&
+          !zone_table[i].hibernating &&
+          ++zone_table[i].empty_for >= CONFIG_HIBERNATE_TIME)
+        hibernate_zone(i);
     }
   } /* end - one minute has passed */
 
@@ -2784,7 +3153,10 @@ void reset_zone(zone_rnum zone) {
                  world[ZCMD.arg1].number, ZCMD.arg2);
         ZONE_ERROR(error);
         ZCMD.command = '*';
-      } else
+      } else {
+        int was_closed = EXIT_FLAGGED(world[ZCMD.arg1].dir_option[ZCMD.arg2],
+                                      EX_CLOSED) != 0;
+
         switch (ZCMD.arg3) {
         case 0:
           REMOVE_BIT(world[ZCMD.arg1].dir_option[ZCMD.arg2]->exit_info,
@@ -2802,6 +3174,11 @@ void reset_zone(zone_rnum zone) {
           SET_BIT(world[ZCMD.arg1].dir_option[ZCMD.arg2]->exit_info, EX_CLOSED);
           break;
         }
+        /* Most resets leave the door as it was; only a change moves trackers. */
+        if (was_closed != (EXIT_FLAGGED(world[ZCMD.arg1].dir_option[ZCMD.arg2],
+                                        EX_CLOSED) != 0))
+          invalidate_paths();
+      }
       last_cmd = 1;
       tmob = NULL;
       tobj = NULL;
@@ -2810,12 +3187,12 @@ void reset_zone(zone_rnum zone) {
     case 'T': /* trigger command */
       if (ZCMD.arg1 == MOB_TRIGGER && tmob) {
         if (!SCRIPT(tmob))
-          CREATE(SCRIPT(tmob), struct script_data, 1);
+          SCRIPT(tmob) = create_script(tmob, MOB_TRIGGER);
         add_trigger(SCRIPT(tmob), read_trigger(ZCMD.arg2), -1);
         last_cmd = 1;
       } else if (ZCMD.arg1 == OBJ_TRIGGER && tobj) {
         if (!SCRIPT(tobj))
-          CREATE(SCRIPT(tobj), struct script_data, 1);
+          SCRIPT(tobj) = create_script(tobj, OBJ_TRIGGER);
         add_trigger(SCRIPT(tobj), read_trigger(ZCMD.arg2), -1);
         last_cmd = 1;
       } else if (ZCMD.arg1 == WLD_TRIGGER) {
@@ -2823,7 +3200,7 @@ void reset_zone(zone_rnum zone) {
           ZONE_ERROR("Invalid room number in trigger assignment");
         }
         if (!world[ZCMD.arg3].script)
-          CREATE(world[ZCMD.arg3].script, struct script_data, 1);
+          world[ZCMD.arg3].script = create_script(&world[ZCMD.arg3], WLD_TRIGGER);
         add_trigger(world[ZCMD.arg3].script, read_trigger(ZCMD.arg2), -1);
         last_cmd = 1;
       }
@@ -2878,27 +3255,11 @@ void reset_zone(zone_rnum zone) {
   }
 }
 
-/* for use in reset_zone; return TRUE if zone 'nr' is free of PC's  */
+/* for use in reset_zone; return TRUE if zone 'nr' is free of PC's.  The
+ * count is kept by char_to_room() and char_from_room(); immortals with
+ * nohassle on are left out of it. */
 int is_empty(zone_rnum zone_nr) {
-  struct descriptor_data *i;
-
-  for (i = descriptor_list; i; i = i->next) {
-    if (STATE(i) != CON_PLAYING)
-      continue;
-    if (IN_ROOM(i->character) == NOWHERE)
-      continue;
-    if (world[IN_ROOM(i->character)].zone != zone_nr)
-      continue;
-    /* If an immortal has nohassle off, he counts as present. Added for testing
-     * zone reset triggers -Welcor */
-    if ((!IS_NPC(i->character)) && (GET_LEVEL(i->character) >= LVL_IMMORT) &&
-        (PRF_FLAGGED(i->character, PRF_NOHASSLE)))
-      continue;
-
-    return (0);
-  }
-
-  return (1);
+  return (zone_table[zone_nr].players == 0);
 }
 
 /* Functions of a general utility nature. */
@@ -2913,7 +3274,7 @@ char *fread_string(FILE *fl, const char *error) {
   do {
     if (!fgets(tmp, 512, fl)) {
       log("SYSERR: fread_string: format error at or near %s", error);
-      exit(1);
+      boot_fatal();
     }
     /* If there is a '~', end the string; else put an "\r\n" over the '\n'. */
     /* now only removes trailing ~'s -- Welcor */
@@ -2934,7 +3295,7 @@ char *fread_string(FILE *fl, const char *error) {
     if (length + templength >= MAX_STRING_LENGTH) {
       log("SYSERR: fread_string: string too large (db.c)");
       log("%s", error);
-      exit(1);
+      boot_fatal();
     } else {
       strcat(buf + length, tmp); /* strcat: OK (size checked above) */
       length += templength;
@@ -3333,7 +3694,7 @@ void free_char(struct char_data *ch) {
     remove_from_lookup_table(ch->script_id);
   }
 
-  free(ch);
+  slab_free(&char_slab, ch);
 }
 
 /* release memory allocated for an obj struct */
@@ -3357,7 +3718,7 @@ void free_obj(struct obj_data *obj) {
     remove_from_lookup_table(obj->script_id);
   }
 
-  free(obj);
+  slab_free(&obj_slab, obj);
 }
 
 /* Steps: 1: Read contents of a text file. 2: Make sure no one is using the
@@ -3553,9 +3914,10 @@ void init_char(struct char_data *ch) {
     GET_HEIGHT(ch) = rand_number(150, 180); /* 5'0" - 6'0" */
   }
 
-  if ((i = get_ptable_by_name(GET_NAME(ch))) != -1)
+  if ((i = get_ptable_by_name(GET_NAME(ch))) != -1) {
     player_table[i].id = GET_IDNUM(ch) = ++top_idnum;
-  else
+    index_player_entry(i);
+  } else
     log("SYSERR: init_char: Character '%s' not found in player table.",
         GET_NAME(ch));
 
@@ -3599,102 +3961,275 @@ void init_char(struct char_data *ch) {
   SET_BIT_AR(PRF_FLAGS(ch), PRF_DISPMOVE);
 }
 
-/* returns the real number of the room with given virtual number */
-room_rnum real_room(room_vnum vnum) {
-  room_rnum bot, top, mid;
+/* The tables with a vnum order, by boot mode. */
+struct vnum_table {
+  IDXTYPE **order; /* Its rnums in vnum order. */
+  int *count;      /* Entries in use at the start of the order. */
+  IDXTYPE *top;    /* Its top rnum. */
+  int *slots;      /* Entries allocated in it and its order. */
+  IDXTYPE **map;   /* Its rnums by vnum. */
+  int *map_len;    /* Entries allocated in its map. */
+};
+
+static void get_vnum_table(int mode, struct vnum_table *t) {
+  switch (mode) {
+  case DB_BOOT_WLD:
+    t->order = &world_vnum_order;
+    t->count = &world_vnum_count;
+    t->top = &top_of_world;
+    t->slots = &world_slots;
+    t->map = &world_vnum_map;
+    t->map_len = &world_map_len;
+    break;
+  case DB_BOOT_MOB:
+    t->order = &mob_vnum_order;
+    t->count = &mob_vnum_count;
+    t->top = &top_of_mobt;
+    t->slots = &mob_slots;
+    t->map = &mob_vnum_map;
+    t->map_len = &mob_map_len;
+    break;
+  default:
+    t->order = &obj_vnum_order;
+    t->count = &obj_vnum_count;
+    t->top = &top_of_objt;
+    t->slots = &obj_slots;
+    t->map = &obj_vnum_map;
+    t->map_len = &obj_map_len;
+    break;
+  }
+}
 
-  bot = 0;
-  top = top_of_world;
+static IDXTYPE table_vnum(int mode, IDXTYPE rnum) {
+  switch (mode) {
+  case DB_BOOT_WLD:
+    return (world[rnum].number);
+  case DB_BOOT_MOB:
+    return (mob_index[rnum].vnum);
+  default:
+    return (obj_index[rnum].vnum);
+  }
+}
 
-  if (world[bot].number > vnum || world[top].number < vnum)
-    return (NOWHERE);
+/* Where vnum is, or would go, in the vnum order of a table. */
+static int vnum_order_pos(int mode, IDXTYPE vnum) {
+  struct vnum_table t;
+  int bot = 0, top, mid;
 
-  /* perform binary search on world-table */
-  while (bot <= top) {
+  get_vnum_table(mode, &t);
+  top = *t.count;
+  while (bot < top) {
     mid = (bot + top) / 2;
-
-    if ((world + mid)->number == vnum)
-      return (mid);
-    if ((world + mid)->number > vnum)
-      top = mid - 1;
-    else
+    if (table_vnum(mode, (*t.order)[mid]) < vnum)
       bot = mid + 1;
+    else
+      top = mid;
   }
-  return (NOWHERE);
+  return (bot);
 }
 
-/* returns the real number of the monster with given virtual number */
-mob_rnum real_mobile(mob_vnum vnum) {
-  mob_rnum bot, top, mid;
+/* Makes a vnum map long enough to hold vnum, doubling it as OLC adds higher
+ * vnums. */
+static void grow_vnum_map(IDXTYPE **map, int *len, IDXTYPE vnum) {
+  int i, old_len = *len;
 
-  bot = 0;
-  top = top_of_mobt;
+  if ((int)vnum < old_len)
+    return;
 
-  /* quickly reject out-of-range vnums */
-  if (mob_index[bot].vnum > vnum || mob_index[top].vnum < vnum)
-    return (NOBODY);
+  *len = MIN(MAX(vnum + 1, old_len * 2), IDXTYPE_MAX + 1);
+  RECREATE(*map, IDXTYPE, *len);
+  for (i = old_len; i < *len; i++)
+    (*map)[i] = NOWHERE;
+}
 
-  /* perform binary search on mob-table */
-  while (bot <= top) {
-    mid = (bot + top) / 2;
+static int sorting_mode;
 
-    if ((mob_index + mid)->vnum == vnum)
-      return (mid);
-    if ((mob_index + mid)->vnum > vnum)
-      top = mid - 1;
-    else
-      bot = mid + 1;
-  }
-  return (NOBODY);
+/* Free slots sort last, whether NOWHERE is -1 or the highest index. */
+static int vnum_order_cmp(const void *a, const void *b) {
+  IDXTYPE x = table_vnum(sorting_mode, *(const IDXTYPE *)a);
+  IDXTYPE y = table_vnum(sorting_mode, *(const IDXTYPE *)b);
+
+  if (x == NOWHERE || y == NOWHERE)
+    return ((x == NOWHERE) - (y == NOWHERE));
+  return (x < y ? -1 : x > y);
 }
 
-/* returns the real number of the object with given virtual number */
-obj_rnum real_object(obj_vnum vnum) {
-  obj_rnum bot, top, mid;
+/* Builds the vnum order of a table once it has been loaded. */
+void sort_vnum_order(int mode) {
+  struct vnum_table t;
+  int i, sorted = TRUE;
+
+  get_vnum_table(mode, &t);
+  *t.slots = *t.top + 1;
+  *t.count = 0;
+  RECREATE(*t.order, IDXTYPE, *t.slots);
+  for (i = 0; i <= *t.top; i++) {
+    (*t.order)[i] = i;
+    if (table_vnum(mode, i) != NOWHERE)
+      (*t.count)++;
+    if (i && table_vnum(mode, i - 1) >= table_vnum(mode, i))
+      sorted = FALSE;
+  }
 
-  bot = 0;
-  top = top_of_objt;
+  /* The files are in vnum order, so this is only for a snapshot taken
+   * after OLC had added to or deleted from the tables. */
+  if (!sorted) {
+    sorting_mode = mode;
+    qsort(*t.order, *t.top + 1, sizeof(IDXTYPE), vnum_order_cmp);
+  }
 
-  /* quickly reject out-of-range vnums */
-  if (obj_index[bot].vnum > vnum || obj_index[top].vnum < vnum)
-    return (NOTHING);
+  free(*t.map);
+  *t.map = NULL;
+  *t.map_len = 0;
+  if (*t.count)
+    grow_vnum_map(t.map, t.map_len,
+                  table_vnum(mode, (*t.order)[*t.count - 1]));
+  for (i = 0; i < *t.count; i++)
+    (*t.map)[table_vnum(mode, (*t.order)[i])] = (*t.order)[i];
+}
 
-  /* perform binary search on obj-table */
-  while (bot <= top) {
-    mid = (bot + top) / 2;
+/* Builds the zone map once the zone table has been loaded or added to. */
+void map_zone_vnums(void) {
+  zone_rnum i;
 
-    if ((obj_index + mid)->vnum == vnum)
-      return (mid);
-    if ((obj_index + mid)->vnum > vnum)
-      top = mid - 1;
-    else
-      bot = mid + 1;
+  free(zone_vnum_map);
+  zone_vnum_map = NULL;
+  zone_map_len = 0;
+  grow_vnum_map(&zone_vnum_map, &zone_map_len,
+                zone_table[top_of_zone_table].number);
+  for (i = 0; i <= top_of_zone_table; i++)
+    if (zone_table[i].number >= 0)
+      zone_vnum_map[zone_table[i].number] = i;
+}
+
+/* Zeroes a table entry.  It is left as a free slot until it is given a
+ * vnum. */
+static IDXTYPE clear_table_entry(int mode, IDXTYPE rnum) {
+  switch (mode) {
+  case DB_BOOT_WLD:
+    memset(&world[rnum], 0, sizeof(struct room_data));
+    world[rnum].number = NOWHERE;
+    world[rnum].zone = NOWHERE;
+    break;
+  case DB_BOOT_MOB:
+    memset(&mob_proto[rnum], 0, sizeof(struct char_data));
+    memset(&mob_index[rnum], 0, sizeof(struct index_data));
+    mob_proto[rnum].nr = NOBODY;
+    mob_index[rnum].vnum = NOBODY;
+    break;
+  case DB_BOOT_OBJ:
+    memset(&obj_proto[rnum], 0, sizeof(struct obj_data));
+    memset(&obj_index[rnum], 0, sizeof(struct index_data));
+    obj_proto[rnum].item_number = NOTHING;
+    obj_index[rnum].vnum = NOTHING;
+    break;
   }
-  return (NOTHING);
+  return (rnum);
 }
 
-/* returns the real number of the zone with given virtual number */
-zone_rnum real_zone(zone_vnum vnum) {
-  zone_rnum bot, top, mid;
+/* Makes a new, zeroed entry for OLC to fill in, then add_to_vnum_order(),
+ * and returns its rnum.  The slot freed last is reused before the table
+ * grows. */
+IDXTYPE new_table_entry(int mode) {
+  struct room_data *old_world = world;
+  struct vnum_table t;
+  room_rnum i;
+
+  get_vnum_table(mode, &t);
+  if (*t.count <= *t.top)
+    return (clear_table_entry(mode, (*t.order)[*t.count]));
+
+  if (*t.top + 2 > *t.slots) {
+    *t.slots = MAX(*t.slots * 2, *t.top + 2);
+    RECREATE(*t.order, IDXTYPE, *t.slots);
+    switch (mode) {
+    case DB_BOOT_WLD:
+      RECREATE(world, struct room_data, *t.slots);
+      /* Scripts waiting in a room point at it. */
+      if (world != old_world)
+        for (i = 0; i <= top_of_world; i++)
+          update_wait_events(&world[i], &world[i]);
+      break;
+    case DB_BOOT_MOB:
+      RECREATE(mob_proto, struct char_data, *t.slots);
+      RECREATE(mob_index, struct index_data, *t.slots);
+      break;
+    case DB_BOOT_OBJ:
+      RECREATE(obj_proto, struct obj_data, *t.slots);
+      RECREATE(obj_index, struct index_data, *t.slots);
+      break;
+    }
+  }
+
+  (*t.top)++;
+  (*t.order)[*t.top] = *t.top;
+  return (clear_table_entry(mode, *t.top));
+}
+
+/* Puts an entry from new_table_entry() in its place in the vnum order, once
+ * it has been given its vnum. */
+void add_to_vnum_order(int mode, IDXTYPE rnum) {
+  struct vnum_table t;
+  int pos;
+
+  get_vnum_table(mode, &t);
+  /* The new entry is the first free slot, just past the entries in use, so
+   * moving them up makes room for it. */
+  pos = vnum_order_pos(mode, table_vnum(mode, rnum));
+  memmove(*t.order + pos + 1, *t.order + pos,
+          (*t.count - pos) * sizeof(IDXTYPE));
+  (*t.order)[pos] = rnum;
+  (*t.count)++;
+
+  grow_vnum_map(t.map, t.map_len, table_vnum(mode, rnum));
+  (*t.map)[table_vnum(mode, rnum)] = rnum;
+}
 
-  bot = 0;
-  top = top_of_zone_table;
+/* Takes an entry out of the vnum order as OLC deletes it, and clears its
+ * slot for new_table_entry() to reuse.  No other rnum changes.  The caller
+ * frees what the entry points to and unlinks what refers to it first. */
+void remove_from_vnum_order(int mode, IDXTYPE rnum) {
+  struct vnum_table t;
+  IDXTYPE vnum = table_vnum(mode, rnum);
+  int pos;
+
+  get_vnum_table(mode, &t);
+  pos = vnum_order_pos(mode, vnum);
+  (*t.count)--;
+  memmove(*t.order + pos, *t.order + pos + 1,
+          (*t.count - pos) * sizeof(IDXTYPE));
+  (*t.order)[*t.count] = rnum;
+  (*t.map)[vnum] = NOWHERE;
+
+  clear_table_entry(mode, rnum);
+}
 
-  if (zone_table[bot].number > vnum || zone_table[top].number < vnum)
+/* returns the real number of the room with given virtual number */
+room_rnum real_room(room_vnum vnum) {
+  if ((unsigned int)vnum >= (unsigned int)world_map_len)
     return (NOWHERE);
+  return (world_vnum_map[vnum]);
+}
 
-  /* perform binary search on zone-table */
-  while (bot <= top) {
-    mid = (bot + top) / 2;
+/* returns the real number of the monster with given virtual number */
+mob_rnum real_mobile(mob_vnum vnum) {
+  if ((unsigned int)vnum >= (unsigned int)mob_map_len)
+    return (NOBODY);
+  return (mob_vnum_map[vnum]);
+}
 
-    if ((zone_table + mid)->number == vnum)
-      return (mid);
-    if ((zone_table + mid)->number > vnum)
-      top = mid - 1;
-    else
-      bot = mid + 1;
-  }
-  return (NOWHERE);
+/* returns the real number of the object with given virtual number */
+obj_rnum real_object(obj_vnum vnum) {
+  if ((unsigned int)vnum >= (unsigned int)obj_map_len)
+    return (NOTHING);
+  return (obj_vnum_map[vnum]);
+}
+
+/* returns the real number of the zone with given virtual number */
+zone_rnum real_zone(zone_vnum vnum) {
+  if ((unsigned int)vnum >= (unsigned int)zone_map_len)
+    return (NOWHERE);
+  return (zone_vnum_map[vnum]);
 }
 
 /* Extend later to include more checks and add checks for unknown bitvectors. */
@@ -3876,6 +4411,8 @@ static void load_default_config(void) {
   CONFIG_MINIMAP_SIZE = default_minimap_size;
   CONFIG_SCRIPT_PLAYERS = script_players;
   CONFIG_DEBUG_MODE = debug_mode;
+  CONFIG_MCCP_LEVEL = mccp_level;
+  CONFIG_HIBERNATE_TIME = hibernate_time;
 
   /* Rent / crashsave options. */
   CONFIG_FREE_RENT = free_rent;
@@ -4016,7 +4553,9 @@ void load_config(void) {
       break;
 
     case 'h':
-      if (!str_cmp(tag, "holler_move_cost"))
+      if (!str_cmp(tag, "hibernate_time"))
+        CONFIG_HIBERNATE_TIME = MAX(num, 0);
+      else if (!str_cmp(tag, "holler_move_cost"))
         CONFIG_HOLLER_MOVE_COST = num;
       else if (!str_cmp(tag, "huh")) {
         char tmp[READ_SIZE];
@@ -4072,6 +4611,8 @@ void load_config(void) {
         CONFIG_MAX_PC_CORPSE_TIME = num;
       else if (!str_cmp(tag, "max_playing"))
         CONFIG_MAX_PLAYING = num;
+      else if (!str_cmp(tag, "mccp_level"))
+        CONFIG_MCCP_LEVEL = MIN(MAX(num, 0), 9);
       else if (!str_cmp(tag, "menu")) {
         if (CONFIG_MENU)
           free(CONFIG_MENU);
@@ -24,6 +24,9 @@
 #define DB_BOOT_TRG	6
 #define DB_BOOT_QST 7
 
+/* most threads index_boot() parses world files on at once */
+#define BOOT_THREADS_MAX	8
+
 #if defined(CIRCLE_MACINTOSH)
 #define LIB_WORLD	":world:"
 #define LIB_TEXT	":text:"
@@ -76,6 +79,8 @@
 /* names of various files and directories */
 #define INDEX_FILE	"index"		/* index of world files		*/
 #define MINDEX_FILE	"index.mini"	/* ... and for mini-mud-mode	*/
+#define PLR_JOURNAL_FILE "index.jnl"	/* player index changes since	*/
+#define PLR_JOURNAL_MIN	1024		/* ... journal this many first	*/
 #define WLD_PREFIX  LIB_WORLD"wld"SLASH	/* room definitions	*/
 #define MOB_PREFIX  LIB_WORLD"mob"SLASH	/* monster prototypes	*/
 #define OBJ_PREFIX  LIB_WORLD"obj"SLASH	/* object prototypes	*/
@@ -84,6 +89,8 @@
 #define TRG_PREFIX  LIB_WORLD"trg"SLASH	/* trigger files	*/
 #define HLP_PREFIX  LIB_TEXT"help"SLASH /* Help files           */
 #define QST_PREFIX  LIB_WORLD"qst"SLASH /* quest files          */
+#define WORLD_SNAPSHOT_FILE LIB_WORLD"world.snap" /* compiled world	*/
+#define HELP_SNAPSHOT_FILE LIB_TEXT_HELP"help.snap" /* compiled help	*/
 
 #define CREDITS_FILE	LIB_TEXT"credits" /* for the 'credits' command	*/
 #define NEWS_FILE	LIB_TEXT"news"	/* for the 'news' command	*/
@@ -189,6 +196,11 @@ struct zone_data {
    zone_vnum number;	    /* virtual number of this zone	  */
    struct reset_com *cmd;   /* command table for reset	          */
 
+   int players;             /* players in the zone's rooms        */
+   int empty_for;           /* minutes the zone has had no player */
+   bool hibernating;        /* mobs are resting until one returns */
+   long hibernated_at;      /* point_update() tick it began at    */
+
    /* Reset mode:
     *   0: Don't reset, and don't update age.
     *   1: Reset if no PC's are located in zone.
@@ -262,6 +274,11 @@ zone_rnum real_zone(zone_vnum vnum);
 room_rnum real_room(room_vnum vnum);
 mob_rnum real_mobile(mob_vnum vnum);
 obj_rnum real_object(obj_vnum vnum);
+void sort_vnum_order(int mode);
+void map_zone_vnums(void);
+IDXTYPE new_table_entry(int mode);
+void add_to_vnum_order(int mode, IDXTYPE rnum);
+void remove_from_vnum_order(int mode, IDXTYPE rnum);
 
 /* Public Procedures from objsave.c */
 void  Crash_save_all(void);
@@ -292,7 +309,10 @@ void   clear_char(struct char_data *ch);
 void   reset_char(struct char_data *ch);
 void   free_char(struct char_data *ch);
 void   save_player_index(void);
+void   journal_player_entry(int pos);
+void   journal_player_removal(const char *name);
 long   get_ptable_by_name(const char *name);
+void   index_player_entry(int pos);
 void   remove_player(int pfilepos);
 void   clean_pfiles(void);
 void   build_player_index(void);
@@ -317,6 +337,7 @@ void reboot_wizlists(void);
 ACMD(do_reboot);
 void boot_world(void);
 int count_hash_records(FILE *fl);
+int boot_log_capture(const char *format, va_list args);
 bitvector_t asciiflag_conv(char *flag);
 void renum_world(void);
 void load_config( void );
@@ -347,6 +368,7 @@ extern struct help_index_element *help_table;
 extern int no_mail;
 extern int mini_mud;
 extern int no_rent_check;
+extern int serial_boot;
 extern time_t boot_time;
 extern int circle_restrict;
 extern room_rnum r_mortal_start_room;
@@ -371,12 +393,23 @@ extern struct char_data *character_list;
 extern struct index_data *mob_index;
 extern struct char_data *mob_proto;
 extern mob_rnum top_of_mobt;
+extern struct player_special_data dummy_mob;
 
 extern struct index_data *obj_index;
 extern struct obj_data *object_list;
 extern struct obj_data *obj_proto;
 extern obj_rnum top_of_objt;
 
+extern room_rnum *world_vnum_order;
+extern mob_rnum *mob_vnum_order;
+extern obj_rnum *obj_vnum_order;
+extern int world_vnum_count;
+extern int mob_vnum_count;
+extern int obj_vnum_count;
+extern int world_slots;
+extern int mob_slots;
+extern int obj_slots;
+
 extern struct social_messg *soc_mess_list;
 extern int top_of_socialt;
 
@@ -23,19 +23,21 @@
 #include "comm.h"
 #include "constants.h"
 #include "interpreter.h" /* For half_chop */
+#include "slab.h"
 
 /* local functions */
 static void trig_data_init(trig_data *this_data);
 
-void parse_trigger(FILE *trig_f, int nr)
+/* Read trigger nr into trig_index[rnum]. */
+void parse_trigger(FILE *trig_f, int nr, int rnum)
 {
-    int t[2], k, attach_type;
+    int t[2], k, attach_type, len;
     char line[256], *cmds, *s, flags[256], errors[MAX_INPUT_LENGTH];
     struct cmdlist_element *cle;
     struct index_data *t_index;
     struct trig_data *trig;
 
-    CREATE(trig, trig_data, 1);
+    trig = slab_alloc(&trig_slab);
     CREATE(t_index, index_data, 1);
 
     t_index->vnum = nr;
@@ -45,7 +47,7 @@ void parse_trigger(FILE *trig_f, int nr)
 
     snprintf(errors, sizeof(errors), "trig vnum %d", nr);
 
-    trig->nr = top_of_trigt;
+    trig->nr = rnum;
     trig->name = fread_string(trig_f, errors);
 
     get_line(trig_f, line);
@@ -56,21 +58,30 @@ void parse_trigger(FILE *trig_f, int nr)
 
     trig->arglist = fread_string(trig_f, errors);
 
-    cmds = s = fread_string(trig_f, errors);
-
-    CREATE(trig->cmdlist, struct cmdlist_element, 1);
-    trig->cmdlist->cmd = strdup(strtok(s, "\n\r"));
-    cle = trig->cmdlist;
-
-    while ((s = strtok(NULL, "\n\r"))) {
-	CREATE(cle->next, struct cmdlist_element, 1);
-	cle = cle->next;
-	cle->cmd = strdup(s);
+    cmds = fread_string(trig_f, errors);
+
+    /* One command per line, skipping blank ones. Not strtok(), since triggers
+     * are read on several threads at boot. */
+    cle = NULL;
+    for (s = cmds; s && *(s += strspn(s, "\n\r")); s += len) {
+	len = strcspn(s, "\n\r");
+	if (cle) {
+	    CREATE(cle->next, struct cmdlist_element, 1);
+	    cle = cle->next;
+	} else {
+	    CREATE(trig->cmdlist, struct cmdlist_element, 1);
+	    cle = trig->cmdlist;
+	}
+	CREATE(cle->cmd, char, len + 1);
+	strncpy(cle->cmd, s, len);
     }
 
-    free(cmds);
+    if (cmds)
+	free(cmds);
 
-    trig_index[top_of_trigt++] = t_index;
+    compile_trigger(trig);
+
+    trig_index[rnum] = t_index;
 }
 
 /* Create a new trigger from a prototype. nr is the real number of the trigger. */
@@ -83,7 +94,7 @@ trig_data *read_trigger(int nr)
     if ((t_index = trig_index[nr]) == NULL)
 	return NULL;
 
-    CREATE(trig, trig_data, 1);
+    trig = slab_alloc(&trig_slab);
     trig_data_copy(trig, t_index->proto);
 
     t_index->number++;
@@ -197,16 +208,7 @@ void dg_read_trigger(FILE *fp, void *proto, int type)
           trg_proto = trg_proto->next;
         trg_proto->next = new_trg;
       }
-
-      if (rnum != NOTHING) {
-        if (!(room->script))
-          CREATE(room->script, struct script_data, 1);
-        add_trigger(SCRIPT(room), read_trigger(rnum), -1);
-      } else {
-        mudlog(BRF, LVL_BUILDER, TRUE,
-               "SYSERR: non-existant trigger #%d assigned to room #%d",
-               vnum, room->number);
-      }
+      /* index_boot() attaches the scripts once every room is read. */
       break;
     default:
       mudlog(BRF, LVL_BUILDER, TRUE,
@@ -270,7 +272,7 @@ void assign_triggers(void *i, int type)
                  trg_proto->vnum, mob_index[mob->nr].vnum);
         } else {
           if (!SCRIPT(mob))
-            CREATE(SCRIPT(mob), struct script_data, 1);
+            SCRIPT(mob) = create_script(mob, MOB_TRIGGER);
           add_trigger(SCRIPT(mob), read_trigger(rnum), -1);
         }
         trg_proto = trg_proto->next;
@@ -286,7 +288,7 @@ void assign_triggers(void *i, int type)
             trg_proto->vnum, obj_index[obj->item_number].vnum);
         } else {
           if (!SCRIPT(obj))
-            CREATE(SCRIPT(obj), struct script_data, 1);
+            SCRIPT(obj) = create_script(obj, OBJ_TRIGGER);
           add_trigger(SCRIPT(obj), read_trigger(rnum), -1);
         }
         trg_proto = trg_proto->next;
@@ -303,7 +305,7 @@ void assign_triggers(void *i, int type)
                  trg_proto->vnum, room->number);
         } else {
           if (!SCRIPT(room))
-            CREATE(SCRIPT(room), struct script_data, 1);
+            SCRIPT(room) = create_script(room, WLD_TRIGGER);
           add_trigger(SCRIPT(room), read_trigger(rnum), -1);
         }
         trg_proto = trg_proto->next;
@@ -25,6 +25,7 @@
 #include "constants.h"
 #include "comm.h"  /* For access to the game pulse */
 #include "mud_event.h"
+#include "slab.h"
 
 /***************************************************************************
  * Begin mud specific event queue functions
@@ -33,6 +34,15 @@
 /** The mud specific queue of events. */
 static struct dg_queue *event_q;
 
+/* Events and queue elements are created and cancelled constantly (cooldowns,
+ * script waits), so both come from slabs (slab.c) rather than calloc/free. */
+
+/* Local functions */
+static int queue_before(struct q_element *a, struct q_element *b);
+static void queue_place(struct dg_queue *q, struct q_element *qe, int i);
+static void queue_sift_up(struct dg_queue *q, int i);
+static void queue_sift_down(struct dg_queue *q, int i);
+
 
 /** Initializes the main event queue event_q.
  * @post The main event queue, event_q, has been created and initialized.
@@ -61,7 +71,7 @@ struct event *event_create(EVENTFUNC(*func), void *event_obj, long when)
   if (when < 1) /* make sure its in the future */
     when = 1;
 
-  CREATE(new_event, struct event, 1);
+  new_event = slab_alloc(&event_slab);
   new_event->func = func;
   new_event->event_obj = event_obj;
   new_event->q_el = queue_enq(event_q, new_event, when + pulse);
@@ -88,7 +98,7 @@ void event_cancel(struct event *event)
   if (event->event_obj)
       cleanup_event_obj(event);
 
-  free(event);
+  slab_free(&event_slab, event);
 }
 
 /* The memory freeing routine tied into the mud event system */
@@ -130,7 +140,7 @@ void event_process(void)
       if (the_event->isMudEvent && the_event->event_obj != NULL)
         free_mud_event((struct mud_event_data *) the_event->event_obj);
       /* It is assumed that the_event will already have freed ->event_obj. */
-      free(the_event);
+      slab_free(&event_slab, the_event);
     }
       
   }
@@ -151,7 +161,9 @@ long event_time(struct event *event)
 /** Frees all events from event_q. */
 void event_free_all(void)
 {
-  queue_free(event_q);
+  if (event_q)
+    queue_free(event_q);
+  event_q = NULL;
 }
 
 /** Boolean function to tell whether an event is queued or not. Does this by
@@ -179,10 +191,76 @@ struct dg_queue *queue_init(void)
   struct dg_queue *q;
 
   CREATE(q, struct dg_queue, 1);
+  q->max = EVENT_QUEUE_START;
+  CREATE(q->heap, struct q_element *, q->max);
 
   return q;
 }
 
+/** Heap ordering: earlier keys first. Among equal keys the most recently
+ * queued element comes first, which is the order the old bucketed lists
+ * fired them in.
+ * @retval int TRUE if a belongs closer to the head of the queue than b. */
+static int queue_before(struct q_element *a, struct q_element *b)
+{
+  if (a->key != b->key)
+    return a->key < b->key;
+
+  return a->seq > b->seq;
+}
+
+/** Stores qe in heap slot i and records the slot in qe. */
+static void queue_place(struct dg_queue *q, struct q_element *qe, int i)
+{
+  q->heap[i] = qe;
+  qe->index = i;
+}
+
+/** Moves the element in slot i towards the head until its parent is earlier.
+ */
+static void queue_sift_up(struct dg_queue *q, int i)
+{
+  struct q_element *qe = q->heap[i];
+  int parent;
+
+  while (i > 0) {
+    parent = (i - 1) / EVENT_HEAP_ARITY;
+    if (!queue_before(qe, q->heap[parent]))
+      break;
+    queue_place(q, q->heap[parent], i);
+    i = parent;
+  }
+
+  queue_place(q, qe, i);
+}
+
+/** Moves the element in slot i away from the head until all its children
+ * are later. */
+static void queue_sift_down(struct dg_queue *q, int i)
+{
+  struct q_element *qe = q->heap[i];
+  int child, first, last, best;
+
+  for (;;) {
+    first = i * EVENT_HEAP_ARITY + 1;
+    if (first >= q->size)
+      break;
+
+    last = MIN(first + EVENT_HEAP_ARITY, q->size);
+    for (best = first, child = first + 1; child < last; child++)
+      if (queue_before(q->heap[child], q->heap[best]))
+        best = child;
+
+    if (!queue_before(q->heap[best], qe))
+      break;
+
+    queue_place(q, q->heap[best], i);
+    i = best;
+  }
+
+  queue_place(q, qe, i);
+}
+
 /** Add some 'data' to a priority queue. 
  * @pre The paremeter q must have been previously created by queue_init.
  * @post A new q_element is created to hold the data parameter.
@@ -195,43 +273,20 @@ struct dg_queue *queue_init(void)
  * the data. */
 struct q_element *queue_enq(struct dg_queue *q, void *data, long key)
 {
-  struct q_element *qe, *i;
-  int bucket;
+  struct q_element *qe;
 
-  CREATE(qe, struct q_element, 1);
+  qe = slab_alloc(&q_element_slab);
   qe->data = data;
   qe->key = key;
+  qe->seq = q->seq++;
 
-  bucket = key % NUM_EVENT_QUEUES;   /* which queue does this go in */
-
-  if (!q->head[bucket]) { /* queue is empty */
-    q->head[bucket] = qe;
-    q->tail[bucket] = qe;
+  if (q->size == q->max) {
+    q->max *= 2;
+    RECREATE(q->heap, struct q_element *, q->max);
   }
 
-  else {
-    for (i = q->tail[bucket]; i; i = i->prev) {
-
-      if (i->key < key) { /* found insertion point */
-	if (i == q->tail[bucket])
-	  q->tail[bucket] = qe;
-	else {
-	  qe->next = i->next;
-	  i->next->prev = qe;
-	}
-
-	qe->prev = i;
-	i->next = qe;
-	break;
-      }
-    }
-
-    if (i == NULL) { /* insertion point is front of list */
-      qe->next = q->head[bucket];
-      q->head[bucket] = qe;
-      qe->next->prev = qe;
-    }
-  }
+  queue_place(q, qe, q->size++);
+  queue_sift_up(q, qe->index);
 
   return qe;
 }
@@ -244,61 +299,51 @@ struct q_element *queue_enq(struct dg_queue *q, void *data, long key)
  */
 void queue_deq(struct dg_queue *q, struct q_element *qe)
 {
+  struct q_element *last;
   int i;
 
   assert(qe);
 
-  i = qe->key % NUM_EVENT_QUEUES;
+  i = qe->index;
+  last = q->heap[--q->size];
 
-  if (qe->prev == NULL)
-    q->head[i] = qe->next;
-  else
-    qe->prev->next = qe->next;
-
-  if (qe->next == NULL)
-    q->tail[i] = qe->prev;
-  else
-    qe->next->prev = qe->prev;
+  /* Fill the hole with the last element and restore the heap around it. */
+  if (last != qe) {
+    queue_place(q, last, i);
+    if (i > 0 && queue_before(last, q->heap[(i - 1) / EVENT_HEAP_ARITY]))
+      queue_sift_up(q, i);
+    else
+      queue_sift_down(q, i);
+  }
 
-  free(qe);
+  slab_free(&q_element_slab, qe);
 }
 
 /** Removes and returns the data of the first element of the priority queue q. 
- * @pre pulse must be defined. This is a multi-headed queue, the current
- * head is determined by the current pulse.
  * @post the q->head is dequeued. 
  * @param q The queue to return the head of.
- * @retval void * NULL if there is not a currently available head, pointer
- * to any data object associated with the queue element. */
+ * @retval void * NULL if the queue is empty, pointer to any data object
+ * associated with the queue element. */
 void *queue_head(struct dg_queue *q)
 {
   void *dg_data;
-  int i;
 
-  i = pulse % NUM_EVENT_QUEUES;
-
-  if (!q->head[i])
+  if (!q->size)
     return NULL;
 
-  dg_data = q->head[i]->data;
-  queue_deq(q, q->head[i]);
+  dg_data = q->heap[0]->data;
+  queue_deq(q, q->heap[0]);
   return dg_data;
 }
 
 /** Returns the key of the head element of the priority queue.
- * @pre pulse must be defined. This is a multi-headed queue, the current
- * head is determined by the current pulse. 
  * @param q Queue to check for.
- * @retval long Return the key element of the head q_element. If no head
- * q_element is available, return LONG_MAX. */
+ * @retval long Return the key element of the head q_element. If the queue
+ * is empty, return LONG_MAX. */
 long queue_key(struct dg_queue *q)
 {
-  int i;
-
-  i = pulse % NUM_EVENT_QUEUES;
-
-  if (q->head[i])
-    return q->head[i]->key;
+  if (q->size)
+    return q->heap[0]->key;
   else
     return LONG_MAX;
 }
@@ -319,25 +364,18 @@ long queue_elmt_key(struct q_element *qe)
 void queue_free(struct dg_queue *q)
 {
   int i;
-  struct q_element *qe, *next_qe;
   struct event *event;
 
-  for (i = 0; i < NUM_EVENT_QUEUES; i++)
-  {
-    for (qe = q->head[i]; qe; qe = next_qe) 
-    {
-      next_qe = qe->next;
-      if ((event = (struct event *) qe->data) != NULL) 
-      {
-        if (event->event_obj)
-          cleanup_event_obj(event);
-
-        free(event);
-      }
-      free(qe);
+  for (i = 0; i < q->size; i++) {
+    if ((event = (struct event *) q->heap[i]->data) != NULL) {
+      if (event->event_obj)
+        cleanup_event_obj(event);
+
+      slab_free(&event_slab, event);
     }
+    slab_free(&q_element_slab, q->heap[i]);
   }
 
+  free(q->heap);
   free(q);
 }
-
@@ -42,20 +42,27 @@ struct event {
 /**************************************************************************
  * Begin priority queue structures and defines.
  **************************************************************************/
-/** Number of buckets available in each queue. Reduces enqueue cost. */
-#define NUM_EVENT_QUEUES    10
+/** Children per node of the queue's heap. A 4-ary heap is shallower than a
+ * binary one and keeps siblings in the same cache line. */
+#define EVENT_HEAP_ARITY    4
 
-/** The priority queue. */
+/** A new queue's heap has room for this many elements before it grows. */
+#define EVENT_QUEUE_START   256
+
+/** The priority queue: a d-ary min-heap of q_elements ordered by key. */
 struct dg_queue {
-  struct q_element *head[NUM_EVENT_QUEUES]; /**< Front of each queue bucket. */
-  struct q_element *tail[NUM_EVENT_QUEUES]; /**< Rear of each queue bucket. */
+  struct q_element **heap; /**< Heap array, earliest element first. */
+  int size;                /**< Number of elements in the heap. */
+  int max;                 /**< Allocated length of the heap array. */
+  unsigned long seq;       /**< Enqueue counter used to order equal keys. */
 };
 
 /** Queued elements. */
 struct q_element {
   void *data;  /**< The event to be handled. */
   long key;    /**< When the event should be handled. */
-  struct q_element *prev, *next; /**< Points to other q_elements in line. */
+  unsigned long seq; /**< Enqueue order; later elements fire first on ties. */
+  int index;   /**< Position in the heap, so removal is O(log n). */
 };
 /**************************************************************************
  * End priority queue structures and defines.
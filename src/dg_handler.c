@@ -23,6 +23,7 @@
 #include "spells.h"
 #include "dg_event.h"
 #include "constants.h"
+#include "slab.h"
 
 /* frees memory associated with var */
 void free_var_el(struct trig_var_data *var)
@@ -50,8 +51,9 @@ void free_varlist(struct trig_var_data *vd)
 int remove_var(struct trig_var_data **var_list, char *name)
 {
   struct trig_var_data *i, *j;
+  unsigned long hash = var_hash(name);
 
-  for (j = NULL, i = *var_list; i && str_cmp(name, i->name);
+  for (j = NULL, i = *var_list; i && (i->hash != hash || str_cmp(name, i->name));
        j = i, i = i->next);
 
   if (i) {
@@ -87,7 +89,7 @@ void free_trigger(struct trig_data *trig)
     if (GET_TRIG_WAIT(trig))
       event_cancel(GET_TRIG_WAIT(trig));
 
-    free(trig);
+    slab_free(&trig_slab, trig);
 }
 
 /* remove a single trigger from a mob/obj/room */
@@ -147,7 +149,7 @@ void extract_script(void *thing, int type)
       for ( ; j ; j = j->next)
         assert(sc != SCRIPT(j));
 
-      for (k = 0; k < top_of_world; k++)
+      for (k = 0; k <= top_of_world; k++)
         assert(sc != SCRIPT(&world[k]));
     }
   }
@@ -158,6 +160,10 @@ void extract_script(void *thing, int type)
   }
   TRIGGERS(sc) = NULL;
 
+  /* Drop it from the random and time trigger registries. */
+  SCRIPT_TYPES(sc) = 0;
+  update_script_registries(sc);
+
   /* Thanks to James Long for tracking down this memory leak */
   free_varlist(sc->global_vars);
 
@@ -212,7 +218,7 @@ void free_proto_script(void *thing, int type)
       for ( ; j ; j = j->next)
         assert(proto != j->proto_script);
 
-      for (k = 0; k < top_of_world; k++)
+      for (k = 0; k <= top_of_world; k++)
         assert(proto != world[k].proto_script);
     }
   }
@@ -22,6 +22,8 @@
 #include "genzon.h" /* for real_zone_by_thing */
 #include "act.h"
 #include "fight.h"
+#include "strpool.h"
+#include "graph.h"
 
 
 /* Local file scope functions. */
@@ -175,7 +177,7 @@ ACMD(do_mjunk)
     } else {
         for (obj = ch->carrying; obj != NULL; obj = obj_next) {
             obj_next = obj->next_content;
-            if (arg[3] == '\0' || isname(arg+4, obj->name)) {
+            if (arg[3] == '\0' || isname_obj(arg+4, obj)) {
                 extract_obj(obj);
             }
         }
@@ -1039,14 +1041,15 @@ ACMD(do_mdoor)
     }
 
     newexit = rm->dir_option[dir];
+    invalidate_paths();
 
     /* purge exit */
     if (fd == 0) {
         if (newexit) {
             if (newexit->general_description)
-                free(newexit->general_description);
+                str_release(newexit->general_description);
             if (newexit->keyword)
-                free(newexit->keyword);
+                str_release(newexit->keyword);
             free(newexit);
             rm->dir_option[dir] = NULL;
         }
@@ -1061,7 +1064,7 @@ ACMD(do_mdoor)
         switch (fd) {
         case 1:  /* description */
             if (newexit->general_description)
-                free(newexit->general_description);
+                str_release(newexit->general_description);
             CREATE(newexit->general_description, char, strlen(value) + 3);
             strcpy(newexit->general_description, value);
             strcat(newexit->general_description, "\r\n");
@@ -1074,7 +1077,7 @@ ACMD(do_mdoor)
             break;
         case 4:  /* name        */
             if (newexit->keyword)
-                free(newexit->keyword);
+                str_release(newexit->keyword);
             CREATE(newexit->keyword, char, strlen(value) + 1);
             strcpy(newexit->keyword, value);
             break;
@@ -20,6 +20,8 @@
 #include "constants.h"
 #include "genzon.h" /* for access to real_zone_by_thing */
 #include "fight.h" /* for die() */
+#include "strpool.h"
+#include "graph.h"
 
 
 
@@ -291,7 +293,7 @@ static OCMD(do_otimer)
   else if (!isdigit(*arg))
     obj_log(obj, "otimer: bad argument");
   else
-    GET_OBJ_TIMER(obj) = atoi(arg);
+    set_obj_timer(obj, atoi(arg));
 }
 
 /* Transform into a different object. Note: this shouldn't be used with 
@@ -323,6 +325,8 @@ static OCMD(do_otransform)
     }
 
     /* move new obj info over to old object and delete new obj */
+    clear_obj_timer(obj);
+    clear_obj_timer(o);
     memcpy(&tmpobj, o, sizeof(*o));
     tmpobj.in_room = IN_ROOM(obj);
     tmpobj.carried_by = obj->carried_by;
@@ -336,6 +340,7 @@ static OCMD(do_otransform)
     tmpobj.next_content = obj->next_content;
     tmpobj.next = obj->next;
     memcpy(obj, &tmpobj, sizeof(*obj));
+    set_obj_timer(obj, GET_OBJ_TIMER(obj));
 
     if (wearer) {
       equip_char(wearer, obj, pos);
@@ -640,14 +645,15 @@ static OCMD(do_odoor)
     }
 
     newexit = rm->dir_option[dir];
+    invalidate_paths();
 
     /* purge exit */
     if (fd == 0) {
         if (newexit) {
             if (newexit->general_description)
-                free(newexit->general_description);
+                str_release(newexit->general_description);
             if (newexit->keyword)
-                free(newexit->keyword);
+                str_release(newexit->keyword);
             free(newexit);
             rm->dir_option[dir] = NULL;
         }
@@ -662,7 +668,7 @@ static OCMD(do_odoor)
         switch (fd) {
         case 1:  /* description */
             if (newexit->general_description)
-                free(newexit->general_description);
+                str_release(newexit->general_description);
             CREATE(newexit->general_description, char, strlen(value) + 3);
             strcpy(newexit->general_description, value);
             strcat(newexit->general_description, "\r\n"); /* strcat : OK */
@@ -675,7 +681,7 @@ static OCMD(do_odoor)
             break;
         case 4:  /* name        */
             if (newexit->keyword)
-                free(newexit->keyword);
+                str_release(newexit->keyword);
             CREATE(newexit->keyword, char, strlen(value) + 1);
             strcpy(newexit->keyword, value);
             break;
@@ -21,6 +21,7 @@
 #include "genzon.h"      /* for real_zone_by_thing */
 #include "constants.h"   /* for the *trig_types */
 #include "modify.h"      /* for smash_tilde */
+#include "slab.h"
 
 
 /* local functions */
@@ -137,7 +138,7 @@ static void trigedit_setup_new(struct descriptor_data *d)
   struct trig_data *trig;
 
   /* Allocate a scratch trigger structure. */
-  CREATE(trig, struct trig_data, 1);
+  trig = slab_alloc(&trig_slab);
 
   trig->nr = NOWHERE;
 
@@ -160,7 +161,7 @@ void trigedit_setup_existing(struct descriptor_data *d, int rtrg_num)
   struct trig_data *trig;
   struct cmdlist_element *c;
   /* Allocate a scratch trigger structure. */
-  CREATE(trig, struct trig_data, 1);
+  trig = slab_alloc(&trig_slab);
 
   trig_data_copy(trig, trig_index[rtrg_num]->proto);
 
@@ -669,6 +670,8 @@ void trigedit_save(struct descriptor_data *d)
     } else
       trig->cmdlist->cmd = strdup("* No Script");
 
+    compile_trigger(trig);
+
     /* make the prorotype look like what we have */
     trig_data_copy(proto, trig);
 
@@ -735,6 +738,8 @@ void trigedit_save(struct descriptor_data *d)
     } else
       trig->cmdlist->cmd = strdup("* No Script");
 
+    compile_trigger(trig);
+
     for (i = 0; i < top_of_trigt; i++) {
       if (!found) {
         if (trig_index[i]->vnum > OLC_NUM(d)) {
@@ -746,7 +751,7 @@ void trigedit_save(struct descriptor_data *d)
           new_index[rnum]->vnum = OLC_NUM(d);
           new_index[rnum]->number = 0;
           new_index[rnum]->func = NULL;
-          CREATE(proto, struct trig_data, 1);
+          proto = slab_alloc(&trig_slab);
           new_index[rnum]->proto = proto;
           trig_data_copy(proto, trig);
 
@@ -772,7 +777,7 @@ void trigedit_save(struct descriptor_data *d)
       new_index[rnum]->number = 0;
       new_index[rnum]->func = NULL;
 
-      CREATE(proto, struct trig_data, 1);
+      proto = slab_alloc(&trig_slab);
       new_index[rnum]->proto = proto;
       trig_data_copy(proto, trig);
     }
@@ -70,11 +70,49 @@ static void extract_value(struct script_data *sc, trig_data *trig, char *cmd);
 static void dg_letter_value(struct script_data *sc, trig_data *trig, char *cmd);
 static struct cmdlist_element * find_case(struct trig_data *trig, struct cmdlist_element *cl,
           void *go, struct script_data *sc, int type, char *cond);
-static struct cmdlist_element *find_done(struct cmdlist_element *cl);
+static int line_op(char *p);
+static int command_op(char *cmd);
+static struct cmdlist_element *scan_end(struct cmdlist_element *cl, byte *err);
+static struct cmdlist_element *scan_else(struct cmdlist_element *cl, byte *err,
+          byte *how);
+static struct cmdlist_element *scan_case(struct cmdlist_element *cl, byte *how);
+static struct cmdlist_element *scan_done(struct cmdlist_element *cl);
+static int line_number(struct cmdlist_element *list, struct cmdlist_element *c);
 static struct char_data *find_char_by_uid_in_lookup_table(long uid);
 static struct obj_data *find_obj_by_uid_in_lookup_table(long uid);
 static EVENTFUNC(trig_wait_event);
 
+/* The names of the script commands script_driver() runs itself, by TCMD_
+ * number, in the order they are tried. */
+static const char *script_commands[] = {
+  "",
+  "eval ",
+  "nop ",
+  "extract ",
+  "dg_letter ",
+  "makeuid ",
+  "halt",
+  "dg_cast ",
+  "dg_affect ",
+  "global ",
+  "context ",
+  "remote ",
+  "rdelete ",
+  "return ",
+  "set ",
+  "unset ",
+  "wait ",
+  "attach ",
+  "detach ",
+  "\n"
+};
+
+/* The TOP_ kinds of line, for tstat. */
+static const char *line_ops[] = {
+  "?", "*", "if", "elseif", "else", "while", "switch", "end", "done", "break",
+  "case", "command"
+};
+
 
 /* Return pointer to first occurrence of string ct in cs, or NULL if not 
  * present.  Case insensitive. All of ct must be found in cs for it to be 
@@ -156,7 +194,7 @@ obj_data *get_obj_in_list(char *name, obj_data *list)
       
     } else {
       for (i = list; i; i = i->next_content)
-        if (isname(name, i->name))
+        if (isname_obj(name, i))
           return i;
     }
 
@@ -198,7 +236,7 @@ obj_data *get_object_in_equip(char_data * ch, char *name)
 
     for (j = 0; (j < NUM_WEARS) && (n <= number); j++)
       if ((obj = GET_EQ(ch, j)))
-        if (isname(tmp, obj->name))
+        if (isname_obj(tmp, obj))
           if (++n == number)
             return (obj);
   }
@@ -345,7 +383,7 @@ char_data *get_char(char *name)
       return i;
   } else {
     for (i = character_list; i; i = i->next)
-      if (isname(name, i->player.name) &&
+      if (isname_char(name, i) &&
           valid_dg_target(i, DG_ALLOW_GODS))
         return i;
   }
@@ -375,7 +413,7 @@ char_data *get_char_near_obj(obj_data *obj, char *name)
     room_rnum num;
     if ((num = obj_room(obj)) != NOWHERE)
       for (ch = world[num].people; ch; ch = ch->next_in_room)
-        if (isname(name, ch->player.name) &&
+        if (isname_char(name, ch) &&
             valid_dg_target(ch, DG_ALLOW_GODS))
           return ch;
   }
@@ -404,7 +442,7 @@ char_data *get_char_in_room(room_data *room, char *name)
       return ch;
   } else {
     for (ch = room->people; ch; ch = ch->next_in_room)
-      if (isname(name, ch->player.name) &&
+      if (isname_char(name, ch) &&
           valid_dg_target(ch, DG_ALLOW_GODS))
         return ch;
     }
@@ -440,7 +478,7 @@ obj_data *get_obj_near_obj(obj_data *obj, char *name)
 
       if (id == obj->in_obj->script_id)
         return obj->in_obj;
-    } else if (isname(name, obj->in_obj->name))
+    } else if (isname_obj(name, obj->in_obj))
       return obj->in_obj;
   }
   /* or worn ?*/
@@ -472,7 +510,7 @@ obj_data *get_obj(char *name)
     return find_obj(atoi(name + 1));
   else {
     for (obj = object_list; obj; obj = obj->next)
-      if (isname(name, obj->name))
+      if (isname_obj(name, obj))
         return obj;
   }
 
@@ -505,17 +543,17 @@ char_data *get_char_by_obj(obj_data *obj, char *name)
       return ch;
   } else {
     if (obj->carried_by &&
-        isname(name, obj->carried_by->player.name) &&
+        isname_char(name, obj->carried_by) &&
         valid_dg_target(obj->carried_by, DG_ALLOW_GODS))
       return obj->carried_by;
 
     if (obj->worn_by &&
-        isname(name, obj->worn_by->player.name) &&
+        isname_char(name, obj->worn_by) &&
         valid_dg_target(obj->worn_by, DG_ALLOW_GODS))
       return obj->worn_by;
 
     for (ch = character_list; ch; ch = ch->next)
-      if (isname(name, ch->player.name) &&
+      if (isname_char(name, ch) &&
           valid_dg_target(ch, DG_ALLOW_GODS))
         return ch;
   }
@@ -536,12 +574,12 @@ char_data *get_char_by_room(room_data *room, char *name)
       return ch;
   } else {
     for (ch = room->people; ch; ch = ch->next_in_room)
-      if (isname(name, ch->player.name) &&
+      if (isname_char(name, ch) &&
           valid_dg_target(ch, DG_ALLOW_GODS))
         return ch;
 
     for (ch = character_list; ch; ch = ch->next)
-      if (isname(name, ch->player.name) &&
+      if (isname_char(name, ch) &&
           valid_dg_target(ch, DG_ALLOW_GODS))
         return ch;
   }
@@ -565,7 +603,7 @@ obj_data *get_obj_by_obj(obj_data *obj, char *name)
   if (obj->contains && (i = get_obj_in_list(name, obj->contains)))
     return i;
 
-  if (obj->in_obj && isname(name, obj->in_obj->name))
+  if (obj->in_obj && isname_obj(name, obj->in_obj))
       return obj->in_obj;
 
   if (obj->worn_by && (i = get_object_in_equip(obj->worn_by, name)))
@@ -595,7 +633,7 @@ obj_data *get_obj_in_room(room_data *room, char *name)
               return obj;
   } else {
       for (obj = room->contents; obj; obj = obj->next_content)
-          if (isname(name, obj->name))
+          if (isname_obj(name, obj))
               return obj;
   }
 
@@ -611,97 +649,119 @@ obj_data *get_obj_by_room(room_data *room, char *name)
     return find_obj(atoi(name+1));
 
   for (obj = room->contents; obj; obj = obj->next_content)
-    if (isname(name, obj->name))
+    if (isname_obj(name, obj))
       return obj;
 
   for (obj = object_list; obj; obj = obj->next)
-    if (isname(name, obj->name))
+    if (isname_obj(name, obj))
       return obj;
 
   return NULL;
 }
 
-/* checks every PULSE_SCRIPT for random triggers */
-void script_trigger_check(void)
-{
-  char_data *ch;
-  obj_data *obj;
-  struct room_data *room=NULL;
-  room_rnum nr;
-  struct script_data *sc;
-
-  for (ch = character_list; ch; ch = ch->next) {
-    if (SCRIPT(ch)) {
-      sc = SCRIPT(ch);
-
-      if (IS_SET(SCRIPT_TYPES(sc), WTRIG_RANDOM) &&
-          (!is_empty(world[IN_ROOM(ch)].zone) ||
-           IS_SET(SCRIPT_TYPES(sc), WTRIG_GLOBAL)))
-        random_mtrigger(ch);
-    }
-  }
-
-  for (obj = object_list; obj; obj = obj->next) {
-    if (SCRIPT(obj)) {
-      sc = SCRIPT(obj);
+/* Scripts holding random or time triggers, one list per registry and owner
+ * type, so the periodic passes only visit scripts that can fire. */
+static struct script_data *script_registry[NUM_SCRIPT_REGISTRIES][3];
+/* The next script each registry pass will visit.  Unregistering that script
+ * moves it on, since a trigger may purge any other mob, object or room. */
+static struct script_data *next_registered[NUM_SCRIPT_REGISTRIES];
+/* The trigger type bit each registry collects; the mob, obj and room bits
+ * share a value. */
+static const long registry_bits[NUM_SCRIPT_REGISTRIES] = {
+  MTRIG_RANDOM, MTRIG_TIME
+};
 
-      if (IS_SET(SCRIPT_TYPES(sc), OTRIG_RANDOM))
-        random_otrigger(obj);
-    }
-  }
+/* Puts sc into or takes it out of each registry to match its trigger types.
+ * Call whenever SCRIPT_TYPES(sc) changes. */
+void update_script_registries(struct script_data *sc)
+{
+  struct script_data **head;
+  int reg, bit;
 
-  for (nr = 0; nr <= top_of_world; nr++) {
-    if (SCRIPT(&world[nr])) {
-      room = &world[nr];
-      sc = SCRIPT(room);
+  for (reg = 0; reg < NUM_SCRIPT_REGISTRIES; reg++) {
+    bit = 1 << reg;
+    head = &script_registry[reg][sc->owner_type];
 
-      if (IS_SET(SCRIPT_TYPES(sc), WTRIG_RANDOM) &&
-          (!is_empty(room->zone) ||
-           IS_SET(SCRIPT_TYPES(sc), WTRIG_GLOBAL)))
-        random_wtrigger(room);
+    if (IS_SET(SCRIPT_TYPES(sc), registry_bits[reg])) {
+      if (IS_SET(sc->registered, bit))
+        continue;
+      sc->reg_prev[reg] = NULL;
+      sc->reg_next[reg] = *head;
+      if (*head)
+        (*head)->reg_prev[reg] = sc;
+      *head = sc;
+      SET_BIT(sc->registered, bit);
+    } else if (IS_SET(sc->registered, bit)) {
+      if (next_registered[reg] == sc)
+        next_registered[reg] = sc->reg_next[reg];
+      if (sc->reg_prev[reg])
+        sc->reg_prev[reg]->reg_next[reg] = sc->reg_next[reg];
+      else
+        *head = sc->reg_next[reg];
+      if (sc->reg_next[reg])
+        sc->reg_next[reg]->reg_prev[reg] = sc->reg_prev[reg];
+      sc->reg_next[reg] = sc->reg_prev[reg] = NULL;
+      REMOVE_BIT(sc->registered, bit);
     }
   }
 }
 
-void check_time_triggers(void)
+/* Fires the random or time trigger of every script in registry reg, skipping
+ * mobs and rooms in zones without players unless the script is global. */
+static void run_registered_triggers(int reg)
 {
-  char_data *ch;
-  obj_data *obj;
-  struct room_data *room=NULL;
-  int nr;
   struct script_data *sc;
+  char_data *ch;
+  room_rnum nr;
 
-  for (ch = character_list; ch; ch = ch->next) {
-    if (SCRIPT(ch)) {
-      sc = SCRIPT(ch);
+  for (sc = script_registry[reg][MOB_TRIGGER]; sc; sc = next_registered[reg]) {
+    next_registered[reg] = sc->reg_next[reg];
+    ch = (char_data *) sc->owner;
 
-      if (IS_SET(SCRIPT_TYPES(sc), WTRIG_TIME) &&
-          (!is_empty(world[IN_ROOM(ch)].zone) ||
-           IS_SET(SCRIPT_TYPES(sc), WTRIG_GLOBAL)))
+    /* Players at the menu are loaded but not yet in the world. */
+    if (IN_ROOM(ch) == NOWHERE)
+      continue;
+    if (zone_table[world[IN_ROOM(ch)].zone].players ||
+        IS_SET(SCRIPT_TYPES(sc), WTRIG_GLOBAL)) {
+      if (reg == SREG_RANDOM)
+        random_mtrigger(ch);
+      else
         time_mtrigger(ch);
     }
   }
 
-  for (obj = object_list; obj; obj = obj->next) {
-    if (SCRIPT(obj)) {
-      sc = SCRIPT(obj);
+  for (sc = script_registry[reg][OBJ_TRIGGER]; sc; sc = next_registered[reg]) {
+    next_registered[reg] = sc->reg_next[reg];
+    if (reg == SREG_RANDOM)
+      random_otrigger((obj_data *) sc->owner);
+    else
+      time_otrigger((obj_data *) sc->owner);
+  }
 
-      if (IS_SET(SCRIPT_TYPES(sc), OTRIG_TIME))
-        time_otrigger(obj);
+  for (sc = script_registry[reg][WLD_TRIGGER]; sc; sc = next_registered[reg]) {
+    next_registered[reg] = sc->reg_next[reg];
+    if ((nr = real_room(sc->owner_room)) == NOWHERE)
+      continue;
+    if (zone_table[world[nr].zone].players ||
+        IS_SET(SCRIPT_TYPES(sc), WTRIG_GLOBAL)) {
+      if (reg == SREG_RANDOM)
+        random_wtrigger(&world[nr]);
+      else
+        time_wtrigger(&world[nr]);
     }
   }
+}
 
-  for (nr = 0; nr <= top_of_world; nr++) {
-    if (SCRIPT(&world[nr])) {
-      room = &world[nr];
-      sc = SCRIPT(room);
+/* checks every PULSE_SCRIPT for random triggers */
+void script_trigger_check(void)
+{
+  run_registered_triggers(SREG_RANDOM);
+}
 
-      if (IS_SET(SCRIPT_TYPES(sc), WTRIG_TIME) &&
-          (!is_empty(room->zone) ||
-           IS_SET(SCRIPT_TYPES(sc), WTRIG_GLOBAL)))
-        time_wtrigger(room);
-    }
-  }
+/* checks every mud hour for time triggers */
+void check_time_triggers(void)
+{
+  run_registered_triggers(SREG_TIME);
 }
 
 static EVENTFUNC(trig_wait_event)
@@ -733,7 +793,7 @@ static EVENTFUNC(trig_wait_event)
           found = TRUE;
     } else {
       room_rnum i;
-      for (i = 0;i<top_of_world && !found;i++)
+      for (i = 0;i<=top_of_world && !found;i++)
         if (&world[i] == (struct room_data *)go)
           found = TRUE;
     }
@@ -756,8 +816,8 @@ static EVENTFUNC(trig_wait_event)
 static void do_stat_trigger(struct char_data *ch, trig_data *trig)
 {
     struct cmdlist_element *cmd_list;
-    char sb[MAX_STRING_LENGTH], buf[MAX_STRING_LENGTH];
-    int len = 0;
+    char sb[MAX_STRING_LENGTH], buf[MAX_STRING_LENGTH], op[32], to[32];
+    int len = 0, n = 0;
 
     if (!trig)
     {
@@ -786,12 +846,35 @@ static void do_stat_trigger(struct char_data *ch, trig_data *trig)
                     ((GET_TRIG_ARG(trig) && *GET_TRIG_ARG(trig))
                      ? GET_TRIG_ARG(trig) : "None"));
 
+    /* Each line as compiled: what it is, and the line a branch, loop or
+     * switch goes on to ('/' the end of an if-block). A command marked % is
+     * only looked up once substituted. */
     len += snprintf(sb + len, sizeof(sb)-len, "Commands:\r\n");
 
     cmd_list = trig->cmdlist;
     while (cmd_list) {
+      n++;
+      if (cmd_list->op != TOP_COMMAND)
+        strlcpy(op, line_ops[cmd_list->op], sizeof(op));
+      else if (cmd_list->cmd_op == TCMD_SUBST)
+        strlcpy(op, "%", sizeof(op));
+      else if (cmd_list->cmd_op == TCMD_OTHER)
+        strlcpy(op, "command", sizeof(op));
+      else
+        snprintf(op, sizeof(op), "%.*s", (int)strcspn(script_commands[cmd_list->cmd_op], " "),
+                 script_commands[cmd_list->cmd_op]);
+
+      *to = '\0';
+      if (cmd_list->jump && cmd_list->end)
+        snprintf(to, sizeof(to), "%d/%d", line_number(trig->cmdlist, cmd_list->jump),
+                 line_number(trig->cmdlist, cmd_list->end));
+      else if (cmd_list->jump || cmd_list->end)
+        snprintf(to, sizeof(to), "%s%d", cmd_list->end ? "/" : "",
+                 line_number(trig->cmdlist, cmd_list->jump ? cmd_list->jump : cmd_list->end));
+
       if (cmd_list->cmd)
-        len += snprintf(sb + len, sizeof(sb)-len, "%s\r\n", cmd_list->cmd);
+        len += snprintf(sb + len, sizeof(sb)-len, "%s%3d%s %-9s %-7s %s\r\n",
+                        CCCYN(ch, C_NRM), n, CCNRM(ch, C_NRM), op, to, cmd_list->cmd);
 
       if (len>MAX_STRING_LENGTH-80) {
         snprintf(sb + len, sizeof(sb)-len, "*** Overflow - script too long! ***\r\n");
@@ -911,6 +994,23 @@ void do_sstat_character(char_data *ch, char_data *k)
   script_stat(ch, SCRIPT(k));
 }
 
+/* Allocates an empty script for thing, remembering its owner so the random
+ * and time trigger registries can find it again. */
+struct script_data *create_script(void *thing, int type)
+{
+  struct script_data *sc;
+
+  CREATE(sc, struct script_data, 1);
+  sc->owner_type = type;
+  sc->owner_room = NOWHERE;
+  if (type == WLD_TRIGGER)
+    sc->owner_room = ((room_data *) thing)->number;
+  else
+    sc->owner = thing;
+
+  return sc;
+}
+
 /* Adds the trigger t to script sc in in location loc.  loc = -1 means add to 
  * the end, loc = 0 means add before all other triggers. */
 void add_trigger(struct script_data *sc, trig_data *t, int loc)
@@ -931,6 +1031,7 @@ void add_trigger(struct script_data *sc, trig_data *t, int loc)
   }
 
   SCRIPT_TYPES(sc) |= GET_TRIG_TYPE(t);
+  update_script_registries(sc);
 
   t->next_in_world = trigger_list;
   trigger_list = t;
@@ -987,7 +1088,7 @@ ACMD(do_attach)
     }
 
     if (!SCRIPT(victim))
-      CREATE(SCRIPT(victim), struct script_data, 1);
+      SCRIPT(victim) = create_script(victim, MOB_TRIGGER);
     add_trigger(SCRIPT(victim), trig, loc);
 
     if (IS_NPC(victim))
@@ -1029,7 +1130,7 @@ ACMD(do_attach)
     }
 
     if (!SCRIPT(object))
-      CREATE(SCRIPT(object), struct script_data, 1);
+      SCRIPT(object) = create_script(object, OBJ_TRIGGER);
     add_trigger(SCRIPT(object), trig, loc);
 
     send_to_char(ch, "Trigger %d (%s) attached to %s [%d].\r\n",
@@ -1066,7 +1167,7 @@ ACMD(do_attach)
     room = &world[rnum];
 
     if (!SCRIPT(room))
-      CREATE(SCRIPT(room), struct script_data, 1);
+      SCRIPT(room) = create_script(room, WLD_TRIGGER);
     add_trigger(SCRIPT(room), trig, loc);
 
     send_to_char(ch, "Trigger %d (%s) attached to room %d.\r\n",
@@ -1134,6 +1235,7 @@ static int remove_trigger(struct script_data *sc, char *name)
     SCRIPT_TYPES(sc) = 0;
     for (i = TRIGGERS(sc); i; i = i->next)
       SCRIPT_TYPES(sc) |= GET_TRIG_TYPE(i);
+    update_script_registries(sc);
 
     return 1;
   } else
@@ -1607,82 +1709,40 @@ static int process_if(char *cond, void *go, struct script_data *sc,
     return 1;
 }
 
-/* Scans for end of if-block.  returns the line containg 'end', or the last
- * line of the trigger if not found. */
+/* Returns the 'end' of the if-block an else or elseif line is in, or the
+ * last line of the trigger if there is none. */
 static struct cmdlist_element *find_end(trig_data *trig, struct cmdlist_element *cl)
 {
-  struct cmdlist_element *c;
-  char *p;
-
-  if (!(cl->next)) { /* rryan: if this is the last line, theres no end */
-    script_log("Trigger VNum %d has 'if' without 'end'. (error 1)", GET_TRIG_VNUM(trig));
-    return cl;
-  }
-
-  for (c = cl->next; c; c = c->next) {
-    for (p = c->cmd; *p && isspace(*p); p++);
+  if (cl->end_err)
+    script_log("Trigger VNum %d has 'if' without 'end'. (error %d)",
+               GET_TRIG_VNUM(trig), cl->end_err);
 
-    if (!strn_cmp("if ", p, 3))
-      c = find_end(trig, c);
-    else if (!strn_cmp("end", p, 3))
-      return c;
-
-    /* thanks to Russell Ryan for this fix */
-    if(!c->next) { /* rryan: this is the last line, we didn't find an end. */
-      script_log("Trigger VNum %d has 'if' without 'end'. (error 2)", GET_TRIG_VNUM(trig));
-      return c;
-    }
-  }
-
-  /* rryan: we didn't find an end */
-  script_log("Trigger VNum %d has 'if' without 'end'. (error 3)", GET_TRIG_VNUM(trig));
-  return c;
+  return cl->end;
 }
 
-/* Searches for valid elseif, else, or end to continue execution at. Returns 
- * line of elseif, else, or end if found, or last line of trigger. */
+/* Follows an if's elseif, else and end lines, testing each elseif on the
+ * way. Returns the line of the elseif or else taken, or the end or last line
+ * of the trigger. */
 static struct cmdlist_element *find_else_end(trig_data *trig,
     struct cmdlist_element *cl, void *go, struct script_data *sc, int type)
 {
   struct cmdlist_element *c;
-  char *p;
-
-  if (!(cl->next))
-    return cl;
 
-  for (c = cl->next;c->next; c = c->next) {
-    for (p = c->cmd; *p && isspace(*p); p++); /* skip spaces */
+  for (;;) {
+    if (cl->err)
+      script_log("Trigger VNum %d has 'if' without 'end'. (error %d)",
+                 GET_TRIG_VNUM(trig), cl->err);
 
-    if (!strn_cmp("if ", p, 3))
-      c = find_end(trig, c);
-
-    else if (!strn_cmp("elseif ", p, 7)) {
-      if (process_if(p + 7, go, sc, trig, type)) {
-        GET_TRIG_DEPTH(trig)++;
-        return c;
-      }
-    }
-
-    else if (!strn_cmp("else", p, 4)) {
+    c = cl->jump;
+    if (cl->how == JUMP_ENTER ||
+        (cl->how == JUMP_TEST && process_if(c->cmd + c->arg, go, sc, trig, type))) {
       GET_TRIG_DEPTH(trig)++;
       return c;
     }
-
-    else if (!strn_cmp("end", p, 3))
-      return c;
-
-    /* thanks to Russell Ryan for this fix */
-    if(!c->next) { /* rryan: this is the last line, return. */
-      script_log("Trigger VNum %d has 'if' without 'end'. (error 4)", GET_TRIG_VNUM(trig));
+    if (cl->how != JUMP_TEST)
       return c;
-    }
+    cl = c;
   }
-
-  /* rryan: if we got here, it's the last line, if its not an end, log it. */
-  for (p = c->cmd; *p && isspace(*p); p++); /* skip spaces */
-  if(strn_cmp("end", p, 3))
-    script_log("Trigger VNum %d has 'if' without 'end'. (error 5)", GET_TRIG_VNUM(trig));
-  return c;
 }
 
 /* processes any 'wait' commands in a trigger */
@@ -1845,21 +1905,21 @@ static void process_attach(void *go, struct script_data *sc, trig_data *trig,
       return;
     }
     if (!SCRIPT(c))
-      CREATE(SCRIPT(c), struct script_data, 1);
+      SCRIPT(c) = create_script(c, MOB_TRIGGER);
     add_trigger(SCRIPT(c), newtrig, -1);
     return;
   }
 
   if (o) {
     if (!SCRIPT(o))
-      CREATE(SCRIPT(o), struct script_data, 1);
+      SCRIPT(o) = create_script(o, OBJ_TRIGGER);
     add_trigger(SCRIPT(o), newtrig, -1);
     return;
   }
 
   if (r) {
     if (!SCRIPT(r))
-      CREATE(SCRIPT(r), struct script_data, 1);
+      SCRIPT(r) = create_script(r, WLD_TRIGGER);
     add_trigger(SCRIPT(r), newtrig, -1);
     return;
   }
@@ -2107,6 +2167,7 @@ static void process_remote(struct script_data *sc, trig_data *trig, char *cmd)
   char *line, *var, *uid_p;
   char arg[MAX_INPUT_LENGTH], buf[MAX_INPUT_LENGTH], buf2[MAX_INPUT_LENGTH];
   long uid, context;
+  unsigned long hash;
   room_data *room;
   char_data *mob;
   obj_data *obj;
@@ -2126,13 +2187,14 @@ static void process_remote(struct script_data *sc, trig_data *trig, char *cmd)
   }
 
   /* find the locally owned variable */
+  hash = var_hash(var);
   for (vd = GET_TRIG_VARS(trig); vd; vd = vd->next)
-    if (!str_cmp(vd->name, buf))
+    if (vd->hash == hash && !str_cmp(vd->name, buf))
       break;
 
   if (!vd)
     for (vd = sc->global_vars; vd; vd = vd->next)
-      if (!str_cmp(vd->name, var) &&
+      if (vd->hash == hash && !str_cmp(vd->name, var) &&
           (vd->context==0 || vd->context==sc->context))
         break;
 
@@ -2272,7 +2334,7 @@ int perform_set_dg_var(struct char_data *ch, struct char_data *vict, char *val_a
     return 0;
   }
   if (!SCRIPT(vict))
-    CREATE(SCRIPT(vict), struct script_data, 1);
+    SCRIPT(vict) = create_script(vict, MOB_TRIGGER);
 
   add_var(&(SCRIPT(vict)->global_vars), var_name, var_value, 0);
   return 1;
@@ -2349,6 +2411,7 @@ static void process_rdelete(struct script_data *sc, trig_data *trig, char *cmd)
 static void process_global(struct script_data *sc, trig_data *trig, char *cmd, long id)
 {
   struct trig_var_data *vd;
+  unsigned long hash;
   char arg[MAX_INPUT_LENGTH], *var;
 
   var = any_one_arg(cmd, arg);
@@ -2361,8 +2424,9 @@ static void process_global(struct script_data *sc, trig_data *trig, char *cmd, l
     return;
   }
 
+  hash = var_hash(var);
   for (vd = GET_TRIG_VARS(trig); vd; vd = vd->next)
-    if (!str_cmp(vd->name, var))
+    if (vd->hash == hash && !str_cmp(vd->name, var))
       break;
 
   if (!vd) {
@@ -2481,7 +2545,7 @@ static void dg_letter_value(struct script_data *sc, trig_data *trig, char *cmd)
 int script_driver(void *go_adress, trig_data *trig, int type, int mode)
 {
   static int depth = 0;
-  int ret_val = 1;
+  int ret_val = 1, cmd_op;
   struct cmdlist_element *cl;
   char cmd[MAX_INPUT_LENGTH], *p;
   struct script_data *sc = 0;
@@ -2544,22 +2608,24 @@ int script_driver(void *go_adress, trig_data *trig, int type, int mode)
 
   dg_owner_purged = 0;
 
+  if (trig->cmdlist && trig->cmdlist->op == TOP_NONE)
+    compile_trigger(trig);
+
   for (cl = (mode == TRIG_NEW) ? trig->cmdlist : trig->curr_state;
       cl && GET_TRIG_DEPTH(trig); cl = cl->next) {
-    for (p = cl->cmd; *p && isspace(*p); p++);
+    p = cl->cmd + cl->arg;
 
-    if (*p == '*') /* comment */
+    if (cl->op == TOP_COMMENT)
       continue;
 
-    else if (!strn_cmp(p, "if ", 3)) {
-      if (process_if(p + 3, go, sc, trig, type))
+    else if (cl->op == TOP_IF) {
+      if (process_if(p, go, sc, trig, type))
         GET_TRIG_DEPTH(trig)++;
       else
         cl = find_else_end(trig, cl, go, sc, type);
     }
 
-    else if (!strn_cmp("elseif ", p, 7) ||
-       !strn_cmp("else", p, 4)) {
+    else if (cl->op == TOP_ELSEIF || cl->op == TOP_ELSE) {
       /* If not in an if-block, ignore the extra 'else[if]' and warn about it. */
       if (GET_TRIG_DEPTH(trig) == 1) {
         script_log("Trigger VNum %d has 'else' without 'if'.",
@@ -2568,22 +2634,24 @@ int script_driver(void *go_adress, trig_data *trig, int type, int mode)
       }
       cl = find_end(trig, cl);
       GET_TRIG_DEPTH(trig)--;
-    } else if (!strn_cmp("while ", p, 6)) {
-      temp = find_done(cl);
+    } else if (cl->op == TOP_WHILE) {
+      temp = cl->jump; /* its done */
       if (!temp) {
         script_log("Trigger VNum %d has 'while' without 'done'.",
                    GET_TRIG_VNUM(trig));
         return ret_val;
       }
-      if (process_if(p + 6, go, sc, trig, type)) {
+      if (process_if(p, go, sc, trig, type)) {
          temp->original = cl;
       } else {
          cl = temp;
          loops = 0;
       }
-    } else if (!strn_cmp("switch ", p, 7)) {
-      cl = find_case(trig, cl, go, sc, type, p + 7);
-    } else if (!strn_cmp("end", p, 3)) {
+    } else if (cl->op == TOP_SWITCH) {
+      /* No case found and no done: nothing more to run. */
+      if (!(cl = find_case(trig, cl, go, sc, type, p)))
+        break;
+    } else if (cl->op == TOP_END) {
       /* If not in an if-block, ignore the extra 'end' and warn about it. */
       if (GET_TRIG_DEPTH(trig) == 1) {
         script_log("Trigger VNum %d has 'end' without 'if'.",
@@ -2591,12 +2659,11 @@ int script_driver(void *go_adress, trig_data *trig, int type, int mode)
         continue;
       }
       GET_TRIG_DEPTH(trig)--;
-    } else if (!strn_cmp("done", p, 4)) {
+    } else if (cl->op == TOP_DONE) {
       /* if in a while loop, cl->original is non-NULL */
       if (cl->original) {
-      char *orig_cmd = cl->original->cmd;
-      while (*orig_cmd && isspace(*orig_cmd)) orig_cmd++;
-      if (cl->original && process_if(orig_cmd + 6, go, sc, trig,
+      char *orig_cmd = cl->original->cmd + cl->original->arg;
+      if (cl->original && process_if(orig_cmd, go, sc, trig,
           type)) {
         cl = cl->original;
         loops++;
@@ -2615,69 +2682,75 @@ int script_driver(void *go_adress, trig_data *trig, int type, int mode)
          /* if we're falling through a switch statement, this ends it. */
         }
       }
-    } else if (!strn_cmp("break", p, 5)) {
-      cl = find_done(cl);
-    } else if (!strn_cmp("case", p, 4)) {
+    } else if (cl->op == TOP_BREAK) {
+      if (!(cl = cl->jump)) /* the done, if there is one */
+        break;
+    } else if (cl->op == TOP_CASE) {
        /* Do nothing, this allows multiple cases to a single instance */
     }
 
     else {
-      var_subst(go, sc, trig, type, p, cmd);
+      /* A line with nothing to substitute was looked up when compiled. */
+      if ((cmd_op = cl->cmd_op) == TCMD_SUBST) {
+        var_subst(go, sc, trig, type, p, cmd);
+        cmd_op = command_op(cmd);
+      } else
+        strcpy(cmd, p);
 
-      if (!strn_cmp(cmd, "eval ", 5))
+      if (cmd_op == TCMD_EVAL)
         process_eval(go, sc, trig, type, cmd);
 
-      else if (!strn_cmp(cmd, "nop ", 4)); /* nop: do nothing */
+      else if (cmd_op == TCMD_NOP); /* nop: do nothing */
 
-      else if (!strn_cmp(cmd, "extract ", 8))
+      else if (cmd_op == TCMD_EXTRACT)
         extract_value(sc, trig, cmd);
 
-      else if (!strn_cmp(cmd, "dg_letter ", 10))
+      else if (cmd_op == TCMD_DG_LETTER)
         dg_letter_value(sc, trig, cmd);
 
-      else if (!strn_cmp(cmd, "makeuid ", 8))
+      else if (cmd_op == TCMD_MAKEUID)
         makeuid_var(go, sc, trig, type, cmd);
 
-      else if (!strn_cmp(cmd, "halt", 4))
+      else if (cmd_op == TCMD_HALT)
         break;
 
-      else if (!strn_cmp(cmd, "dg_cast ", 8))
+      else if (cmd_op == TCMD_DG_CAST)
         do_dg_cast(go, sc, trig, type, cmd);
 
-      else if (!strn_cmp(cmd, "dg_affect ", 10))
+      else if (cmd_op == TCMD_DG_AFFECT)
         do_dg_affect(go, sc, trig, type, cmd);
 
-      else if (!strn_cmp(cmd, "global ", 7))
+      else if (cmd_op == TCMD_GLOBAL)
         process_global(sc, trig, cmd, sc->context);
 
-      else if (!strn_cmp(cmd, "context ", 8))
+      else if (cmd_op == TCMD_CONTEXT)
         process_context(sc, trig, cmd);
 
-      else if (!strn_cmp(cmd, "remote ", 7))
+      else if (cmd_op == TCMD_REMOTE)
         process_remote(sc, trig, cmd);
 
-      else if (!strn_cmp(cmd, "rdelete ", 8))
+      else if (cmd_op == TCMD_RDELETE)
         process_rdelete(sc, trig, cmd);
 
-      else if (!strn_cmp(cmd, "return ", 7))
+      else if (cmd_op == TCMD_RETURN)
         ret_val = process_return(trig, cmd);
 
-      else if (!strn_cmp(cmd, "set ", 4))
+      else if (cmd_op == TCMD_SET)
         process_set(sc, trig, cmd);
 
-      else if (!strn_cmp(cmd, "unset ", 6))
+      else if (cmd_op == TCMD_UNSET)
         process_unset(sc, trig, cmd);
 
-      else if (!strn_cmp(cmd, "wait ", 5)) {
+      else if (cmd_op == TCMD_WAIT) {
         process_wait(go, trig, type, cmd, cl);
         depth--;
         return ret_val;
       }
 
-      else if (!strn_cmp(cmd, "attach ", 7))
+      else if (cmd_op == TCMD_ATTACH)
         process_attach(go, sc, trig, type, cmd);
 
-      else if (!strn_cmp(cmd, "detach ", 7))
+      else if (cmd_op == TCMD_DETACH)
         process_detach(go, sc, trig, type, cmd);
 
       else {
@@ -2760,34 +2833,172 @@ ACMD(do_tstat)
     send_to_char(ch, "Usage: tstat <vnum>\r\n");
 }
 
-/* Scans for a case/default instance. Returns the line containg the correct 
- * case instance, or the last line of the trigger if not found. */
+/* Follows a switch's case lines, testing each on the way. Returns the line
+ * of the case taken, or of the default or done, or the last line of the
+ * trigger. */
 static struct cmdlist_element *
 find_case(struct trig_data *trig, struct cmdlist_element *cl,
           void *go, struct script_data *sc, int type, char *cond)
 {
   char result[MAX_INPUT_LENGTH];
   struct cmdlist_element *c;
-  char *p, *buf;
+  char *buf;
 
   eval_expr(cond, result, go, sc, trig, type);
 
+  buf = (char*)malloc(MAX_STRING_LENGTH);
+  for (c = cl->jump; cl->how == JUMP_TEST; cl = c, c = c->jump) {
+    eval_op("==", result, c->cmd + c->arg, buf, go, sc, trig);
+    if (*buf && *buf!='0')
+      break;
+  }
+  free(buf);
+
+  return c;
+}
+
+/* The TOP_ kind of a line, p being its text after any leading spaces. */
+static int line_op(char *p)
+{
+  if (*p == '*')
+    return TOP_COMMENT;
+  if (!strn_cmp(p, "if ", 3))
+    return TOP_IF;
+  if (!strn_cmp("elseif ", p, 7))
+    return TOP_ELSEIF;
+  if (!strn_cmp("else", p, 4))
+    return TOP_ELSE;
+  if (!strn_cmp("while ", p, 6))
+    return TOP_WHILE;
+  if (!strn_cmp("switch ", p, 7))
+    return TOP_SWITCH;
+  if (!strn_cmp("end", p, 3))
+    return TOP_END;
+  if (!strn_cmp("done", p, 4))
+    return TOP_DONE;
+  if (!strn_cmp("break", p, 5))
+    return TOP_BREAK;
+  if (!strn_cmp("case", p, 4))
+    return TOP_CASE;
+  return TOP_COMMAND;
+}
+
+/* The TCMD_ number of a command line after substitution. */
+static int command_op(char *cmd)
+{
+  int i;
+
+  for (i = TCMD_EVAL; *script_commands[i] != '\n'; i++)
+    if (!strn_cmp(cmd, script_commands[i], strlen(script_commands[i])))
+      return i;
+
+  return TCMD_OTHER;
+}
+
+/* The scans below are the ones script_driver() used to make every time a
+ * branch was taken, and keep their rules: they look only at the first word
+ * of each line, and they stop at each elseif or case where the driver used
+ * to test it.  A nesting error found on the way is kept to be logged when a
+ * trigger takes that path, as it always was. */
+#define SCAN_ERR(err, n)  do { if (!*(err)) *(err) = (n); } while (0)
+
+/* Scans for end of if-block.  returns the line containg 'end', or the last
+ * line of the trigger if not found. */
+static struct cmdlist_element *scan_end(struct cmdlist_element *cl, byte *err)
+{
+  struct cmdlist_element *c;
+  char *p;
+
+  if (!(cl->next)) { /* rryan: if this is the last line, theres no end */
+    SCAN_ERR(err, 1);
+    return cl;
+  }
+
+  for (c = cl->next; c; c = c->next) {
+    for (p = c->cmd; *p && isspace(*p); p++);
+
+    if (!strn_cmp("if ", p, 3))
+      c = scan_end(c, err);
+    else if (!strn_cmp("end", p, 3))
+      return c;
+
+    /* thanks to Russell Ryan for this fix */
+    if(!c->next) { /* rryan: this is the last line, we didn't find an end. */
+      SCAN_ERR(err, 2);
+      return c;
+    }
+  }
+
+  /* rryan: we didn't find an end */
+  SCAN_ERR(err, 3);
+  return c;
+}
+
+/* Scans for the next elseif, else or end at the level of an if or elseif.
+ * Returns that line, or the last line of the trigger. */
+static struct cmdlist_element *scan_else(struct cmdlist_element *cl, byte *err,
+    byte *how)
+{
+  struct cmdlist_element *c;
+  char *p;
+
+  *how = JUMP_EXIT;
+  if (!(cl->next))
+    return cl;
+
+  for (c = cl->next;c->next; c = c->next) {
+    for (p = c->cmd; *p && isspace(*p); p++); /* skip spaces */
+
+    if (!strn_cmp("if ", p, 3))
+      c = scan_end(c, err);
+
+    else if (!strn_cmp("elseif ", p, 7)) {
+      *how = JUMP_TEST;
+      return c;
+    }
+
+    else if (!strn_cmp("else", p, 4)) {
+      *how = JUMP_ENTER;
+      return c;
+    }
+
+    else if (!strn_cmp("end", p, 3))
+      return c;
+
+    /* thanks to Russell Ryan for this fix */
+    if(!c->next) { /* rryan: this is the last line, return. */
+      SCAN_ERR(err, 4);
+      return c;
+    }
+  }
+
+  /* rryan: if we got here, it's the last line, if its not an end, log it. */
+  for (p = c->cmd; *p && isspace(*p); p++); /* skip spaces */
+  if(strn_cmp("end", p, 3))
+    SCAN_ERR(err, 5);
+  return c;
+}
+
+/* Scans for the next case, default or done at the level of a switch or case.
+ * Returns that line, or the last line of the trigger. */
+static struct cmdlist_element *scan_case(struct cmdlist_element *cl, byte *how)
+{
+  struct cmdlist_element *c;
+  char *p;
+
+  *how = JUMP_EXIT;
   if (!(cl->next))
     return cl;
 
   for (c = cl->next; c->next; c = c->next) {
     for (p = c->cmd; *p && isspace(*p); p++);
 
-    if (!strn_cmp("while ", p, 6) || !strn_cmp("switch", p, 6))
-      c = find_done(c);
-    else if (!strn_cmp("case ", p, 5)) {
-      buf = (char*)malloc(MAX_STRING_LENGTH);
-      eval_op("==", result, p + 5, buf, go, sc, trig);
-      if (*buf && *buf!='0') {
-        free(buf);
+    if (!strn_cmp("while ", p, 6) || !strn_cmp("switch", p, 6)) {
+      if (!(c = scan_done(c)) || !c->next) /* no done: nothing more to run */
         return c;
-      }
-      free(buf);
+    } else if (!strn_cmp("case ", p, 5)) {
+      *how = JUMP_TEST;
+      return c;
     } else if (!strn_cmp("default", p, 7))
       return c;
     else if (!strn_cmp("done", p, 3))
@@ -2799,7 +3010,7 @@ find_case(struct trig_data *trig, struct cmdlist_element *cl,
 /* Scans for end of while/switch-blocks. Returns the line containg 'end', or 
  * the last line of the trigger if not found. Malformed scripts may cause NULL 
  * to be returned. */
-static struct cmdlist_element *find_done(struct cmdlist_element *cl)
+static struct cmdlist_element *scan_done(struct cmdlist_element *cl)
 {
   struct cmdlist_element *c;
   char *p;
@@ -2810,15 +3021,80 @@ static struct cmdlist_element *find_done(struct cmdlist_element *cl)
   for (c = cl->next; c && c->next; c = c->next) {
     for (p = c->cmd; *p && isspace(*p); p++);
 
-    if (!strn_cmp("while ", p, 6) || !strn_cmp("switch ", p, 7))
-      c = find_done(c);
-    else if (!strn_cmp("done", p, 3))
+    if (!strn_cmp("while ", p, 6) || !strn_cmp("switch ", p, 7)) {
+      if (!(c = scan_done(c)))
+        return NULL;
+    } else if (!strn_cmp("done", p, 3))
       return c;
   }
 
   return c;
 }
 
+/* Works out once what each line of a trigger is, where each branch, loop and
+ * switch goes on to, and which command each line without a % runs, so that
+ * script_driver() never scans ahead or picks a line apart twice.  The lines
+ * are shared by every copy of the trigger, so this is done to prototypes
+ * when they are loaded or saved by trigedit. */
+void compile_trigger(trig_data *trig)
+{
+  struct cmdlist_element *cl;
+  char *p;
+
+  for (cl = trig->cmdlist; cl; cl = cl->next) {
+    for (p = cl->cmd; *p && isspace(*p); p++);
+
+    cl->op = line_op(p);
+    cl->cmd_op = TCMD_SUBST;
+    cl->how = JUMP_EXIT;
+    cl->err = cl->end_err = 0;
+    cl->arg = p - cl->cmd;
+    cl->jump = cl->end = NULL;
+
+    switch (cl->op) {
+      case TOP_IF:
+      case TOP_ELSEIF:
+        cl->arg += (cl->op == TOP_IF ? 3 : 7);
+        cl->jump = scan_else(cl, &cl->err, &cl->how);
+        cl->end = scan_end(cl, &cl->end_err);
+        break;
+      case TOP_ELSE:
+        cl->end = scan_end(cl, &cl->end_err);
+        break;
+      case TOP_WHILE:
+        cl->arg += 6;
+        cl->jump = scan_done(cl);
+        break;
+      case TOP_BREAK:
+        cl->jump = scan_done(cl);
+        break;
+      case TOP_SWITCH:
+        cl->arg += 7;
+        cl->jump = scan_case(cl, &cl->how);
+        break;
+      case TOP_CASE:
+        if (!strn_cmp("case ", p, 5))
+          cl->arg += 5;
+        cl->jump = scan_case(cl, &cl->how);
+        break;
+      case TOP_COMMAND:
+        if (!strchr(p, '%'))
+          cl->cmd_op = command_op(p);
+        break;
+    }
+  }
+}
+
+/* Line number of c in list, counting from 1, for tstat. */
+static int line_number(struct cmdlist_element *list, struct cmdlist_element *c)
+{
+  int n;
+
+  for (n = 1; list && list != c; list = list->next)
+    n++;
+
+  return (list ? n : 0);
+}
 
 /* load in a character's saved variables */
 void read_saved_vars(struct char_data *ch)
@@ -2838,7 +3114,7 @@ void read_saved_vars(struct char_data *ch)
   /* Create the space for the script structure which holds the vars. We need to
    * do this first, because later calls to 'remote' will need. A script already 
    * assigned. */
-  CREATE(SCRIPT(ch), struct script_data, 1);
+  SCRIPT(ch) = create_script(ch, MOB_TRIGGER);
 
   /* find the file that holds the saved variables and open it*/
   get_filename(fn, sizeof(fn), SCRIPT_VARS_FILE, GET_NAME(ch));
@@ -2923,7 +3199,7 @@ void read_saved_vars_ascii(FILE *file, struct char_data *ch, int count)
   /* Create the space for the script structure which holds the vars. We need to
    * do this first, because later calls to 'remote' will need. A script already
    * assigned. */
-  CREATE(SCRIPT(ch), struct script_data, 1);
+  SCRIPT(ch) = create_script(ch, MOB_TRIGGER);
 
   /* walk through each line in the file parsing variables */
   for (i = 0; i < count; i++)
@@ -2972,34 +3248,117 @@ void save_char_vars_ascii(FILE *file, struct char_data *ch)
 }
 
 /* find_char() helpers */
-/* Must be power of 2. */
-#define BUCKET_COUNT 64
-/* To recognize an empty bucket. */
-#define UID_OUT_OF_RANGE 1000000000
+/* UIDs are kept in an open addressing hash table with Robin Hood probing: an
+ * entry is never placed further from its home slot than the entry it would
+ * displace, so probe sequences stay short even at high load, and a failed
+ * lookup can stop as soon as it passes the place the UID would have been. */
+/* Initial number of slots. Must be power of 2. */
+#define LOOKUP_TABLE_MIN 1024
+/* Grow the table when more than LOOKUP_LOAD_NUM/LOOKUP_LOAD_DEN of the slots
+ * are in use. */
+#define LOOKUP_LOAD_NUM 3
+#define LOOKUP_LOAD_DEN 4
+/* To recognize an empty slot. UID 0 is never handed out. */
+#define UID_EMPTY 0
 
 struct lookup_table_t {
   long uid;
   void * c;
-  struct lookup_table_t *next;
 };
-static struct lookup_table_t lookup_table[BUCKET_COUNT];
+static struct lookup_table_t *lookup_table = NULL;
+static int lookup_size = 0;   /* number of slots, always a power of 2 */
+static int lookup_bits = 0;   /* log2(lookup_size) */
+static int lookup_count = 0;  /* slots in use */
 
-void init_lookup_table(void)
+/* UIDs are handed out sequentially, so scramble them (Fibonacci hashing)
+ * before taking the top bits as the home slot. */
+static int lookup_home(long uid)
 {
-  int i;
-  for (i = 0; i < BUCKET_COUNT; i++) {
-    lookup_table[i].uid  = UID_OUT_OF_RANGE;
-    lookup_table[i].c    = NULL;
-    lookup_table[i].next = NULL;
+  return (int) (((unsigned int) uid * 2654435769U) >> (32 - lookup_bits));
+}
+
+/* How far the entry in slot i sits from its home slot. */
+static int lookup_distance(int i)
+{
+  return (i - lookup_home(lookup_table[i].uid)) & (lookup_size - 1);
+}
+
+static struct lookup_table_t *lookup_slot(long uid)
+{
+  int i, dist;
+
+  if (!lookup_size || uid == UID_EMPTY)
+    return NULL;
+
+  for (i = lookup_home(uid), dist = 0; ; i = (i + 1) & (lookup_size - 1), dist++) {
+    if (lookup_table[i].uid == uid)
+      return &lookup_table[i];
+    if (lookup_table[i].uid == UID_EMPTY || lookup_distance(i) < dist)
+      return NULL;
   }
 }
 
-static struct char_data *find_char_by_uid_in_lookup_table(long uid)
+/* Places a UID known not to be in the table. */
+static void lookup_insert(long uid, void *c)
+{
+  struct lookup_table_t entry, tmp;
+  int i, dist, d;
+
+  entry.uid = uid;
+  entry.c = c;
+
+  for (i = lookup_home(uid), dist = 0; ; i = (i + 1) & (lookup_size - 1), dist++) {
+    if (lookup_table[i].uid == UID_EMPTY) {
+      lookup_table[i] = entry;
+      lookup_count++;
+      return;
+    }
+    /* Take the slot from a richer entry and carry that one on instead. */
+    if ((d = lookup_distance(i)) < dist) {
+      tmp = lookup_table[i];
+      lookup_table[i] = entry;
+      entry = tmp;
+      dist = d;
+    }
+  }
+}
+
+static void resize_lookup_table(int size)
 {
-  int bucket = (int) (uid & (BUCKET_COUNT - 1));
-  struct lookup_table_t *lt = &lookup_table[bucket];
+  struct lookup_table_t *old = lookup_table;
+  int i, old_size = lookup_size;
+
+  CREATE(lookup_table, struct lookup_table_t, size);
+  lookup_size = size;
+  for (lookup_bits = 0; (1 << lookup_bits) < size; lookup_bits++)
+    ;
+  lookup_count = 0;
 
-  for (;lt && lt->uid != uid ; lt = lt->next) ;
+  for (i = 0; i < old_size; i++)
+    if (old[i].uid != UID_EMPTY)
+      lookup_insert(old[i].uid, old[i].c);
+
+  if (old)
+    free(old);
+}
+
+void init_lookup_table(void)
+{
+  free_lookup_table();
+  resize_lookup_table(LOOKUP_TABLE_MIN);
+}
+
+void free_lookup_table(void)
+{
+  if (lookup_table)
+    free(lookup_table);
+  lookup_table = NULL;
+  lookup_size = lookup_bits = lookup_count = 0;
+}
+
+static struct char_data *find_char_by_uid_in_lookup_table(long uid)
+{
+  struct lookup_table_t *lt = lookup_slot(uid);
 
   if (lt)
     return (struct char_data *)(lt->c);
@@ -3010,10 +3369,7 @@ static struct char_data *find_char_by_uid_in_lookup_table(long uid)
 
 static struct obj_data *find_obj_by_uid_in_lookup_table(long uid)
 {
-  int bucket = (int) (uid & (BUCKET_COUNT - 1));
-  struct lookup_table_t *lt = &lookup_table[bucket];
-
-  for (;lt && lt->uid != uid ; lt = lt->next) ;
+  struct lookup_table_t *lt = lookup_slot(uid);
 
   if (lt)
     return (struct obj_data *)(lt->c);
@@ -3024,49 +3380,77 @@ static struct obj_data *find_obj_by_uid_in_lookup_table(long uid)
 
 void add_to_lookup_table(long uid, void *c)
 {
-  int bucket = (int) (uid & (BUCKET_COUNT - 1));
-  struct lookup_table_t *lt = &lookup_table[bucket];
+  struct lookup_table_t *lt;
 
-  if (lt && lt->uid == uid) {
-   log("add_to_lookup updating existing value for uid=%ld (%p -> %p)", uid, lt->c, c);
-   lt->c = c;
-   return;
+  if (uid == UID_EMPTY) {
+    log("SYSERR: add_to_lookup_table called with uid 0 (%p)", c);
+    return;
   }
 
-  for (;lt && lt->next; lt = lt->next)
-    if (lt->next->uid == uid) {
-      log("add_to_lookup updating existing value for uid=%ld (%p -> %p)", uid, lt->next->c, c);
-      return;
-    }
+  if ((lt = lookup_slot(uid)) != NULL) {
+    log("add_to_lookup updating existing value for uid=%ld (%p -> %p)", uid, lt->c, c);
+    lt->c = c;
+    return;
+  }
 
-  CREATE(lt->next, struct lookup_table_t, 1);
-  lt->next->uid = uid;
-  lt->next->c = c;
+  if (!lookup_size)
+    resize_lookup_table(LOOKUP_TABLE_MIN);
+  else if ((lookup_count + 1) * LOOKUP_LOAD_DEN > lookup_size * LOOKUP_LOAD_NUM)
+    resize_lookup_table(lookup_size * 2);
+
+  lookup_insert(uid, c);
 }
 
 void remove_from_lookup_table(long uid)
 {
-  int bucket = (int) (uid & (BUCKET_COUNT - 1));
-  struct lookup_table_t *lt = &lookup_table[bucket], *flt = NULL;
+  struct lookup_table_t *lt;
+  int i, next;
 
   /* This is not supposed to happen. UID 0 is not used. However, while I'm 
    * debugging the issue, let's just return right away. - Welcor */
   if (uid == 0)
     return;
 
-  for (;lt;lt = lt->next)
-    if (lt->uid == uid)
-      flt = lt;
-
-  if (flt) {
-    for (lt = &lookup_table[bucket];lt->next != flt;lt = lt->next)
-      ;
-    lt->next = flt->next;
-    free(flt);
+  if ((lt = lookup_slot(uid)) == NULL) {
+    log("remove_from_lookup. UID %ld not found.", uid);
     return;
   }
 
-  log("remove_from_lookup. UID %ld not found.", uid);
+  /* Shift the following displaced entries back one slot each, so no
+   * tombstone is left behind. */
+  i = lt - lookup_table;
+  for (next = (i + 1) & (lookup_size - 1);
+       lookup_table[next].uid != UID_EMPTY && lookup_distance(next) > 0;
+       i = next, next = (next + 1) & (lookup_size - 1))
+    lookup_table[i] = lookup_table[next];
+
+  lookup_table[i].uid = UID_EMPTY;
+  lookup_table[i].c = NULL;
+  lookup_count--;
+}
+
+/** Reports how full the UID lookup table is, for 'show stats'.
+ * @param entries Set to the number of UIDs in the table.
+ * @param slots Set to the number of slots in the table.
+ * @param max_probe Set to the longest distance of an entry from its home slot.
+ * @retval float The average distance of an entry from its home slot. */
+float lookup_table_stats(int *entries, int *slots, int *max_probe)
+{
+  long total = 0;
+  int i, d;
+
+  *entries = lookup_count;
+  *slots = lookup_size;
+  *max_probe = 0;
+
+  for (i = 0; i < lookup_size; i++)
+    if (lookup_table[i].uid != UID_EMPTY) {
+      d = lookup_distance(i);
+      total += d;
+      *max_probe = MAX(*max_probe, d);
+    }
+
+  return lookup_count ? (float) total / lookup_count : 0;
 }
 
 bool check_flags_by_name_ar(int *array, int numflags, char *search, const char *namelist[]) 
@@ -130,17 +130,70 @@
 
 #define SCRIPT_ERROR_CODE     -9999999   /* this shouldn't happen too often */
 
+/* What a line of a trigger is, worked out once by compile_trigger(). */
+#define TOP_NONE                0	     /* not compiled yet         */
+#define TOP_COMMENT             1
+#define TOP_IF                  2
+#define TOP_ELSEIF              3
+#define TOP_ELSE                4
+#define TOP_WHILE               5
+#define TOP_SWITCH              6
+#define TOP_END                 7
+#define TOP_DONE                8
+#define TOP_BREAK               9
+#define TOP_CASE                10
+#define TOP_COMMAND             11	     /* anything else, see TCMD_ */
+
+/* The command on a TOP_COMMAND line.  Only a line without a % is looked up
+ * when compiled; the rest are TCMD_SUBST until substituted at run time. */
+#define TCMD_SUBST              0
+#define TCMD_EVAL               1
+#define TCMD_NOP                2
+#define TCMD_EXTRACT            3
+#define TCMD_DG_LETTER          4
+#define TCMD_MAKEUID            5
+#define TCMD_HALT               6
+#define TCMD_DG_CAST            7
+#define TCMD_DG_AFFECT          8
+#define TCMD_GLOBAL             9
+#define TCMD_CONTEXT            10
+#define TCMD_REMOTE             11
+#define TCMD_RDELETE            12
+#define TCMD_RETURN             13
+#define TCMD_SET                14
+#define TCMD_UNSET              15
+#define TCMD_WAIT               16
+#define TCMD_ATTACH             17
+#define TCMD_DETACH             18
+#define TCMD_OTHER              19	     /* to the command interpreter */
+
+/* How a jump from an if, elseif, switch or case line lands. */
+#define JUMP_EXIT               0	     /* carry on after the target */
+#define JUMP_TEST               1	     /* test the elseif or case there */
+#define JUMP_ENTER              2	     /* an else or default: go in */
+
 /* one line of the trigger */
 struct cmdlist_element {
   char *cmd;				/* one line of a trigger */
   struct cmdlist_element *original;
   struct cmdlist_element *next;
+
+  /* The compiled line, shared like the text by every copy of the trigger. */
+  byte op;				/* TOP_ kind of line */
+  byte cmd_op;				/* TCMD_ command of a TOP_COMMAND line */
+  byte how;				/* JUMP_ landing of jump */
+  byte err;				/* nesting error on the way to jump */
+  byte end_err;				/* nesting error on the way to end */
+  int arg;				/* offset of the condition or command */
+  struct cmdlist_element *jump;		/* next branch, case or the done */
+  struct cmdlist_element *end;		/* 'end' of an if, elseif or else */
 };
 
 struct trig_var_data {
   char *name;				/* name of variable  */
   char *value;				/* value of variable */
   long context;				/* 0: global context */
+  unsigned long hash;			/* var_hash(name)    */
 
   struct trig_var_data *next;
 };
@@ -166,6 +219,12 @@ struct trig_data {
     struct trig_data *next_in_world;    /**< next in the global trigger list */
 };
 
+/* Registries of scripts holding random or time triggers, so the periodic
+ * passes do not have to walk the whole world to find them. */
+#define SREG_RANDOM             0
+#define SREG_TIME               1
+#define NUM_SCRIPT_REGISTRIES   2
+
 /** a complete script (composed of several triggers) */
 struct script_data {
   long types;                        /**< bitvector of trigger types */
@@ -174,6 +233,14 @@ struct script_data {
   ubyte purged;                      /**< script is set to be purged */
   long context;                      /**< current context for statics */
 
+  int owner_type;                    /**< MOB_, OBJ_ or WLD_TRIGGER  */
+  void *owner;                       /**< mob or obj holding the script */
+  room_vnum owner_room;              /**< room holding the script; rooms
+                                      * move in world[] so keep the vnum */
+  ubyte registered;                  /**< SREG_ registries it is in  */
+  struct script_data *reg_next[NUM_SCRIPT_REGISTRIES]; /**< registry links */
+  struct script_data *reg_prev[NUM_SCRIPT_REGISTRIES];
+
   struct script_data *next;          /**< used for purged_scripts    */
 };
 
@@ -292,7 +359,9 @@ void find_uid_name(char *uid, char *name, size_t nlen);
 void do_sstat_room(struct char_data * ch, room_data *r);
 void do_sstat_object(char_data *ch, obj_data *j);
 void do_sstat_character(char_data *ch, char_data *k);
+struct script_data *create_script(void *thing, int type);
 void add_trigger(struct script_data *sc, trig_data *t, int loc);
+void update_script_registries(struct script_data *sc);
 void script_vlog(const char *format, va_list args);
 void script_log(const char *format, ...) __attribute__ ((format (printf, 1, 2)));
 char *matching_quote(char *p);
@@ -306,17 +375,20 @@ int trig_is_attached(struct script_data *sc, int trig_num);
 /* To maintain strict-aliasing we'll have to do this trick with a union */
 /* Thanks to Chris Gilbert for reminding me that there are other options. */
 int script_driver(void *go_adress, trig_data *trig, int type, int mode);
+void compile_trigger(trig_data *trig);
 trig_rnum real_trigger(trig_vnum vnum);
 void process_eval(void *go, struct script_data *sc, trig_data *trig,
                  int type, char *cmd);
 void read_saved_vars(struct char_data *ch);
 void save_char_vars(struct char_data *ch);
 void init_lookup_table(void);
+void free_lookup_table(void);
 void add_to_lookup_table(long uid, void *c);
 void remove_from_lookup_table(long uid);
+float lookup_table_stats(int *entries, int *slots, int *max_probe);
 
 /* from dg_db_scripts.c */
-void parse_trigger(FILE *trig_f, int nr);
+void parse_trigger(FILE *trig_f, int nr, int rnum);
 trig_data *read_trigger(int nr);
 void trig_data_copy(trig_data *this_data, const trig_data *trg);
 void dg_read_trigger(FILE *fp, void *proto, int type);
@@ -324,13 +396,14 @@ void dg_obj_trigger(char *line, struct obj_data *obj);
 void assign_triggers(void *i, int type);
 
 /* From dg_variables.c */
+unsigned long var_hash(const char *name);
 void add_var(struct trig_var_data **var_list, const char *name, const char *value, long id);
 int item_in_list(char *item, obj_data *list);
 char *skill_percent(struct char_data *ch, char *skill);
 int char_has_item(char *item, struct char_data *ch);
 void var_subst(void *go, struct script_data *sc, trig_data *trig,
                int type, char *line, char *buf);
-int text_processed(char *field, char *subfield, struct trig_var_data *vd,
+int text_processed(int fid, char *subfield, struct trig_var_data *vd,
                    char *str, size_t slen);
 void find_replacement(void *go, struct script_data *sc, trig_data *trig,
                 int type, char *var, char *field, char *subfield, char *str, size_t slen);
@@ -28,21 +28,259 @@
 #include "act.h"
 #include "genobj.h"
 
+/* Field and variable names find_replacement() knows about.  The ids are
+ * shared by the char, object, room and text fields and by the names that
+ * stand on their own, like %self%.  Keep the list below in id order. */
+#define DGF_NONE          -1
+#define DGF_AFFECT         0
+#define DGF_AFFECTS        1
+#define DGF_ALIAS          2
+#define DGF_ALIGN          3
+#define DGF_ARMOR          4
+#define DGF_ASOUND         5
+#define DGF_AT             6
+#define DGF_CANBESEEN      7
+#define DGF_CAR            8
+#define DGF_CARRIED_BY     9
+#define DGF_CDR            10
+#define DGF_CHA            11
+#define DGF_CHAR           12
+#define DGF_CHARAT         13
+#define DGF_CLASS          14
+#define DGF_CON            15
+#define DGF_CONTAINS       16
+#define DGF_CONTENTS       17
+#define DGF_COST           18
+#define DGF_COST_PER_DAY   19
+#define DGF_COUNT          20
+#define DGF_DAMAGE         21
+#define DGF_DAMROLL        22
+#define DGF_DAY            23
+#define DGF_DEX            24
+#define DGF_DIR            25
+#define DGF_DOOR           26
+#define DGF_DOWN           27
+#define DGF_DRUNK          28
+#define DGF_EAST           29
+#define DGF_ECHO           30
+#define DGF_ECHOAROUND     31
+#define DGF_EQ             32
+#define DGF_EXP            33
+#define DGF_EXTRA          34
+#define DGF_FIGHTING       35
+#define DGF_FINDMOB        36
+#define DGF_FINDOBJ        37
+#define DGF_FOLLOWER       38
+#define DGF_FORCE          39
+#define DGF_GLOBAL         40
+#define DGF_GOLD           41
+#define DGF_HAPPYHOUR      42
+#define DGF_HAS_IN         43
+#define DGF_HAS_ITEM       44
+#define DGF_HASATTACHED    45
+#define DGF_HESHE          46
+#define DGF_HIMHER         47
+#define DGF_HISHER         48
+#define DGF_HITP           49
+#define DGF_HITROLL        50
+#define DGF_HOUR           51
+#define DGF_HUNGER         52
+#define DGF_ID             53
+#define DGF_INT            54
+#define DGF_INVENTORY      55
+#define DGF_IS_INROOM      56
+#define DGF_IS_KILLER      57
+#define DGF_IS_PC          58
+#define DGF_IS_THIEF       59
+#define DGF_LEVEL          60
+#define DGF_LOAD           61
+#define DGF_LOG            62
+#define DGF_MANA           63
+#define DGF_MASTER         64
+#define DGF_MAXHITP        65
+#define DGF_MAXMANA        66
+#define DGF_MAXMOVE        67
+#define DGF_MONTH          68
+#define DGF_MOVE           69
+#define DGF_MUDCOMMAND     70
+#define DGF_NAME           71
+#define DGF_NEXT_IN_LIST   72
+#define DGF_NEXT_IN_ROOM   73
+#define DGF_NORTH          74
+#define DGF_NPCFLAG        75
+#define DGF_OSET           76
+#define DGF_PEOPLE         77
+#define DGF_POS            78
+#define DGF_PRAC           79
+#define DGF_PREF           80
+#define DGF_PURGE          81
+#define DGF_QP             82
+#define DGF_QPNTS          83
+#define DGF_QUEST          84
+#define DGF_QUESTDONE      85
+#define DGF_QUESTPOINTS    86
+#define DGF_RACE           87
+#define DGF_RANDOM         88
+#define DGF_RECHO          89
+#define DGF_ROOM           90
+#define DGF_ROOMFLAG       91
+#define DGF_SAVING_BREATH  92
+#define DGF_SAVING_PARA    93
+#define DGF_SAVING_PETRI   94
+#define DGF_SAVING_ROD     95
+#define DGF_SAVING_SPELL   96
+#define DGF_SECTOR         97
+#define DGF_SELF           98
+#define DGF_SEND           99
+#define DGF_SEX            100
+#define DGF_SHORTDESC      101
+#define DGF_SKILL          102
+#define DGF_SKILLSET       103
+#define DGF_SOUTH          104
+#define DGF_STR            105
+#define DGF_STRADD         106
+#define DGF_STRLEN         107
+#define DGF_TELEPORT       108
+#define DGF_THIRST         109
+#define DGF_TIME           110
+#define DGF_TIMER          111
+#define DGF_TITLE          112
+#define DGF_TOUPPER        113
+#define DGF_TRANSFORM      114
+#define DGF_TRIM           115
+#define DGF_TYPE           116
+#define DGF_UP             117
+#define DGF_VAL0           118
+#define DGF_VAL1           119
+#define DGF_VAL2           120
+#define DGF_VAL3           121
+#define DGF_VAREXISTS      122
+#define DGF_VNUM           123
+#define DGF_WAIT           124
+#define DGF_WEARFLAG       125
+#define DGF_WEATHER        126
+#define DGF_WEIGHT         127
+#define DGF_WEST           128
+#define DGF_WIS            129
+#define DGF_WORN_BY        130
+#define DGF_YEAR           131
+#define DGF_ZONEECHO       132
+#define DGF_ZONENAME       133
+#define DGF_ZONENUMBER     134
+/** Total number of field names. */
+#define NUM_DG_FIELDS    135
+
+static const char *dg_fields[] = {
+  "affect", "affects", "alias", "align", "armor", "asound", "at", "canbeseen",
+  "car", "carried_by", "cdr", "cha", "char", "charat", "class", "con",
+  "contains", "contents", "cost", "cost_per_day", "count", "damage",
+  "damroll", "day", "dex", "dir", "door", "down", "drunk", "east", "echo",
+  "echoaround", "eq", "exp", "extra", "fighting", "findmob", "findobj",
+  "follower", "force", "global", "gold", "happyhour", "has_in", "has_item",
+  "hasattached", "heshe", "himher", "hisher", "hitp", "hitroll", "hour",
+  "hunger", "id", "int", "inventory", "is_inroom", "is_killer", "is_pc",
+  "is_thief", "level", "load", "log", "mana", "master", "maxhitp", "maxmana",
+  "maxmove", "month", "move", "mudcommand", "name", "next_in_list",
+  "next_in_room", "north", "npcflag", "oset", "people", "pos", "prac", "pref",
+  "purge", "qp", "qpnts", "quest", "questdone", "questpoints", "race",
+  "random", "recho", "room", "roomflag", "saving_breath", "saving_para",
+  "saving_petri", "saving_rod", "saving_spell", "sector", "self", "send",
+  "sex", "shortdesc", "skill", "skillset", "south", "str", "stradd", "strlen",
+  "teleport", "thirst", "time", "timer", "title", "toupper", "transform",
+  "trim", "type", "up", "val0", "val1", "val2", "val3", "varexists", "vnum",
+  "wait", "wearflag", "weather", "weight", "west", "wis", "worn_by", "year",
+  "zoneecho", "zonename", "zonenumber",
+};
+
+/* The names are laid out in field_slots so that no two share a slot, which
+ * makes a lookup one hash and one str_cmp().  The seed that spreads them out
+ * is searched for at first use; DG_FIELD_SLOTS is a power of two large
+ * enough that one turns up within a few tries. */
+#define DG_FIELD_BITS  12
+#define DG_FIELD_SLOTS (1 << DG_FIELD_BITS)
+
+static unsigned char field_slots[DG_FIELD_SLOTS]; /* field id + 1, or 0 */
+static unsigned long field_seed;
+static bool field_slots_built = FALSE;
+
+/* Local functions */
+static int field_slot(unsigned long hash, unsigned long seed);
+static void build_field_slots(void);
+static int field_id(const char *name, unsigned long hash);
+
 /* Utility functions */
 
+/* FNV-1a hash of a variable or field name.  Case blind, since names are
+ * matched with str_cmp(). */
+unsigned long var_hash(const char *name)
+{
+  unsigned long hash = 2166136261UL;
+
+  for (; *name; name++)
+    hash = ((hash ^ (unsigned char)LOWER(*name)) * 16777619UL) & 0xFFFFFFFFUL;
+
+  return hash;
+}
+
+static int field_slot(unsigned long hash, unsigned long seed)
+{
+  return (int)((((hash ^ seed) * 2654435761UL) & 0xFFFFFFFFUL) >> (32 - DG_FIELD_BITS));
+}
+
+static void build_field_slots(void)
+{
+  int i, slot;
+
+  for (field_seed = 0; field_seed < 100000; field_seed++) {
+    memset(field_slots, 0, sizeof(field_slots));
+    for (i = 0; i < NUM_DG_FIELDS; i++) {
+      slot = field_slot(var_hash(dg_fields[i]), field_seed);
+      if (field_slots[slot])
+        break;
+      field_slots[slot] = i + 1;
+    }
+    if (i == NUM_DG_FIELDS) {
+      field_slots_built = TRUE;
+      return;
+    }
+  }
+
+  log("SYSERR: No seed lays out the DG field names without a collision. Is one listed twice?");
+  exit(1);
+}
+
+/* Returns the id of a field or variable name, or DGF_NONE.  hash is
+ * var_hash(name). */
+static int field_id(const char *name, unsigned long hash)
+{
+  int slot;
+
+  if (!field_slots_built)
+    build_field_slots();
+
+  slot = field_slots[field_slot(hash, field_seed)];
+  if (slot && !str_cmp(name, dg_fields[slot - 1]))
+    return (slot - 1);
+
+  return (DGF_NONE);
+}
+
 /* Thanks to James Long for his assistance in plugging the memory leak that
  * used to be here. - Welcor */
 /* Adds a variable with given name and value to trigger. */
 void add_var(struct trig_var_data **var_list, const char *name, const char *value, long id)
 {
   struct trig_var_data *vd;
+  unsigned long hash;
 
   if (strchr(name, '.')) {
     log("add_var() : Attempt to add illegal var: %s", name);
     return;
   }
 
-  for (vd = *var_list; vd && str_cmp(vd->name, name); vd = vd->next);
+  hash = var_hash(name);
+  for (vd = *var_list; vd && (vd->hash != hash || str_cmp(vd->name, name));
+       vd = vd->next);
 
   if (vd && (!vd->context || vd->context==id)) {
     free(vd->value);
@@ -54,6 +292,7 @@ void add_var(struct trig_var_data **var_list, const char *name, const char *valu
 
     CREATE(vd->name, char, strlen(name) + 1);
     strcpy(vd->name, name);                            /* strcpy: ok*/
+    vd->hash = hash;
 
     CREATE(vd->value, char, strlen(value) + 1);
 
@@ -109,7 +348,7 @@ int item_in_list(char *item, obj_data *list)
     }
   } else {
     for (i = list; i; i = i->next_content) {
-      if (isname(item, i->name))
+      if (isname_obj(item, i))
         count++;
       if (GET_OBJ_TYPE(i) == ITEM_CONTAINER)
         count += item_in_list(item, i->contains);
@@ -171,21 +410,21 @@ static int handle_oset(struct obj_data * obj, char * argument)
   return 1;
 }
 
-int text_processed(char *field, char *subfield, struct trig_var_data *vd,
+int text_processed(int fid, char *subfield, struct trig_var_data *vd,
                    char *str, size_t slen)
 {
   char *p, *p2;
   char tmpvar[MAX_STRING_LENGTH];
 
-  if (!str_cmp(field, "strlen")) {                     /* strlen    */
+  if (fid == DGF_STRLEN) {                     /* strlen    */
     snprintf(str, slen, "%d", (int)strlen(vd->value));
     return TRUE;
-  } else if (!str_cmp(field, "toupper")) {             /* toupper   */
+  } else if (fid == DGF_TOUPPER) {             /* toupper   */
     char *upper = vd->value;
     if (*upper)
       snprintf(str, slen, "%c%s", UPPER(*upper), upper + 1);
     return TRUE;
-  } else if (!str_cmp(field, "trim")) {                /* trim      */
+  } else if (fid == DGF_TRIM) {                /* trim      */
     /* trim whitespace from ends */
     snprintf(tmpvar, sizeof(tmpvar)-1 , "%s", vd->value); /* -1 to use later*/
     p = tmpvar;
@@ -199,34 +438,34 @@ int text_processed(char *field, char *subfield, struct trig_var_data *vd,
     *(++p2) = '\0';                                         /* +1 ok (see above) */
     snprintf(str, slen, "%s", p);
     return TRUE;
-  } else if (!str_cmp(field, "contains")) {            /* contains  */
+  } else if (fid == DGF_CONTAINS) {            /* contains  */
     if (str_str(vd->value, subfield))
       strcpy(str, "1");
     else
       strcpy(str, "0");
     return TRUE;
-  } else if (!str_cmp(field, "car")) {                 /* car       */
+  } else if (fid == DGF_CAR) {                 /* car       */
     char *car = vd->value;
     while (*car && !isspace(*car))
       *str++ = *car++;
     *str = '\0';
     return TRUE;
 
-  } else if (!str_cmp(field, "cdr")) {                 /* cdr       */
+  } else if (fid == DGF_CDR) {                 /* cdr       */
     char *cdr = vd->value;
     while (*cdr && !isspace(*cdr)) cdr++; /* skip 1st field */
     while (*cdr && isspace(*cdr)) cdr++;  /* skip to next */
 
     snprintf(str, slen, "%s", cdr);
     return TRUE;
-  } else if (!str_cmp(field, "charat")) {              /* CharAt    */
+  } else if (fid == DGF_CHARAT) {              /* CharAt    */
     size_t len = strlen(vd->value), cindex = atoi(subfield);
     if (cindex > len || cindex < 1)
       strcpy(str, "");
     else
       snprintf(str, slen, "%c", vd->value[cindex - 1]);
     return TRUE;
-  } else if (!str_cmp(field, "mudcommand")) {
+  } else if (fid == DGF_MUDCOMMAND) {
     /* find the mud command returned from this text */
 /* NOTE: you may need to replace "cmd_info" with "complete_cmd_info", */
 /* depending on what patches you've got applied.                      */
@@ -257,6 +496,8 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
   struct room_data *room, *r = NULL;
   char *name;
   int num, count, i, j, doors;
+  unsigned long vhash, fhash;
+  int vid, fid;
 
   char *log_cmd[]        = {"mlog ",        "olog ",        "wlog "       };
   char *send_cmd[]       = {"msend ",       "osend ",       "wsend "      };
@@ -280,16 +521,21 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
 
   *str = '\0';
 
+  vhash = var_hash(var);
+  vid = field_id(var, vhash);
+  fhash = var_hash(field);
+  fid = field_id(field, fhash);
+
   /* X.global() will have a NULL trig */
   if (trig)
     for (vd = GET_TRIG_VARS(trig); vd; vd = vd->next)
-      if (!str_cmp(vd->name, var))
+      if (vd->hash == vhash && !str_cmp(vd->name, var))
         break;
 
   /* some evil waitstates could crash the mud if sent here with sc==NULL*/
   if (!vd && sc)
     for (vd = sc->global_vars; vd; vd = vd->next)
-      if (!str_cmp(vd->name, var) &&
+      if (vd->hash == vhash && !str_cmp(vd->name, var) &&
           (vd->context==0 || vd->context==sc->context))
         break;
 
@@ -297,7 +543,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
     if (vd)
       snprintf(str, slen, "%s", vd->value);
     else {
-      if (!str_cmp(var, "self")) {
+      if (vid == DGF_SELF) {
         switch (type) {
         case MOB_TRIGGER:
           snprintf(str, slen, "%c%ld", UID_CHAR, char_script_id((char_data *) go));
@@ -310,42 +556,42 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
           break;
         }
       }
-      else if (!str_cmp(var, "global")) {
+      else if (vid == DGF_GLOBAL) {
         /* so "remote varname %global%" will work */
         snprintf(str, slen, "%d", ROOM_ID_BASE);
         return;
       }
-      else if (!str_cmp(var, "door"))
+      else if (vid == DGF_DOOR)
         snprintf(str, slen, "%s", door[type]);
-      else if (!str_cmp(var, "force"))
+      else if (vid == DGF_FORCE)
         snprintf(str, slen, "%s", force[type]);
-      else if (!str_cmp(var, "load"))
+      else if (vid == DGF_LOAD)
         snprintf(str, slen, "%s", load[type]);
-      else if (!str_cmp(var, "purge"))
+      else if (vid == DGF_PURGE)
         snprintf(str, slen, "%s", purge[type]);
-      else if (!str_cmp(var, "teleport"))
+      else if (vid == DGF_TELEPORT)
         snprintf(str, slen, "%s", teleport[type]);
-      else if (!str_cmp(var, "damage"))
+      else if (vid == DGF_DAMAGE)
         snprintf(str, slen, "%s", xdamage[type]);
-      else if (!str_cmp(var, "send"))
+      else if (vid == DGF_SEND)
         snprintf(str, slen, "%s", send_cmd[type]);
-      else if (!str_cmp(var, "echo"))
+      else if (vid == DGF_ECHO)
         snprintf(str, slen, "%s", echo_cmd[type]);
-      else if (!str_cmp(var, "echoaround"))
+      else if (vid == DGF_ECHOAROUND)
         snprintf(str, slen, "%s", echoaround_cmd[type]);
-      else if (!str_cmp(var, "zoneecho"))
+      else if (vid == DGF_ZONEECHO)
         snprintf(str, slen, "%s", zoneecho[type]);
-      else if (!str_cmp(var, "asound"))
+      else if (vid == DGF_ASOUND)
         snprintf(str, slen, "%s", asound[type]);
-      else if (!str_cmp(var, "at"))
+      else if (vid == DGF_AT)
         snprintf(str, slen, "%s", at[type]);
-      else if (!str_cmp(var, "transform"))
+      else if (vid == DGF_TRANSFORM)
         snprintf(str, slen, "%s", transform[type]);
-      else if (!str_cmp(var, "recho"))
+      else if (vid == DGF_RECHO)
         snprintf(str, slen, "%s", recho[type]);
-      else if (!str_cmp(var, "move"))
+      else if (vid == DGF_MOVE)
         snprintf(str, slen, "%s", omove[type]);
-      else if (!str_cmp(var, "log"))
+      else if (vid == DGF_LOG)
         snprintf(str, slen, "%s", log_cmd[type]);
       else
         *str = '\0';
@@ -354,7 +600,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
     return;
   }
 
-  else if (vd && text_processed(field, subfield, vd, str, slen)) return;
+  else if (vd && text_processed(fid, subfield, vd, str, slen)) return;
 
   else {
     if (vd) {
@@ -393,7 +639,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
     }
 
     else {
-      if (!str_cmp(var, "self")) {
+      if (vid == DGF_SELF) {
         switch (type) {
         case MOB_TRIGGER:
           c = (char_data *) go;
@@ -413,7 +659,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
         }
       }
 
-      else if (!str_cmp(var, "global")) {
+      else if (vid == DGF_GLOBAL) {
         struct script_data *thescript = SCRIPT(&world[0]);
         *str = '\0';
         if (!thescript) {
@@ -421,7 +667,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
           return;
         }
         for (vd = thescript->global_vars; vd ; vd = vd->next)
-          if (!str_cmp(vd->name, field))
+          if (vd->hash == fhash && !str_cmp(vd->name, field))
             break;
 
         if (vd)
@@ -429,28 +675,28 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
 
         return;
       }
-      else if (!str_cmp(var, "people")) {
+      else if (vid == DGF_PEOPLE) {
         snprintf(str, slen, "%d",((num = atoi(field)) > 0) ? trgvar_in_room(num) : 0);
         return;
       }
-      else if (!str_cmp(var, "happyhour")) {
-        if (!str_cmp(field, "qp") && IS_HAPPYHOUR)
+      else if (vid == DGF_HAPPYHOUR) {
+        if (fid == DGF_QP && IS_HAPPYHOUR)
           snprintf(str, slen, "%d", HAPPY_QP);
-        else if (!str_cmp(field, "exp") && IS_HAPPYHOUR)
+        else if (fid == DGF_EXP && IS_HAPPYHOUR)
           snprintf(str, slen, "%d", HAPPY_EXP);
-        else if (!str_cmp(field, "gold") && IS_HAPPYHOUR)
+        else if (fid == DGF_GOLD && IS_HAPPYHOUR)
           snprintf(str, slen, "%d", HAPPY_GOLD);
         else snprintf(str, slen, "%d", HAPPY_TIME);
         return;
       }
-      else if (!str_cmp(var, "time")) {
-        if (!str_cmp(field, "hour"))
+      else if (vid == DGF_TIME) {
+        if (fid == DGF_HOUR)
           snprintf(str, slen, "%d", time_info.hours);
-        else if (!str_cmp(field, "day"))
+        else if (fid == DGF_DAY)
           snprintf(str, slen, "%d", time_info.day + 1);
-        else if (!str_cmp(field, "month"))
+        else if (fid == DGF_MONTH)
           snprintf(str, slen, "%d", time_info.month + 1);
-        else if (!str_cmp(field, "year"))
+        else if (fid == DGF_YEAR)
           snprintf(str, slen, "%d", time_info.year);
         else *str = '\0';
         return;
@@ -465,7 +711,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
  * gold (vnum: 1234). In the vault (vnum: 453). Use: %findobj.453(1234)% and it
  * will return the number of bags of gold.
  * Addition inspired by Jamie Nelson */
-      else if (!str_cmp(var, "findmob")) {
+      else if (vid == DGF_FINDMOB) {
         if (!field || !*field || !subfield || !*subfield) {
           script_log("findmob.vnum(mvnum) - illegal syntax");
           strcpy(str, "0");
@@ -486,7 +732,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
         }
       }
       /* Addition inspired by Jamie Nelson. */
-      else if (!str_cmp(var, "findobj")) {
+      else if (vid == DGF_FINDOBJ) {
         if (!field || !*field || !subfield || !*subfield) {
           script_log("findobj.vnum(ovnum) - illegal syntax");
           strcpy(str, "0");
@@ -502,8 +748,8 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
           }
         }
       }
-      else if (!str_cmp(var, "random")) {
-        if (!str_cmp(field, "char")) {
+      else if (vid == DGF_RANDOM) {
+        if (fid == DGF_CHAR) {
           rndm = NULL;
           count = 0;
 
@@ -545,7 +791,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
             *str = '\0';
         }
 
-        else if (!str_cmp(field, "dir")) {
+        else if (fid == DGF_DIR) {
           room_rnum in_room = NOWHERE;
 
           switch (type) {
@@ -588,7 +834,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
     }
 
     if (c) {
-      if (!str_cmp(field, "global")) { /* get global of something else */
+      if (fid == DGF_GLOBAL) { /* get global of something else */
         if (IS_NPC(c) && c->script) {
           find_replacement(go, c->script, NULL, MOB_TRIGGER,
             subfield, NULL, NULL, str, slen);
@@ -599,7 +845,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
 
       switch (LOWER(*field)) {
         case 'a':
-          if (!str_cmp(field, "affect")) {
+          if (fid == DGF_AFFECT) {
             if (subfield && *subfield) {
               int spell = find_skill_num(subfield);
               if (affected_by_spell(c, spell))
@@ -609,27 +855,27 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
             } else
               strcpy(str, "0");
           }
-          else if (!str_cmp(field, "alias"))
+          else if (fid == DGF_ALIAS)
             snprintf(str, slen, "%s", GET_PC_NAME(c));
 
-          else if (!str_cmp(field, "align")) {
+          else if (fid == DGF_ALIGN) {
             if (subfield && *subfield) {
               int addition = atoi(subfield);
              GET_ALIGNMENT(c) = MAX(-1000, MIN(addition, 1000));
             }
 	    snprintf(str, slen, "%d", GET_ALIGNMENT(c));
           }
-          else if (!str_cmp(field, "armor"))
+          else if (fid == DGF_ARMOR)
             snprintf(str, slen, "%d", compute_armor_class(c));
           break;
         case 'c':
-          if (!str_cmp(field, "canbeseen")) {
+          if (fid == DGF_CANBESEEN) {
             if ((type == MOB_TRIGGER) && !CAN_SEE(((char_data *)go), c))
               strcpy(str, "0");
             else
               strcpy(str, "1");
           }
-          else if (!str_cmp(field, "cha")) {
+          else if (fid == DGF_CHA) {
             if (subfield && *subfield) {
               int addition = atoi(subfield);
               int max = (IS_NPC(c) || GET_LEVEL(c) >= LVL_GRGOD) ? 25 : 18;
@@ -640,7 +886,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
             }
             snprintf(str, slen, "%d", GET_CHA(c));
           }
-          else if (!str_cmp(field, "class")) {
+          else if (fid == DGF_CLASS) {
             if (subfield && *subfield) {
               int cl = get_class_by_name(subfield);
               if (cl != -1) {
@@ -652,7 +898,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
             } else
               sprinttype(GET_CLASS(c), pc_class_types, str, slen);
           }
-          else if (!str_cmp(field, "con")) {
+          else if (fid == DGF_CON) {
             if (subfield && *subfield) {
               int addition = atoi(subfield);
               int max = (IS_NPC(c) || GET_LEVEL(c) >= LVL_GRGOD) ? 25 : 18;
@@ -665,13 +911,13 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
           }
           break;
         case 'd':
-          if (!str_cmp(field, "damroll")) {
+          if (fid == DGF_DAMROLL) {
             if (subfield && *subfield) {
               int addition = atoi(subfield);
               GET_DAMROLL(c) = MAX(1, GET_DAMROLL(c) + addition);
             }
             snprintf(str, slen, "%d", GET_DAMROLL(c));
-            } else if (!str_cmp(field, "dex")) {
+            } else if (fid == DGF_DEX) {
               if (subfield && *subfield) {
                 int addition = atoi(subfield);
                 int max = (IS_NPC(c) || GET_LEVEL(c) >= LVL_GRGOD) ? 25 : 18;
@@ -682,7 +928,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
               }
             snprintf(str, slen, "%d", GET_DEX(c));
           }
-          else if (!str_cmp(field, "drunk")) {
+          else if (fid == DGF_DRUNK) {
             if (subfield && *subfield) {
               int addition = atoi(subfield);
               GET_COND(c, DRUNK) = MAX(-1, MIN(addition, 24));
@@ -691,7 +937,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
           }
           break;
         case 'e':
-          if (!str_cmp(field, "eq")) {
+          if (fid == DGF_EQ) {
             int pos;
             if (!subfield || !*subfield)
               *str = '\0';
@@ -710,7 +956,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
             else
               snprintf(str, slen, "%c%ld",UID_CHAR, obj_script_id(GET_EQ(c, pos)));
           }
-          else if (!str_cmp(field, "exp")) {
+          else if (fid == DGF_EXP) {
             if (subfield && *subfield) {
               int addition = MIN(atoi(subfield), 1000);
 
@@ -720,13 +966,13 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
           }
           break;
         case 'f':
-          if (!str_cmp(field, "fighting")) {
+          if (fid == DGF_FIGHTING) {
             if (FIGHTING(c))
               snprintf(str, slen, "%c%ld", UID_CHAR, char_script_id(FIGHTING(c)));
             else
               *str = '\0';
           }
-          else if (!str_cmp(field, "follower")) {
+          else if (fid == DGF_FOLLOWER) {
             if (!c->followers || !c->followers->follower)
               *str = '\0';
             else
@@ -734,7 +980,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
           }
           break;
         case 'g':
-          if (!str_cmp(field, "gold")) {
+          if (fid == DGF_GOLD) {
             if (subfield && *subfield) {
               int addition = atoi(subfield);
               increase_gold(c, addition);
@@ -743,13 +989,13 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
           }
           break;
         case 'h':
-          if (!str_cmp(field, "has_item")) {
+          if (fid == DGF_HAS_ITEM) {
             if (!(subfield && *subfield))
               *str = '\0';
             else
               snprintf(str, slen, "%d", char_has_item(subfield, c));
           }
-          else if (!str_cmp(field, "hasattached")) {
+          else if (fid == DGF_HASATTACHED) {
             if (!(subfield && *subfield) || !IS_NPC(c))
               *str = '\0';
             else {
@@ -757,13 +1003,13 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
               snprintf(str, slen, "%d", trig_is_attached(SCRIPT(c), i));
             }
           }
-          else if (!str_cmp(field, "heshe"))
+          else if (fid == DGF_HESHE)
             snprintf(str, slen, "%s", HSSH(c));
-          else if (!str_cmp(field, "himher"))
+          else if (fid == DGF_HIMHER)
             snprintf(str, slen, "%s", HMHR(c));
-          else if (!str_cmp(field, "hisher"))
+          else if (fid == DGF_HISHER)
             snprintf(str, slen, "%s", HSHR(c));
-          else if (!str_cmp(field, "hitp")) {
+          else if (fid == DGF_HITP) {
             if (subfield && *subfield) {
               int addition = atoi(subfield);
               GET_HIT(c) += addition;
@@ -771,14 +1017,14 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
             }
             snprintf(str, slen, "%d", GET_HIT(c));
           }
-          else if (!str_cmp(field, "hitroll")) {
+          else if (fid == DGF_HITROLL) {
             if (subfield && *subfield) {
               int addition = atoi(subfield);
               GET_HITROLL(c) = MAX(1, GET_HITROLL(c) + addition);
             }
             snprintf(str, slen, "%d", GET_HITROLL(c));
           }
-          else if (!str_cmp(field, "hunger")) {
+          else if (fid == DGF_HUNGER) {
             if (subfield && *subfield) {
               int addition = atoi(subfield);
               GET_COND(c, HUNGER) = MAX(-1, MIN(addition, 24));
@@ -787,16 +1033,16 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
           }
           break;
         case 'i':
-          if (!str_cmp(field, "id"))
+          if (fid == DGF_ID)
             snprintf(str, slen, "%ld", char_script_id(c));
           /* new check for pc/npc status */
-          else if (!str_cmp(field, "is_pc")) {
+          else if (fid == DGF_IS_PC) {
             if (IS_NPC(c))
               strcpy(str, "0");
             else
               strcpy(str, "1");
           }
-          else if (!str_cmp(field, "int")) {
+          else if (fid == DGF_INT) {
             if (subfield && *subfield) {
               int addition = atoi(subfield);
               int max = (IS_NPC(c) || GET_LEVEL(c) >= LVL_GRGOD) ? 25 : 18;
@@ -807,7 +1053,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
             }
             snprintf(str, slen, "%d", GET_INT(c));
           }
-          else if (!str_cmp(field, "inventory")) {
+          else if (fid == DGF_INVENTORY) {
             if(subfield && *subfield) {
               for (obj = c->carrying;obj;obj=obj->next_content) {
                 if(GET_OBJ_VNUM(obj)==atoi(subfield)) {
@@ -825,7 +1071,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
               }
             }
           }
-          else if (!str_cmp(field, "is_killer")) {
+          else if (fid == DGF_IS_KILLER) {
             if (subfield && *subfield) {
               if (!str_cmp("on", subfield))
                 SET_BIT_AR(PLR_FLAGS(c), PLR_KILLER);
@@ -837,7 +1083,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
             else
               strcpy(str, "0");
           }
-          else if (!str_cmp(field, "is_thief")) {
+          else if (fid == DGF_IS_THIEF) {
             if (subfield && *subfield) {
               if (!str_cmp("on", subfield))
                 SET_BIT_AR(PLR_FLAGS(c), PLR_THIEF);
@@ -851,50 +1097,51 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
           }
           break;
         case 'l':
-          if (!str_cmp(field, "level")) {
+          if (fid == DGF_LEVEL) {
             if (subfield && *subfield) {
               int lev = atoi(subfield);
               GET_LEVEL(c) = MIN(MAX(lev, 0), LVL_IMMORT-1);
+              update_zone_presence(c);
             } else
               snprintf(str, slen, "%d", GET_LEVEL(c));
           }
           break;
         case 'm':
-          if (!str_cmp(field, "mana")) {
+          if (fid == DGF_MANA) {
             if (subfield && *subfield) {
               int addition = atoi(subfield);
               GET_MANA(c) += addition;
             }
             snprintf(str, slen, "%d", GET_MANA(c));
           }
-          else if (!str_cmp(field, "master")) {
+          else if (fid == DGF_MASTER) {
             if (!c->master)
               *str = '\0';
             else
               snprintf(str, slen, "%c%ld", UID_CHAR, char_script_id(c->master));
           }
-          else if (!str_cmp(field, "maxhitp")) {
+          else if (fid == DGF_MAXHITP) {
             if (subfield && *subfield) {
               int addition = atoi(subfield);
               GET_MAX_HIT(c) = MAX(GET_MAX_HIT(c) + addition, 1);
             }
             snprintf(str, slen, "%d", GET_MAX_HIT(c));
           }
-          else if (!str_cmp(field, "maxmana")) {
+          else if (fid == DGF_MAXMANA) {
             if (subfield && *subfield) {
               int addition = atoi(subfield);
               GET_MAX_MANA(c) = MAX(GET_MAX_MANA(c) + addition, 1);
             }
             snprintf(str, slen, "%d", GET_MAX_MANA(c));
           }
-          else if (!str_cmp(field, "maxmove")) {
+          else if (fid == DGF_MAXMOVE) {
             if (subfield && *subfield) {
               int addition = atoi(subfield);
               GET_MAX_MOVE(c) = MAX(GET_MAX_MOVE(c) + addition, 1);
             }
             snprintf(str, slen, "%d", GET_MAX_MOVE(c));
           }
-          else if (!str_cmp(field, "move")) {
+          else if (fid == DGF_MOVE) {
             if (subfield && *subfield) {
               int addition = atoi(subfield);
               GET_MOVE(c) += addition;
@@ -903,16 +1150,16 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
           }
           break;
         case 'n':
-          if (!str_cmp(field, "name"))
+          if (fid == DGF_NAME)
             snprintf(str, slen, "%s", GET_NAME(c));
 
-          else if (!str_cmp(field, "next_in_room")) {
+          else if (fid == DGF_NEXT_IN_ROOM) {
             if (c->next_in_room)
               snprintf(str, slen,"%c%ld",UID_CHAR, char_script_id(c->next_in_room));
             else
               *str = '\0';
           }
-          else if (!str_cmp(field, "npcflag")) {
+          else if (fid == DGF_NPCFLAG) {
             if (subfield && *subfield) {
                char buf[MAX_STRING_LENGTH];
                sprintbitarray(MOB_FLAGS(c), action_bits, PM_ARRAY_MAX, buf);
@@ -929,7 +1176,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
         case 'p':
           /* Thanks to Christian Ejlertsen for this idea
              And to Ken Ray for speeding the implementation up :)*/
-          if (!str_cmp(field, "pos")) {
+          if (fid == DGF_POS) {
             if (subfield && *subfield) {
               for (i = POS_SLEEPING; i <= POS_STANDING; i++) {
                 /* allows : Sleeping, Resting, Sitting, Fighting, Standing */
@@ -941,14 +1188,14 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
             }
             snprintf(str, slen, "%s", position_types[GET_POS(c)]);
           }
-          else if (!str_cmp(field, "prac")) {
+          else if (fid == DGF_PRAC) {
             if (subfield && *subfield) {
               int addition = atoi(subfield);
               GET_PRACTICES(c) = MAX(0, GET_PRACTICES(c) + addition);
             }
             snprintf(str, slen, "%d", GET_PRACTICES(c));
           }
-          else if (!str_cmp(field, "pref")) {
+          else if (fid == DGF_PREF) {
             if (subfield && *subfield) {
               int pref = get_flag_by_name(preference_bits, subfield);
               if (!IS_NPC(c) && pref != NOFLAG && PRF_FLAGGED(c, pref))
@@ -960,8 +1207,8 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
           }
           break;
         case 'q':
-          if (!IS_NPC(c) && (!str_cmp(field, "questpoints") ||
-              !str_cmp(field, "qp") || !str_cmp(field, "qpnts")))
+          if (!IS_NPC(c) && (fid == DGF_QUESTPOINTS ||
+              fid == DGF_QP || fid == DGF_QPNTS))
           {
             if (subfield && *subfield) {
               int addition = atoi(subfield);
@@ -969,14 +1216,14 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
             }
             snprintf(str, slen, "%d", GET_QUESTPOINTS(c));
           }
-           else if (!str_cmp(field, "quest"))
+           else if (fid == DGF_QUEST)
            {
                if (!IS_NPC(c) && (GET_QUEST(c) != NOTHING) && (real_quest(GET_QUEST(c)) != NOTHING))
                  snprintf(str, slen, "%d", GET_QUEST(c));
                else
                  strcpy(str, "0");
              }
-           else if (!str_cmp(field, "questdone"))
+           else if (fid == DGF_QUESTDONE)
            {
                if (!IS_NPC(c) && subfield && *subfield) {
                  int q_num = atoi(subfield);
@@ -990,9 +1237,9 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
              }
           break;
         case 'r':
-          if (!str_cmp(field, "race"))
+          if (fid == DGF_RACE)
             sprinttype(GET_RACE(c), pc_race_types, str, slen);
-          else if (!str_cmp(field, "room")) {  /* in NOWHERE, return the void */
+          else if (fid == DGF_ROOM) {  /* in NOWHERE, return the void */
 /* see note in dg_scripts.h */
 #ifdef ACTOR_ROOM_IS_UID
             snprintf(str, slen, "%c%ld",UID_CHAR,
@@ -1003,46 +1250,46 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
           }
           break;
         case 's':
-          if (!str_cmp(field, "saving_breath")) {
+          if (fid == DGF_SAVING_BREATH) {
             if (subfield && *subfield) {
               int addition = atoi(subfield);
               GET_SAVE(c, SAVING_BREATH) += addition;
             }
             snprintf(str, slen, "%d", GET_SAVE(c, SAVING_BREATH));
           }
-          else if (!str_cmp(field, "saving_para")) {
+          else if (fid == DGF_SAVING_PARA) {
             if (subfield && *subfield) {
               int addition = atoi(subfield);
               GET_SAVE(c, SAVING_PARA) += addition;
             }
             snprintf(str, slen, "%d", GET_SAVE(c, SAVING_PARA));
           }
-          else if (!str_cmp(field, "saving_petri")) {
+          else if (fid == DGF_SAVING_PETRI) {
             if (subfield && *subfield) {
               int addition = atoi(subfield);
               GET_SAVE(c, SAVING_PETRI) += addition;
             }
             snprintf(str, slen, "%d", GET_SAVE(c, SAVING_PETRI));
           }
-          else if (!str_cmp(field, "saving_rod")) {
+          else if (fid == DGF_SAVING_ROD) {
             if (subfield && *subfield) {
               int addition = atoi(subfield);
               GET_SAVE(c, SAVING_ROD) += addition;
             }
             snprintf(str, slen, "%d", GET_SAVE(c, SAVING_ROD));
           }
-          else if (!str_cmp(field, "saving_spell")) {
+          else if (fid == DGF_SAVING_SPELL) {
             if (subfield && *subfield) {
               int addition = atoi(subfield);
               GET_SAVE(c, SAVING_SPELL) += addition;
             }
             snprintf(str, slen, "%d", GET_SAVE(c, SAVING_SPELL));
           }
-          else if (!str_cmp(field, "sex"))
+          else if (fid == DGF_SEX)
             snprintf(str, slen, "%s", genders[(int)GET_SEX(c)]);
-          else if (!str_cmp(field, "skill"))
+          else if (fid == DGF_SKILL)
             snprintf(str, slen, "%s", skill_percent(c, subfield));
-          else if (!str_cmp(field, "skillset")) {
+          else if (fid == DGF_SKILLSET) {
             if (!IS_NPC(c) && subfield && *subfield) {
               char skillname[MAX_INPUT_LENGTH], *amount;
               amount = one_word(subfield, skillname);
@@ -1057,7 +1304,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
             }
             *str = '\0'; /* so the parser know we recognize 'skillset' as a field */
           }
-          else if (!str_cmp(field, "str")) {
+          else if (fid == DGF_STR) {
             if (subfield && *subfield) {
               int addition = atoi(subfield);
               int max = (IS_NPC(c) || GET_LEVEL(c) >= LVL_GRGOD) ? 25 : 18;
@@ -1068,7 +1315,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
             }
             snprintf(str, slen, "%d", GET_STR(c));
           }
-          else if (!str_cmp(field, "stradd")) {
+          else if (fid == DGF_STRADD) {
             if (GET_STR(c) >= 18) {
               if (subfield && *subfield) {
                 int addition = atoi(subfield);
@@ -1082,14 +1329,14 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
           }
           break;
         case 't':
-          if (!str_cmp(field, "thirst")) {
+          if (fid == DGF_THIRST) {
             if (subfield && *subfield) {
               int addition = atoi(subfield);
               GET_COND(c, THIRST) = MAX(-1, MIN(addition, 24));
             }
             snprintf(str, slen, "%d", GET_COND(c, THIRST));
           }
-          else if (!str_cmp(field, "title")) {
+          else if (fid == DGF_TITLE) {
             if (!IS_NPC(c) && subfield && *subfield && valid_dg_target(c, DG_ALLOW_GODS)) {
               if (GET_TITLE(c)) free(GET_TITLE(c));
                 GET_TITLE(c) = strdup(subfield);
@@ -1098,17 +1345,18 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
           }
           break;
 	case 'v':
-          if (!str_cmp(field, "varexists")) {
+          if (fid == DGF_VAREXISTS) {
             struct trig_var_data *remote_vd;
+            unsigned long hash = var_hash(subfield);
             strcpy(str, "0");
             if (SCRIPT(c)) {
               for (remote_vd = SCRIPT(c)->global_vars; remote_vd; remote_vd = remote_vd->next) {
-                if (!str_cmp(remote_vd->name, subfield)) break;
+                if (remote_vd->hash == hash && !str_cmp(remote_vd->name, subfield)) break;
               }
               if (remote_vd) strcpy(str, "1");
             }
           }
-          else if (!str_cmp(field, "vnum")) {
+          else if (fid == DGF_VNUM) {
             if (subfield && *subfield) {
              /* When this had -1 at the end of the line it returned true for PC's if you did
               * something like if %actor.vnum(500)%. It should return false for PC's instead 
@@ -1129,9 +1377,9 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
           }
           break;
         case 'w':
-          if (!str_cmp(field, "weight"))
+          if (fid == DGF_WEIGHT)
             snprintf(str, slen, "%d", GET_WEIGHT(c));
-          else if (!str_cmp(field, "wis")) {
+          else if (fid == DGF_WIS) {
             if (subfield && *subfield) {
               int addition = atoi(subfield);
               int max = (IS_NPC(c) || GET_LEVEL(c) >= LVL_GRGOD) ? 25 : 18;
@@ -1143,7 +1391,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
             snprintf(str, slen, "%d", GET_WIS(c));
           }
           
-          else if (!str_cmp(field, "wait")) 
+          else if (fid == DGF_WAIT) 
           {
             if (subfield && *subfield)
             {
@@ -1159,7 +1407,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
       if (*str == '\x1') { /* no match found in switch */
         if (SCRIPT(c)) {
           for (vd = (SCRIPT(c))->global_vars; vd; vd = vd->next)
-            if (!str_cmp(vd->name, field))
+            if (vd->hash == fhash && !str_cmp(vd->name, field))
               break;
           if (vd)
             snprintf(str, slen, "%s", vd->value);
@@ -1181,7 +1429,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
       *str = '\x1';
       switch (LOWER(*field)) {
         case 'a':
-          if (!str_cmp(field, "affects")) {
+          if (fid == DGF_AFFECTS) {
             if (subfield && *subfield) {
               if (check_flags_by_name_ar(GET_OBJ_AFFECT(o), NUM_AFF_FLAGS, subfield, affected_bits) == TRUE)
                 snprintf(str, slen, "1");
@@ -1191,7 +1439,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
               snprintf(str, slen, "0");
           }
 	case 'c':
-          if (!str_cmp(field, "cost")) {
+          if (fid == DGF_COST) {
             if (subfield && *subfield) {
               int addition = atoi(subfield);
               GET_OBJ_COST(o) = MAX(1, addition + GET_OBJ_COST(o));
@@ -1199,7 +1447,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
             snprintf(str, slen, "%d", GET_OBJ_COST(o));
           }
 
-          else if (!str_cmp(field, "cost_per_day")) {
+          else if (fid == DGF_COST_PER_DAY) {
             if (subfield && *subfield) {
               int addition = atoi(subfield);
               GET_OBJ_RENT(o) = MAX(1, addition + GET_OBJ_RENT(o));
@@ -1207,21 +1455,21 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
             snprintf(str, slen, "%d", GET_OBJ_RENT(o));
           }
 
-          else if (!str_cmp(field, "carried_by")) {
+          else if (fid == DGF_CARRIED_BY) {
             if (o->carried_by)
               snprintf(str, slen,"%c%ld",UID_CHAR, char_script_id(o->carried_by));
             else
               *str = '\0';
           }
 
-          else if (!str_cmp(field, "contents")) {
+          else if (fid == DGF_CONTENTS) {
             if (o->contains)
               snprintf(str, slen, "%c%ld", UID_CHAR, obj_script_id(o->contains));
             else
               *str = '\0';
           }
           /* thanks to Jamie Nelson (Mordecai of 4 Dimensions MUD) */
-          else if (!str_cmp(field, "count")) {
+          else if (fid == DGF_COUNT) {
             if (GET_OBJ_TYPE(o) == ITEM_CONTAINER)
               snprintf(str, slen, "%d", item_in_list(subfield, o->contains));
             else
@@ -1229,7 +1477,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
           }
           break;
         case 'e':
-          if (!str_cmp(field, "extra")) {
+          if (fid == DGF_EXTRA) {
             if (subfield && *subfield) {
               if (check_flags_by_name_ar(GET_OBJ_EXTRA(o), NUM_ITEM_FLAGS, subfield, extra_bits) > 0)
                 snprintf(str, slen, "1");
@@ -1242,13 +1490,13 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
           break;
 	case 'h':
           /* thanks to Jamie Nelson (Mordecai of 4 Dimensions MUD) */
-          if (!str_cmp(field, "has_in")) {
+          if (fid == DGF_HAS_IN) {
             if (GET_OBJ_TYPE(o) == ITEM_CONTAINER)
               snprintf(str, slen, "%s", (item_in_list(subfield, o->contains) ? "1" : "0"));
             else
               strcpy(str, "0");
           }
-          else if (!str_cmp(field, "hasattached")) {
+          else if (fid == DGF_HASATTACHED) {
             if (!(subfield && *subfield))
               *str = '\0';
             else {
@@ -1258,24 +1506,24 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
           }
           break;
         case 'i':
-          if (!str_cmp(field, "id"))
+          if (fid == DGF_ID)
             snprintf(str, slen, "%ld", obj_script_id(o));
 
-          else if (!str_cmp(field, "is_inroom")) {
+          else if (fid == DGF_IS_INROOM) {
             if (IN_ROOM(o) != NOWHERE)
               snprintf(str, slen,"%c%ld",UID_CHAR, room_script_id(world + IN_ROOM(o)));
             else
               *str = '\0';
           }
-          else if (!str_cmp(field, "is_pc")) {
+          else if (fid == DGF_IS_PC) {
             strcpy(str, "-1");
           }
 	  break;
         case 'n':
-          if (!str_cmp(field, "name"))
+          if (fid == DGF_NAME)
             snprintf(str, slen, "%s",  o->name);
 
-          else if (!str_cmp(field, "next_in_list")) {
+          else if (fid == DGF_NEXT_IN_LIST) {
             if (o->next_content)
               snprintf(str, slen,"%c%ld",UID_CHAR, obj_script_id(o->next_content));
             else
@@ -1283,7 +1531,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
           }
           break;
         case 'o':
-          if (!str_cmp(field, "oset")) {
+          if (fid == DGF_OSET) {
             if (subfield && *subfield) {
               if (handle_oset(o, subfield))
                 strcpy(str, "1");
@@ -1293,7 +1541,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
           }
           break;
         case 'r':
-          if (!str_cmp(field, "room")) {
+          if (fid == DGF_ROOM) {
             if (obj_room(o) != NOWHERE)
               snprintf(str, slen,"%c%ld",UID_CHAR, room_script_id(world + obj_room(o)));
             else
@@ -1301,37 +1549,37 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
           }
           break;
         case 's':
-          if (!str_cmp(field, "shortdesc"))
+          if (fid == DGF_SHORTDESC)
             snprintf(str, slen, "%s",  o->short_description);
           break;
         case 't':
-          if (!str_cmp(field, "type"))
+          if (fid == DGF_TYPE)
             sprinttype(GET_OBJ_TYPE(o), item_types, str, slen);
 
-          else if (!str_cmp(field, "timer"))
-            snprintf(str, slen, "%d", GET_OBJ_TIMER(o));
+          else if (fid == DGF_TIMER)
+            snprintf(str, slen, "%d", obj_timer(o));
           break;
         case 'v':
-          if (!str_cmp(field, "vnum"))
+          if (fid == DGF_VNUM)
             if (subfield && *subfield) {
               snprintf(str, slen, "%d", (int)(GET_OBJ_VNUM(o) == atoi(subfield)));
             } else {
               snprintf(str, slen, "%d", GET_OBJ_VNUM(o));
             }
-          else if (!str_cmp(field, "val0"))
+          else if (fid == DGF_VAL0)
             snprintf(str, slen, "%d", GET_OBJ_VAL(o, 0));
 
-          else if (!str_cmp(field, "val1"))
+          else if (fid == DGF_VAL1)
             snprintf(str, slen, "%d", GET_OBJ_VAL(o, 1));
 
-          else if (!str_cmp(field, "val2"))
+          else if (fid == DGF_VAL2)
             snprintf(str, slen, "%d", GET_OBJ_VAL(o, 2));
 
-          else if (!str_cmp(field, "val3"))
+          else if (fid == DGF_VAL3)
             snprintf(str, slen, "%d", GET_OBJ_VAL(o, 3));
           break;
         case 'w':
-          if (!str_cmp(field, "wearflag")) {
+          if (fid == DGF_WEARFLAG) {
 	    if (subfield && *subfield) {
 	      if (can_wear_on_pos(o, find_eq_pos_script(subfield)))
 	        snprintf(str, slen, "1");
@@ -1341,7 +1589,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
               snprintf(str, slen, "0");
 	  }
 
-	  else if (!str_cmp(field, "weight")){
+	  else if (fid == DGF_WEIGHT){
             if (subfield && *subfield) {
               int addition = atoi(subfield);
               GET_OBJ_WEIGHT(o) = MAX(1, addition + GET_OBJ_WEIGHT(o));
@@ -1349,7 +1597,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
             snprintf(str, slen, "%d", GET_OBJ_WEIGHT(o));
           }
 
-          else if (!str_cmp(field, "worn_by")) {
+          else if (fid == DGF_WORN_BY) {
             if (o->worn_by)
               snprintf(str, slen,"%c%ld",UID_CHAR, char_script_id(o->worn_by));
             else
@@ -1362,7 +1610,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
       if (*str == '\x1') { /* no match in switch */
         if (SCRIPT(o)) { /* check for global var */
           for (vd = (SCRIPT(o))->global_vars; vd; vd = vd->next)
-            if (!str_cmp(vd->name, field))
+            if (vd->hash == fhash && !str_cmp(vd->name, field))
               break;
           if (vd)
             snprintf(str, slen, "%s", vd->value);
@@ -1389,7 +1637,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
                      GET_TRIG_NAME(trig), GET_TRIG_VNUM(trig), type);
         } else {
           for (vd = (SCRIPT(r))->global_vars; vd; vd = vd->next)
-            if (!str_cmp(vd->name, field))
+            if (vd->hash == fhash && !str_cmp(vd->name, field))
               break;
           if (vd)
             snprintf(str, slen, "%s", vd->value);
@@ -1398,19 +1646,19 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
         }
       }
 
-      else if (!str_cmp(field, "name"))
+      else if (fid == DGF_NAME)
         snprintf(str, slen, "%s",  r->name);
 
-      else if (!str_cmp(field, "sector"))
+      else if (fid == DGF_SECTOR)
         sprinttype(r->sector_type, sector_types, str, slen);
 
-      else if (!str_cmp(field, "vnum")) {
+      else if (fid == DGF_VNUM) {
         if (subfield && *subfield) {
           snprintf(str, slen, "%d", (int)(r->number == atoi(subfield)));
         } else {
           snprintf(str, slen,"%d",r->number);
         }
-      } else if (!str_cmp(field, "contents")) {
+      } else if (fid == DGF_CONTENTS) {
         if (subfield && *subfield) {
           for (obj = r->contents; obj; obj = obj->next_content) {
             if (GET_OBJ_VNUM(obj) == atoi(subfield)) {
@@ -1430,20 +1678,20 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
         }
       }
 
-      else if (!str_cmp(field, "people")) {
+      else if (fid == DGF_PEOPLE) {
         if (r->people)
           snprintf(str, slen, "%c%ld", UID_CHAR, char_script_id(r->people));
         else
           *str = '\0';
       }
-      else if (!str_cmp(field, "id")) {
+      else if (fid == DGF_ID) {
         room_rnum rnum = real_room(r->number);
         if (rnum != NOWHERE)
           snprintf(str, slen, "%ld", room_script_id(world + rnum));
         else
           *str = '\0';
       }
-      else if (!str_cmp(field, "weather")) {
+      else if (fid == DGF_WEATHER) {
         const char *sky_look[] = {
           "sunny",
           "cloudy",
@@ -1456,7 +1704,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
         else
           *str = '\0';
       }
-      else if (!str_cmp(field, "hasattached")) {
+      else if (fid == DGF_HASATTACHED) {
         if (!(subfield && *subfield))
           *str = '\0';
         else {
@@ -1464,11 +1712,11 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
           snprintf(str, slen, "%d", trig_is_attached(SCRIPT(r), i));
         }
       }
-      else if (!str_cmp(field, "zonenumber"))
+      else if (fid == DGF_ZONENUMBER)
         snprintf(str, slen, "%d",  zone_table[r->zone].number);
-      else if (!str_cmp(field, "zonename"))
+      else if (fid == DGF_ZONENAME)
         snprintf(str, slen, "%s",  zone_table[r->zone].name);
-      else if (!str_cmp(field, "roomflag")) {
+      else if (fid == DGF_ROOMFLAG) {
         if (subfield && *subfield) {
           room_rnum thisroom = real_room(r->number);
           if (check_flags_by_name_ar(ROOM_FLAGS(thisroom), NUM_ROOM_FLAGS, subfield, room_bits) == TRUE)
@@ -1478,7 +1726,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
         } else
           snprintf(str, slen, "0");
       }
-      else if (!str_cmp(field, "north")) {
+      else if (fid == DGF_NORTH) {
         if (R_EXIT(r, NORTH)) {
           if (subfield && *subfield) {
             if (!str_cmp(subfield, "vnum"))
@@ -1498,7 +1746,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
         } else
           *str = '\0';
       }
-      else if (!str_cmp(field, "east")) {
+      else if (fid == DGF_EAST) {
         if (R_EXIT(r, EAST)) {
           if (subfield && *subfield) {
             if (!str_cmp(subfield, "vnum"))
@@ -1518,7 +1766,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
         } else
           *str = '\0';
       }
-      else if (!str_cmp(field, "south")) {
+      else if (fid == DGF_SOUTH) {
         if (R_EXIT(r, SOUTH)) {
           if (subfield && *subfield) {
             if (!str_cmp(subfield, "vnum"))
@@ -1538,7 +1786,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
         } else
           *str = '\0';
       }
-      else if (!str_cmp(field, "west")) {
+      else if (fid == DGF_WEST) {
         if (R_EXIT(r, WEST)) {
           if (subfield && *subfield) {
             if (!str_cmp(subfield, "vnum"))
@@ -1558,7 +1806,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
         } else
           *str = '\0';
       }
-      else if (!str_cmp(field, "up")) {
+      else if (fid == DGF_UP) {
         if (R_EXIT(r, UP)) {
           if (subfield && *subfield) {
             if (!str_cmp(subfield, "vnum"))
@@ -1578,7 +1826,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
         } else
           *str = '\0';
       }
-      else if (!str_cmp(field, "down")) {
+      else if (fid == DGF_DOWN) {
         if (R_EXIT(r, DOWN)) {
           if (subfield && *subfield) {
             if (!str_cmp(subfield, "vnum"))
@@ -1601,7 +1849,7 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
       else {
         if (SCRIPT(r)) { /* check for global var */
           for (vd = (SCRIPT(r))->global_vars; vd; vd = vd->next)
-            if (!str_cmp(vd->name, field))
+            if (vd->hash == fhash && !str_cmp(vd->name, field))
               break;
           if (vd)
             snprintf(str, slen, "%s", vd->value);
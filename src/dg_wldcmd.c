@@ -20,6 +20,8 @@
 #include "constants.h"
 #include "genzon.h" /* for zone_rnum real_zone_by_thing */
 #include "fight.h"  /* for die() */
+#include "strpool.h"
+#include "graph.h"
 
 /* Local functions, macros, defines and structs */
 
@@ -239,14 +241,15 @@ WCMD(do_wdoor)
     }
 
     newexit = rm->dir_option[dir];
+    invalidate_paths();
 
     /* purge exit */
     if (fd == 0) {
         if (newexit) {
             if (newexit->general_description)
-                free(newexit->general_description);
+                str_release(newexit->general_description);
             if (newexit->keyword)
-                free(newexit->keyword);
+                str_release(newexit->keyword);
             free(newexit);
             rm->dir_option[dir] = NULL;
         }
@@ -261,7 +264,7 @@ WCMD(do_wdoor)
         switch (fd) {
         case 1:  /* description */
             if (newexit->general_description)
-                free(newexit->general_description);
+                str_release(newexit->general_description);
             CREATE(newexit->general_description, char, strlen(value) + 3);
             strcpy(newexit->general_description, value);
             strcat(newexit->general_description, "\r\n");
@@ -274,7 +277,7 @@ WCMD(do_wdoor)
             break;
         case 4:  /* name        */
             if (newexit->keyword)
-                free(newexit->keyword);
+                str_release(newexit->keyword);
             CREATE(newexit->keyword, char, strlen(value) + 1);
             strcpy(newexit->keyword, value);
             break;
@@ -194,9 +194,9 @@ static void make_corpse(struct char_data *ch)
   GET_OBJ_WEIGHT(corpse) = GET_WEIGHT(ch) + IS_CARRYING_W(ch);
   GET_OBJ_RENT(corpse) = 100000;
   if (IS_NPC(ch))
-    GET_OBJ_TIMER(corpse) = CONFIG_MAX_NPC_CORPSE_TIME;
+    set_obj_timer(corpse, CONFIG_MAX_NPC_CORPSE_TIME);
   else
-    GET_OBJ_TIMER(corpse) = CONFIG_MAX_PC_CORPSE_TIME;
+    set_obj_timer(corpse, CONFIG_MAX_PC_CORPSE_TIME);
 
   /* transfer character's inventory to the corpse */
   corpse->contains = ch->carrying;
@@ -17,19 +17,20 @@
 #include "genzon.h"
 #include "dg_olc.h"
 #include "spells.h"
+#include "strpool.h"
 
 /* local functions */
 static void extract_mobile_all(mob_vnum vnum);
 
 int add_mobile(struct char_data *mob, mob_vnum vnum)
 {
-  int rnum, i, found = FALSE, shop, cmd_no;
-  zone_rnum zone;
+  int rnum;
   struct char_data *live_mob;
 
   if ((rnum = real_mobile(vnum)) != NOBODY) {
     /* Copy over the mobile and free() the old strings. */
     copy_mobile(&mob_proto[rnum], mob);
+    intern_mobile_strings(&mob_proto[rnum]);
 
     /* Now re-point all existing mobile strings to here. */
     for (live_mob = character_list; live_mob; live_mob = live_mob->next)
@@ -41,53 +42,22 @@ int add_mobile(struct char_data *mob, mob_vnum vnum)
     return rnum;
   }
 
-  RECREATE(mob_proto, struct char_data, top_of_mobt + 2);
-  RECREATE(mob_index, struct index_data, top_of_mobt + 2);
-  top_of_mobt++;
-
-  for (i = top_of_mobt; i > 0; i--) {
-    if (vnum > mob_index[i - 1].vnum) {
-      mob_proto[i] = *mob;
-      mob_proto[i].nr = i;
-      copy_mobile_strings(mob_proto + i, mob);
-      mob_index[i].vnum = vnum;
-      mob_index[i].number = 0;
-      mob_index[i].func = 0;
-      found = i;
-      break;
-    }
-    mob_index[i] = mob_index[i - 1];
-    mob_proto[i] = mob_proto[i - 1];
-    mob_proto[i].nr++;
-  }
-  if (!found) {
-    mob_proto[0] = *mob;
-    mob_proto[0].nr = 0;
-    copy_mobile_strings(&mob_proto[0], mob);
-    mob_index[0].vnum = vnum;
-    mob_index[0].number = 0;
-    mob_index[0].func = 0;
-  }
-
-  log("GenOLC: add_mobile: Added mobile %d at index #%d.", vnum, found);
+  /* New mobiles go at the end of the tables, so no live mobile, zone command
+   * or shop keeper has to be renumbered. */
+  rnum = new_table_entry(DB_BOOT_MOB);
+  mob_proto[rnum] = *mob;
+  mob_proto[rnum].nr = rnum;
+  copy_mobile_strings(mob_proto + rnum, mob);
+  intern_mobile_strings(mob_proto + rnum);
+  mob_index[rnum].vnum = vnum;
+  mob_index[rnum].number = 0;
+  mob_index[rnum].func = 0;
+  add_to_vnum_order(DB_BOOT_MOB, rnum);
 
-  /* Update live mobile rnums. */
-  for (live_mob = character_list; live_mob; live_mob = live_mob->next)
-    GET_MOB_RNUM(live_mob) += (GET_MOB_RNUM(live_mob) != NOTHING && GET_MOB_RNUM(live_mob) >= found);
-
-  /* Update zone table. */
-  for (zone = 0; zone <= top_of_zone_table; zone++)
-    for (cmd_no = 0; ZCMD(zone, cmd_no).command != 'S'; cmd_no++)
-      if (ZCMD(zone, cmd_no).command == 'M')
-	ZCMD(zone, cmd_no).arg1 += (ZCMD(zone, cmd_no).arg1 >= found);
-
-  /* Update shop keepers. */
-  if (shop_index)
-    for (shop = 0; shop <= top_shop; shop++)
-      SHOP_KEEPER(shop) += (SHOP_KEEPER(shop) != NOTHING && SHOP_KEEPER(shop) >= found);
+  log("GenOLC: add_mobile: Added mobile %d at index #%d.", vnum, rnum);
 
   add_to_save_list(zone_table[real_zone_by_thing(vnum)].number, SL_MOB);
-  return found;
+  return rnum;
 }
 
 int copy_mobile(struct char_data *to, struct char_data *from)
@@ -140,7 +110,6 @@ static void extract_mobile_all(mob_vnum vnum)
 
 int delete_mobile(mob_rnum refpt)
 {
-  struct char_data *live_mob;
   struct char_data *proto;
   int counter, cmd_no;
   mob_vnum vnum;
@@ -159,36 +128,25 @@ int delete_mobile(mob_rnum refpt)
   proto = &mob_proto[refpt];
   
   extract_mobile_all(vnum);
-  extract_char(proto);
 
-  for (counter = refpt; counter < top_of_mobt; counter++) {
-    mob_index[counter] = mob_index[counter + 1];
-    mob_proto[counter] = mob_proto[counter + 1];
-    mob_proto[counter].nr--;
-  }
-
-  top_of_mobt--;
-  RECREATE(mob_index, struct index_data, top_of_mobt + 1);
-  RECREATE(mob_proto, struct char_data, top_of_mobt + 1);
-
-  /* Update live mobile rnums. */
-  for (live_mob = character_list; live_mob; live_mob = live_mob->next)
-    GET_MOB_RNUM(live_mob) -= (GET_MOB_RNUM(live_mob) >= refpt);
-
-  /* Update zone table. */
+  /* Delete the zone commands that load it.  No other mobile moves, so
+   * nothing else is renumbered. */
   for (zone = 0; zone <= top_of_zone_table; zone++)
     for (cmd_no = 0; ZCMD(zone, cmd_no).command != 'S'; cmd_no++)
-      if (ZCMD(zone, cmd_no).command == 'M'){
-       if (ZCMD(zone, cmd_no).arg1 == refpt) {
-        delete_zone_command(&zone_table[zone], cmd_no);
-        } else
-          ZCMD(zone, cmd_no).arg1 -= (ZCMD(zone, cmd_no).arg1 > refpt);
-        }
-
-  /* Update shop keepers. */
+      if (ZCMD(zone, cmd_no).command == 'M' &&
+          ZCMD(zone, cmd_no).arg1 == refpt)
+        delete_zone_command(&zone_table[zone], cmd_no--);
+
+  /* Its shops are left without a keeper. */
   if (shop_index)
     for (counter = 0; counter <= top_shop; counter++)
-      SHOP_KEEPER(counter) -= (SHOP_KEEPER(counter) >= refpt);
+      if (SHOP_KEEPER(counter) == refpt)
+        SHOP_KEEPER(counter) = NOBODY;
+
+  /* The slot stays empty until OLC adds another mobile. */
+  free_mobile_strings(proto);
+  free_proto_script(proto, MOB_TRIGGER);
+  remove_from_vnum_order(DB_BOOT_MOB, refpt);
 
   save_mobiles(real_zone_by_thing(vnum));
 
@@ -212,8 +170,10 @@ int copy_mobile_strings(struct char_data *t, struct char_data *f)
 
 int update_mobile_strings(struct char_data *t, struct char_data *f)
 {
-  if (f->player.name)
+  if (f->player.name) {
     t->player.name = f->player.name;
+    t->player.keywords = f->player.keywords;
+  }
   if (f->player.title)
     t->player.title = f->player.title;
   if (f->player.short_descr)
@@ -225,18 +185,29 @@ int update_mobile_strings(struct char_data *t, struct char_data *f)
   return TRUE;
 }
 
+/* Moves a prototype's strings into the string pool.  The title is left
+ * alone, it is rarely set and never shared. */
+void intern_mobile_strings(struct char_data *mob)
+{
+  mob->player.name = str_intern_move(mob->player.name);
+  mob->player.keywords = str_keywords(mob->player.name);
+  mob->player.short_descr = str_intern_move(mob->player.short_descr);
+  mob->player.long_descr = str_intern_move(mob->player.long_descr);
+  mob->player.description = str_intern_move(mob->player.description);
+}
+
 int free_mobile_strings(struct char_data *mob)
 {
   if (mob->player.name)
-    free(mob->player.name);
+    str_release(mob->player.name);
   if (mob->player.title)
     free(mob->player.title);
   if (mob->player.short_descr)
-    free(mob->player.short_descr);
+    str_release(mob->player.short_descr);
   if (mob->player.long_descr)
-    free(mob->player.long_descr);
+    str_release(mob->player.long_descr);
   if (mob->player.description)
-    free(mob->player.description);
+    str_release(mob->player.description);
   return TRUE;
 }
 
@@ -26,6 +26,7 @@ int write_mobile_record(mob_vnum mvnum, struct char_data *mob, FILE *fd);
 int write_mobile_espec(mob_vnum mvnum, struct char_data *mob, FILE *fd);
 int free_mobile_strings(struct char_data *mob);
 int copy_mobile_strings(struct char_data *t, struct char_data *f);
+void intern_mobile_strings(struct char_data *mob);
 #if CONFIG_GENOLC_MOBPROG
 int write_mobile_mobprog(mob_vnum mvnum, struct char_data *mob, FILE *fd);
 #endif
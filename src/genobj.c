@@ -18,6 +18,7 @@
 #include "dg_olc.h"
 #include "handler.h"
 #include "interpreter.h"
+#include "strpool.h"
 
 /* local functions */
 static int update_all_objects(struct obj_data *obj);
@@ -30,13 +31,13 @@ obj_rnum add_object(struct obj_data *newobj, obj_vnum ovnum) {
   /* Write object to internal tables. */
   if ((newobj->item_number = real_object(ovnum)) != NOTHING) {
     copy_object(&obj_proto[newobj->item_number], newobj);
+    intern_object_strings(&obj_proto[newobj->item_number]);
     update_all_objects(&obj_proto[newobj->item_number]);
     add_to_save_list(zone_table[rznum].number, SL_OBJ);
     return newobj->item_number;
   }
 
   found = insert_object(newobj, ovnum);
-  adjust_objects(found);
   add_to_save_list(zone_table[rznum].number, SL_OBJ);
   return found;
 }
@@ -56,11 +57,13 @@ static int update_all_objects(struct obj_data *refobj) {
     count++;
 
     /* Update the existing object but save a copy for private information. */
+    clear_obj_timer(obj);
     swap = *obj;
     *obj = *refobj;
 
     /* Copy game-time dependent variables over. */
     obj->script_id = swap.script_id;
+    obj->script = swap.script;
     IN_ROOM(obj) = swap.in_room;
     obj->carried_by = swap.carried_by;
     obj->worn_by = swap.worn_by;
@@ -70,81 +73,21 @@ static int update_all_objects(struct obj_data *refobj) {
     obj->next_content = swap.next_content;
     obj->next = swap.next;
     obj->sitting_here = swap.sitting_here;
+    set_obj_timer(obj, GET_OBJ_TIMER(obj));
   }
 
   return count;
 }
 
-/* Adjust the internal values of other objects as if something was inserted at
- * the given array index. Might also be useful to make 'holes' in the array
- * for some reason. */
-obj_rnum adjust_objects(obj_rnum refpt) {
-  int shop, i, zone, cmd_no;
-  struct obj_data *obj;
-
-#if CIRCLE_UNSIGNED_INDEX
-  if (refpt == NOTHING || refpt > top_of_objt)
-#else
-  if (refpt < 0 || refpt > top_of_objt)
-#endif
-    return NOTHING;
-
-  /* Renumber live objects. */
-  for (obj = object_list; obj; obj = obj->next)
-    GET_OBJ_RNUM(obj) +=
-        (GET_OBJ_RNUM(obj) != NOTHING && GET_OBJ_RNUM(obj) >= refpt);
-
-  /* Renumber zone table. */
-  for (zone = 0; zone <= top_of_zone_table; zone++) {
-    for (cmd_no = 0; ZCMD(zone, cmd_no).command != 'S'; cmd_no++) {
-      switch (ZCMD(zone, cmd_no).command) {
-      case 'P':
-        ZCMD(zone, cmd_no).arg3 += (ZCMD(zone, cmd_no).arg3 >= refpt);
-        /* No break here - drop into next case. */
-      case 'O':
-      case 'G':
-      case 'E':
-        ZCMD(zone, cmd_no).arg1 += (ZCMD(zone, cmd_no).arg1 >= refpt);
-        break;
-      case 'R':
-        ZCMD(zone, cmd_no).arg2 += (ZCMD(zone, cmd_no).arg2 >= refpt);
-        break;
-      }
-    }
-  }
-
-  /* Renumber shop produce. */
-  for (shop = 0; shop <= top_shop; shop++)
-    for (i = 0; SHOP_PRODUCT(shop, i) != NOTHING; i++)
-      SHOP_PRODUCT(shop, i) += (SHOP_PRODUCT(shop, i) >= refpt);
-
-  return refpt;
-}
-
 /* Function handle the insertion of an object within the prototype framework.
- * Note that this does not adjust internal values of other objects, use
- * add_object() for that. */
+ * It goes at the end of the tables, so no other object, zone command or shop
+ * has to be renumbered. */
 obj_rnum insert_object(struct obj_data *obj, obj_vnum ovnum) {
-  obj_rnum i;
-
-  top_of_objt++;
-  RECREATE(obj_index, struct index_data, top_of_objt + 1);
-  RECREATE(obj_proto, struct obj_data, top_of_objt + 1);
-
-  /* Start counting through both tables. */
-  for (i = top_of_objt; i > 0; i--) {
-    /* Check if current virtual is bigger than our virtual number. */
-    if (ovnum > obj_index[i - 1].vnum)
-      return index_object(obj, ovnum, i);
-
-    /* Copy over the object that should be here. */
-    obj_index[i] = obj_index[i - 1];
-    obj_proto[i] = obj_proto[i - 1];
-    obj_proto[i].item_number = i;
-  }
+  obj_rnum i = new_table_entry(DB_BOOT_OBJ);
 
-  /* Not found, place at 0. */
-  return index_object(obj, ovnum, 0);
+  index_object(obj, ovnum, i);
+  add_to_vnum_order(DB_BOOT_OBJ, i);
+  return i;
 }
 
 obj_rnum index_object(struct obj_data *obj, obj_vnum ovnum, obj_rnum ornum) {
@@ -161,6 +104,7 @@ obj_rnum index_object(struct obj_data *obj, obj_vnum ovnum, obj_rnum ornum) {
   obj_index[ornum].func = NULL;
 
   copy_object_preserve(&obj_proto[ornum], obj);
+  intern_object_strings(&obj_proto[ornum]);
   obj_proto[ornum].in_room = NOWHERE;
 
   return ornum;
@@ -306,17 +250,27 @@ int save_objects(zone_rnum zone_num) {
 /* Free all, unconditionally. */
 void free_object_strings(struct obj_data *obj) {
   if (obj->name)
-    free(obj->name);
+    str_release(obj->name);
   if (obj->description)
-    free(obj->description);
+    str_release(obj->description);
   if (obj->short_description)
-    free(obj->short_description);
+    str_release(obj->short_description);
   if (obj->action_description)
-    free(obj->action_description);
+    str_release(obj->action_description);
   if (obj->ex_description)
     free_ex_descriptions(obj->ex_description);
 }
 
+/* Moves a prototype's strings into the string pool. */
+void intern_object_strings(struct obj_data *obj) {
+  obj->name = str_intern_move(obj->name);
+  obj->keywords = str_keywords(obj->name);
+  obj->description = str_intern_move(obj->description);
+  obj->short_description = str_intern_move(obj->short_description);
+  obj->action_description = str_intern_move(obj->action_description);
+  intern_ex_descriptions(obj->ex_description);
+}
+
 /* For object instances that are not the prototype. */
 void free_object_strings_proto(struct obj_data *obj) {
   int robj_num = GET_OBJ_RNUM(obj);
@@ -387,10 +341,9 @@ int copy_object_main(struct obj_data *to, struct obj_data *from,
 }
 
 int delete_object(obj_rnum rnum) {
-  obj_rnum i;
   zone_rnum zrnum;
   struct obj_data *obj, *tmp, *next_obj;
-  int shop, j, zone, cmd_no;
+  int shop, j, k, zone, cmd_no;
 
   if (rnum == NOTHING || rnum > top_of_objt)
     return NOTHING;
@@ -436,54 +389,45 @@ int delete_object(obj_rnum rnum) {
   /* Make sure all are removed. */
   assert(obj_index[rnum].number == 0);
 
-  /* Adjust rnums of all other objects. */
-  for (tmp = object_list; tmp; tmp = tmp->next) {
-    GET_OBJ_RNUM(tmp) -= (GET_OBJ_RNUM(tmp) > rnum);
-  }
-
-  for (i = rnum; i < top_of_objt; i++) {
-    obj_index[i] = obj_index[i + 1];
-    obj_proto[i] = obj_proto[i + 1];
-    obj_proto[i].item_number = i;
-  }
-
-  top_of_objt--;
-  RECREATE(obj_index, struct index_data, top_of_objt + 1);
-  RECREATE(obj_proto, struct obj_data, top_of_objt + 1);
-
-  /* Renumber shop produce. */
+  /* Take it off the shops that sell it.  No other object moves, so nothing
+   * else is renumbered. */
   for (shop = 0; shop <= top_shop; shop++)
     for (j = 0; SHOP_PRODUCT(shop, j) != NOTHING; j++)
-      SHOP_PRODUCT(shop, j) -= (SHOP_PRODUCT(shop, j) > rnum);
+      if (SHOP_PRODUCT(shop, j) == rnum) {
+        for (k = j; SHOP_PRODUCT(shop, k) != NOTHING; k++)
+          SHOP_PRODUCT(shop, k) = SHOP_PRODUCT(shop, k + 1);
+        j--;
+      }
 
-  /* Renumber zone table. */
+  /* Delete the zone commands that load it. */
   for (zone = 0; zone <= top_of_zone_table; zone++) {
     for (cmd_no = 0; ZCMD(zone, cmd_no).command != 'S'; cmd_no++) {
       switch (ZCMD(zone, cmd_no).command) {
       case 'P':
         if (ZCMD(zone, cmd_no).arg3 == rnum) {
-          delete_zone_command(&zone_table[zone], cmd_no);
-        } else
-          ZCMD(zone, cmd_no).arg3 -= (ZCMD(zone, cmd_no).arg3 > rnum);
+          delete_zone_command(&zone_table[zone], cmd_no--);
+          break;
+        }
         /* No break here - drop into next case. */
       case 'O':
       case 'G':
       case 'E':
-        if (ZCMD(zone, cmd_no).arg1 == rnum) {
-          delete_zone_command(&zone_table[zone], cmd_no);
-        } else
-          ZCMD(zone, cmd_no).arg1 -= (ZCMD(zone, cmd_no).arg1 > rnum);
+        if (ZCMD(zone, cmd_no).arg1 == rnum)
+          delete_zone_command(&zone_table[zone], cmd_no--);
         break;
       case 'R':
-        if (ZCMD(zone, cmd_no).arg2 == rnum) {
-          delete_zone_command(&zone_table[zone], cmd_no);
-        } else
-          ZCMD(zone, cmd_no).arg2 -= (ZCMD(zone, cmd_no).arg2 > rnum);
+        if (ZCMD(zone, cmd_no).arg2 == rnum)
+          delete_zone_command(&zone_table[zone], cmd_no--);
         break;
       }
     }
   }
 
+  /* The slot stays empty until OLC adds another object. */
+  free_object_strings(obj);
+  free_proto_script(obj, OBJ_TRIGGER);
+  remove_from_vnum_order(DB_BOOT_OBJ, rnum);
+
   save_objects(zrnum);
 
   return rnum;
@@ -26,6 +26,7 @@
 #include "act.h"        /* for the space_to_minus function */
 #include "modify.h"      /* for smash_tilde */
 #include "quest.h"
+#include "strpool.h"
 
 /* Global variables defined here, used elsewhere */
 /* List of zones to be saved. */
@@ -158,13 +159,23 @@ void free_ex_descriptions(struct extra_descr_data *head)
   for (thised = head; thised; thised = next_one) {
     next_one = thised->next;
     if (thised->keyword)
-      free(thised->keyword);
+      str_release(thised->keyword);
     if (thised->description)
-      free(thised->description);
+      str_release(thised->description);
     free(thised);
   }
 }
 
+/* Moves the strings of a finished extra description list into the string
+ * pool, for lists that now belong to the world or a prototype. */
+void intern_ex_descriptions(struct extra_descr_data *head)
+{
+  for (; head; head = head->next) {
+    head->keyword = str_intern_move(head->keyword);
+    head->description = str_intern_move(head->description);
+  }
+}
+
 int remove_from_save_list(zone_vnum zone, int type)
 {
   struct save_list_data *ritem, *temp;
@@ -25,6 +25,7 @@ char *str_udup(const char *);
 char *str_udupnl(const char *);
 void copy_ex_descriptions(struct extra_descr_data **to, struct extra_descr_data *from);
 void free_ex_descriptions(struct extra_descr_data *head);
+void intern_ex_descriptions(struct extra_descr_data *head);
 int sprintascii(char *out, bitvector_t bits);
 ACMD(do_export_zone);
 ACMD(do_show_save_list);
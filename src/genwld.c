@@ -18,6 +18,8 @@
 #include "shop.h"
 #include "dg_olc.h"
 #include "mud_event.h"
+#include "strpool.h"
+#include "graph.h"
 
 
 /* This function will copy the strings so be sure you free your own copies of 
@@ -26,7 +28,6 @@ room_rnum add_room(struct room_data *room)
 {
   struct char_data *tch;
   struct obj_data *tobj;
-  int j, found = FALSE;
   room_rnum i;
 
   if (room == NULL)
@@ -38,85 +39,30 @@ room_rnum add_room(struct room_data *room)
     tch = world[i].people;
     tobj = world[i].contents;
     copy_room(&world[i], room);
+    intern_room_strings(&world[i]);
     world[i].people = tch;
     world[i].contents = tobj;
+    invalidate_paths();
     add_to_save_list(zone_table[room->zone].number, SL_WLD);
     log("GenOLC: add_room: Updated existing room #%d.", room->number);
     return i;
   }
 
-  RECREATE(world, struct room_data, top_of_world + 2);
-  top_of_world++;
-
-  for (i = top_of_world; i > 0; i--) {
-    if (room->number > world[i - 1].number) {
-      world[i] = *room;
-      copy_room_strings(&world[i], room);
-      found = i;
-      break;
-    } else {
-      /* Copy the room over now. */
-      world[i] = world[i - 1];
-      update_wait_events(&world[i], &world[i-1]);
-
-      /* People in this room must have their in_rooms moved up one. */
-      for (tch = world[i].people; tch; tch = tch->next_in_room)
-	IN_ROOM(tch) += (IN_ROOM(tch) != NOWHERE);
-
-      /* Move objects too. */
-      for (tobj = world[i].contents; tobj; tobj = tobj->next_content)
-	IN_ROOM(tobj) += (IN_ROOM(tobj) != NOWHERE);
-    }
-  }
-  if (!found) {
-    world[0] = *room;	/* Last place, in front. */
-    copy_room_strings(&world[0], room);
-  }
-
-  log("GenOLC: add_room: Added room %d at index #%d.", room->number, found);
-  /* found is equal to the array index where we added the room. */
-
-  /* Find what zone that room was in so we can update the loading table. */
-  for (i = room->zone; i <= top_of_zone_table; i++)
-    for (j = 0; ZCMD(i, j).command != 'S'; j++)
-      switch (ZCMD(i, j).command) {
-      case 'M':
-      case 'O':
-      case 'T':
-      case 'V':
-	ZCMD(i, j).arg3 += (ZCMD(i, j).arg3 != NOWHERE && ZCMD(i, j).arg3 >= found);
-	break;
-      case 'D':
-      case 'R':
-	ZCMD(i, j).arg1 += (ZCMD(i, j).arg1 != NOWHERE && ZCMD(i, j).arg1 >= found);
-      case 'G':
-      case 'P':
-      case 'E':
-      case '*':
-	/* Known zone entries we don't care about. */
-        break;
-      default:
-        mudlog(BRF, LVL_GOD, TRUE, "SYSERR: GenOLC: add_room: Unknown zone entry found!");
-      }
+  /* New rooms go at the end of the world, so no rnum changes and nothing
+   * pointing at a room has to be renumbered. */
+  i = new_table_entry(DB_BOOT_WLD);
+  world[i] = *room;
+  copy_room_strings(&world[i], room);
+  intern_room_strings(&world[i]);
+  add_to_vnum_order(DB_BOOT_WLD, i);
+  invalidate_paths();
 
-  /* Update the loadroom table. Adds 1 or 0. */
-  r_mortal_start_room += (r_mortal_start_room >= found);
-  r_immort_start_room += (r_immort_start_room >= found);
-  r_frozen_start_room += (r_frozen_start_room >= found);
-
-  /* Update world exits. */
-  i = top_of_world + 1;
-  do {
-    i--;
-    for (j = 0; j < DIR_COUNT; j++)
-      if (W_EXIT(i, j) && W_EXIT(i, j)->to_room != NOWHERE)
-	W_EXIT(i, j)->to_room += (W_EXIT(i, j)->to_room >= found);
-  } while (i > 0);
+  log("GenOLC: add_room: Added room %d at index #%d.", room->number, i);
 
   add_to_save_list(zone_table[room->zone].number, SL_WLD);
 
   /* Return what array entry we placed the new room in. */
-  return found;
+  return i;
 }
 
 int delete_room(room_rnum rnum)
@@ -131,6 +77,7 @@ int delete_room(room_rnum rnum)
     return FALSE;
 
   room = &world[rnum];
+  invalidate_paths();
 
   add_to_save_list(zone_table[room->zone].number, SL_WLD);
 
@@ -179,24 +126,22 @@ int delete_room(room_rnum rnum)
     room->events = NULL;
   }
 
-  /* Change any exit going to this room to go the void. Also fix all the exits 
-   * pointing to rooms above this. */
+  /* Change any exit going to this room to go the void.  No other room moves,
+   * so no other exit has to change. */
   i = top_of_world + 1;
   do {
     i--;
     for (j = 0; j < DIR_COUNT; j++) {
       if (W_EXIT(i, j) == NULL)
         continue;
-      else if (W_EXIT(i, j)->to_room > rnum)
-        W_EXIT(i, j)->to_room -= (W_EXIT(i, j)->to_room != NOWHERE); /* with unsigned NOWHERE > any rnum */
       else if (W_EXIT(i, j)->to_room == rnum) {
       	if ((!W_EXIT(i, j)->keyword || !*W_EXIT(i, j)->keyword) &&
       	    (!W_EXIT(i, j)->general_description || !*W_EXIT(i, j)->general_description)) {
           /* no description, remove exit completely */
           if (W_EXIT(i, j)->keyword)
-            free(W_EXIT(i, j)->keyword);
+            str_release(W_EXIT(i, j)->keyword);
           if (W_EXIT(i, j)->general_description)
-            free(W_EXIT(i, j)->general_description);
+            str_release(W_EXIT(i, j)->general_description);
           free(W_EXIT(i, j));
           W_EXIT(i, j) = NULL;
         } else {
@@ -207,7 +152,7 @@ int delete_room(room_rnum rnum)
     }
   } while (i > 0);
 
-  /* Find what zone that room was in so we can update the loading table. */
+  /* Cancel the zone commands that load into this room. */
   for (i = 0; i <= top_of_zone_table; i++)
     for (j = 0; ZCMD(i , j).command != 'S'; j++)
       switch (ZCMD(i, j).command) {
@@ -217,15 +162,11 @@ int delete_room(room_rnum rnum)
       case 'V':
 	if (ZCMD(i, j).arg3 == rnum)
 	  ZCMD(i, j).command = '*';	/* Cancel command. */
-	else if (ZCMD(i, j).arg3 > rnum)
-	  ZCMD(i, j).arg3 -= (ZCMD(i, j).arg3 != NOWHERE); /* with unsigned NOWHERE > any rnum */
 	break;
       case 'D':
       case 'R':
 	if (ZCMD(i, j).arg1 == rnum)
 	  ZCMD(i, j).command = '*';	/* Cancel command. */
-	else if (ZCMD(i, j).arg1 > rnum)
-	  ZCMD(i, j).arg1 -= (ZCMD(i, j).arg1 != NOWHERE); /* with unsigned NOWHERE > any rnum */
       case 'G':
       case 'P':
       case 'E':
@@ -243,20 +184,9 @@ int delete_room(room_rnum rnum)
         SHOP_ROOM(i, j) = 0; /* set to the void */
     }
   }
-  /* Now we actually move the rooms down. */
-  for (i = rnum; i < top_of_world; i++) {
-    world[i] = world[i + 1];
-    update_wait_events(&world[i], &world[i+1]);
-
-    for (ppl = world[i].people; ppl; ppl = ppl->next_in_room)
-      IN_ROOM(ppl) -= (IN_ROOM(ppl) != NOWHERE);	/* Redundant check? */
-
-    for (obj = world[i].contents; obj; obj = obj->next_content)
-      IN_ROOM(obj) -= (IN_ROOM(obj) != NOWHERE);	/* Redundant check? */
-  }
 
-  top_of_world--;
-  RECREATE(world, struct room_data, top_of_world + 1);
+  /* The slot stays empty until OLC adds another room. */
+  remove_from_vnum_order(DB_BOOT_WLD, rnum);
 
   return TRUE;
 }
@@ -448,9 +378,9 @@ int free_room_strings(struct room_data *room)
 
   /* Free descriptions. */
   if (room->name)
-    free(room->name);
+    str_release(room->name);
   if (room->description)
-    free(room->description);
+    str_release(room->description);
   if (room->ex_description)
     free_ex_descriptions(room->ex_description);
 
@@ -458,10 +388,10 @@ int free_room_strings(struct room_data *room)
   for (i = 0; i < DIR_COUNT; i++) {
     if (room->dir_option[i]) {
       if (room->dir_option[i]->general_description)
-        free(room->dir_option[i]->general_description);
+        str_release(room->dir_option[i]->general_description);
 
       if (room->dir_option[i]->keyword)
-        free(room->dir_option[i]->keyword);
+        str_release(room->dir_option[i]->keyword);
 
       free(room->dir_option[i]);
       room->dir_option[i] = NULL;
@@ -470,3 +400,21 @@ int free_room_strings(struct room_data *room)
 
   return TRUE;
 }
+
+/* Moves a room's strings into the string pool once it is part of the world. */
+void intern_room_strings(struct room_data *room)
+{
+  int i;
+
+  room->name = str_intern_move(room->name);
+  room->description = str_intern_move(room->description);
+  intern_ex_descriptions(room->ex_description);
+
+  for (i = 0; i < DIR_COUNT; i++)
+    if (room->dir_option[i]) {
+      room->dir_option[i]->general_description =
+        str_intern_move(room->dir_option[i]->general_description);
+      room->dir_option[i]->keyword =
+        str_intern_move(room->dir_option[i]->keyword);
+    }
+}
@@ -19,5 +19,6 @@ int copy_room(struct room_data *to, struct room_data *from);
 room_rnum duplicate_room(room_vnum to, room_rnum from);
 int copy_room_strings(struct room_data *dest, struct room_data *source);
 int free_room_strings(struct room_data *);
+void intern_room_strings(struct room_data *room);
 
 #endif /* _GENWLD_H_ */
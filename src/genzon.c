@@ -202,6 +202,10 @@ rznum = i;
   zone->reset_mode = 2;
   zone->min_level = -1;
   zone->max_level = -1;
+  zone->players = 0;
+  zone->empty_for = 0;
+  zone->hibernating = FALSE;
+  zone->hibernated_at = 0;
 
   for (i=0; i<ZN_ARRAY_MAX; i++)  zone->zone_flags[i] = 0;
 
@@ -210,6 +214,7 @@ rznum = i;
   zone->cmd[0].command = 'S';
 
   top_of_zone_table++;
+  map_zone_vnums();
 
   add_to_save_list(zone->number, SL_ZON);
   return rznum;
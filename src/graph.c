@@ -24,25 +24,45 @@
 
 /* local functions */
 static int VALID_EDGE(room_rnum x, int y);
-static void bfs_enqueue(room_rnum room, int dir);
-static void bfs_dequeue(void);
-static void bfs_clear_queue(void);
-static int find_first_step(room_rnum src, room_rnum target);
+static void bfs_prepare(void);
 
 struct bfs_queue_struct {
   room_rnum room;
-  char dir;
-  struct bfs_queue_struct *next;
+  int dir;
+};
+
+/* The search state is sized to the world and kept between searches.  A room
+ * is visited in the current search when its stamp equals bfs_generation, so
+ * nothing has to be cleared beforehand, and as each room is queued at most
+ * once the queue never needs more slots than there are rooms. */
+static unsigned int *bfs_visited = NULL;
+static unsigned int bfs_generation = 0;
+static struct bfs_queue_struct *bfs_queue = NULL;
+static room_rnum bfs_rooms = 0;
+
+#if BFS_CACHE_SIZE > 0
+/* Recent answers, by source and target room.  Anything that changes which
+ * exits can be followed bumps bfs_version through invalidate_paths(), which
+ * retires every entry at once. */
+struct bfs_cache_struct {
+  room_rnum src, target;
+  int dir;
+  unsigned int version;
+  bool track_doors;
 };
 
-static struct bfs_queue_struct *queue_head = 0, *queue_tail = 0;
+static struct bfs_cache_struct bfs_cache[BFS_CACHE_SIZE];
+static unsigned int bfs_version = 1;
+#endif
 
 /* Utility macros */
-#define MARK(room)	(SET_BIT_AR(ROOM_FLAGS(room), ROOM_BFS_MARK))
-#define UNMARK(room)	(REMOVE_BIT_AR(ROOM_FLAGS(room), ROOM_BFS_MARK))
-#define IS_MARKED(room)	(ROOM_FLAGGED(room, ROOM_BFS_MARK))
+#define MARK(room)	(bfs_visited[(room)] = bfs_generation)
+#define IS_MARKED(room)	(bfs_visited[(room)] == bfs_generation)
 #define TOROOM(x, y)	(world[(x)].dir_option[(y)]->to_room)
 #define IS_CLOSED(x, y)	(EXIT_FLAGGED(world[(x)].dir_option[(y)], EX_CLOSED))
+#define BFS_CACHE_SLOT(src, target) \
+  (&bfs_cache[((((unsigned int)(src) * 2654435761U) ^ (unsigned int)(target)) * \
+               2654435761U >> 16) & (BFS_CACHE_SIZE - 1)])
 
 static int VALID_EDGE(room_rnum x, int y)
 {
@@ -56,46 +76,48 @@ static int VALID_EDGE(room_rnum x, int y)
   return 1;
 }
 
-static void bfs_enqueue(room_rnum room, int dir)
-{
-  struct bfs_queue_struct *curr;
-
-  CREATE(curr, struct bfs_queue_struct, 1);
-  curr->room = room;
-  curr->dir = dir;
-  curr->next = 0;
-
-  if (queue_tail) {
-    queue_tail->next = curr;
-    queue_tail = curr;
-  } else
-    queue_head = queue_tail = curr;
-}
-
-static void bfs_dequeue(void)
+/* Starts a new search, growing the search state if rooms were added. */
+static void bfs_prepare(void)
 {
-  struct bfs_queue_struct *curr;
-
-  curr = queue_head;
+  if (bfs_rooms != top_of_world + 1) {
+    if (bfs_visited)
+      free(bfs_visited);
+    if (bfs_queue)
+      free(bfs_queue);
+    bfs_rooms = top_of_world + 1;
+    CREATE(bfs_visited, unsigned int, bfs_rooms);
+    CREATE(bfs_queue, struct bfs_queue_struct, bfs_rooms);
+    bfs_generation = 0;
+  }
 
-  if (!(queue_head = queue_head->next))
-    queue_tail = 0;
-  free(curr);
+  /* Stamps are never reused without clearing them first. */
+  if (++bfs_generation == 0) {
+    memset(bfs_visited, 0, sizeof(unsigned int) * bfs_rooms);
+    bfs_generation = 1;
+  }
 }
 
-static void bfs_clear_queue(void)
+/* Forgets every cached path.  Call it whenever an exit is added, removed or
+ * redirected, a door opens or closes, or a room's NOTRACK flag changes. */
+void invalidate_paths(void)
 {
-  while (queue_head)
-    bfs_dequeue();
+#if BFS_CACHE_SIZE > 0
+  if (++bfs_version == 0)
+    bfs_version = 1;
+#endif
 }
 
 /* find_first_step: given a source room and a target room, find the first step 
  * on the shortest path from the source to the target. Intended usage: in 
  * mobile_activity, give a mob a dir to go if they're tracking another mob or a
- * PC.  Or, a 'track' skill for PCs. */
-static int find_first_step(room_rnum src, room_rnum target)
+ * PC.  Or, a 'track' skill for PCs.  Special procedures and scripts may use it
+ * as well; it allocates nothing once the world has been searched once. */
+int find_first_step(room_rnum src, room_rnum target)
 {
-  int curr_dir;
+#if BFS_CACHE_SIZE > 0
+  struct bfs_cache_struct *cached;
+#endif
+  int curr_dir, head, tail;
   room_rnum curr_room;
 
   if (src == NOWHERE || target == NOWHERE || src > top_of_world || target > top_of_world) {
@@ -105,9 +127,15 @@ static int find_first_step(room_rnum src, room_rnum target)
   if (src == target)
     return (BFS_ALREADY_THERE);
 
-  /* clear marks first, some OLC systems will save the mark. */
-  for (curr_room = 0; curr_room <= top_of_world; curr_room++)
-    UNMARK(curr_room);
+#if BFS_CACHE_SIZE > 0
+  cached = BFS_CACHE_SLOT(src, target);
+  if (cached->version == bfs_version && cached->src == src &&
+      cached->target == target && cached->track_doors == CONFIG_TRACK_T_DOORS)
+    return (cached->dir);
+#endif
+
+  bfs_prepare();
+  head = tail = 0;
 
   MARK(src);
 
@@ -115,26 +143,35 @@ static int find_first_step(room_rnum src, room_rnum target)
   for (curr_dir = 0; curr_dir < DIR_COUNT; curr_dir++)
     if (VALID_EDGE(src, curr_dir)) {
       MARK(TOROOM(src, curr_dir));
-      bfs_enqueue(TOROOM(src, curr_dir), curr_dir);
+      bfs_queue[tail].room = TOROOM(src, curr_dir);
+      bfs_queue[tail++].dir = curr_dir;
     }
 
   /* now, do the classic BFS. */
-  while (queue_head) {
-    if (queue_head->room == target) {
-      curr_dir = queue_head->dir;
-      bfs_clear_queue();
-      return (curr_dir);
-    } else {
-      for (curr_dir = 0; curr_dir < DIR_COUNT; curr_dir++)
-	if (VALID_EDGE(queue_head->room, curr_dir)) {
-	  MARK(TOROOM(queue_head->room, curr_dir));
-	  bfs_enqueue(TOROOM(queue_head->room, curr_dir), queue_head->dir);
-	}
-      bfs_dequeue();
-    }
+  while (head < tail) {
+    curr_room = bfs_queue[head].room;
+    if (curr_room == target)
+      break;
+    for (curr_dir = 0; curr_dir < DIR_COUNT; curr_dir++)
+      if (VALID_EDGE(curr_room, curr_dir)) {
+        MARK(TOROOM(curr_room, curr_dir));
+        bfs_queue[tail].room = TOROOM(curr_room, curr_dir);
+        bfs_queue[tail++].dir = bfs_queue[head].dir;
+      }
+    head++;
   }
 
-  return (BFS_NO_PATH);
+  curr_dir = head < tail ? bfs_queue[head].dir : BFS_NO_PATH;
+
+#if BFS_CACHE_SIZE > 0
+  cached->src = src;
+  cached->target = target;
+  cached->dir = curr_dir;
+  cached->version = bfs_version;
+  cached->track_doors = CONFIG_TRACK_T_DOORS;
+#endif
+
+  return (curr_dir);
 }
 
 /* Functions and Commands which use the above functions. */
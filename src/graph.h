@@ -14,7 +14,13 @@
 #ifndef _GRAPH_H_
 #define _GRAPH_H_
 
+/** Number of recent find_first_step() answers remembered; a power of two,
+ * or 0 to search every time. */
+#define BFS_CACHE_SIZE  1024
+
 ACMD(do_track);
 void hunt_victim(struct char_data *ch);
+int find_first_step(room_rnum src, room_rnum target);
+void invalidate_paths(void);
 
 #endif /* _GRAPH_H_*/
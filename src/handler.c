@@ -25,6 +25,7 @@
 #include "fight.h"
 #include "quest.h"
 #include "mud_event.h"
+#include "slab.h"
 
 /* local file scope variables */
 static int extractions_pending = 0;
@@ -84,8 +85,7 @@ int is_name(const char *str, const char *namelist)
 #define WHITESPACE " \t"
 int isname(const char *str, const char *namelist)
 {
-  char *newlist;
-  char *curtok;
+  size_t len, wordlen;
 
   if (!str || !*str || !namelist || !*namelist)
     return 0;
@@ -93,19 +93,99 @@ int isname(const char *str, const char *namelist)
   if (!strcmp(str, namelist)) /* the easy way */
     return 1;
 
-  newlist = strdup(namelist); /* make a copy since strtok 'modifies' strings */
-  for(curtok = strtok(newlist, WHITESPACE); curtok; curtok = strtok(NULL, WHITESPACE))
-    if(curtok && is_abbrev(str, curtok)) {
+  /* Each word is matched where it lies, rather than in a copy cut up by
+   * strtok(). */
+  len = strlen(str);
+  for (namelist += strspn(namelist, WHITESPACE); *namelist;
+       namelist += wordlen, namelist += strspn(namelist, WHITESPACE)) {
+    wordlen = strcspn(namelist, WHITESPACE);
+    if (len <= wordlen && !strn_cmp(str, namelist, len)) {
       /* Don't allow abbreviated numbers. - Sryth */
-      if (isdigit(*str) && (atoi(str) != atoi(curtok)))
+      if (isdigit(*str) && (atoi(str) != atoi(namelist)))
         return 0;
-      free(newlist);
       return 1;
     }
-  free(newlist);
+  }
   return 0;
 }
 
+/* isname() against a name already split by split_keywords(). */
+int isname_keywords(const char *str, const struct keyword_list *kw)
+{
+  const char *s, *w;
+  int i;
+
+  if (!str || !*str || !*kw->src)
+    return 0;
+
+  if (!strcmp(str, kw->src)) /* the easy way */
+    return 1;
+
+  for (i = 0; i < kw->count; i++) {
+    /* The words are lowercase already. */
+    for (s = str, w = kw->words[i]; *s && LOWER(*s) == *w; s++, w++)
+      ;
+    if (*s)
+      continue;
+    /* Don't allow abbreviated numbers. - Sryth */
+    if (isdigit(*str) && (atoi(str) != atoi(kw->words[i])))
+      return 0;
+    return 1;
+  }
+  return 0;
+}
+
+/* isname() against a character's or object's name.  The keyword list is
+ * only used while it was split from the name the thing has now; a restrung
+ * or player name is matched the slow way. */
+int isname_char(const char *str, struct char_data *ch)
+{
+  if (ch->player.keywords && ch->player.keywords->src == ch->player.name)
+    return isname_keywords(str, ch->player.keywords);
+
+  return isname(str, ch->player.name);
+}
+
+int isname_obj(const char *str, struct obj_data *obj)
+{
+  if (obj->keywords && obj->keywords->src == obj->name)
+    return isname_keywords(str, obj->keywords);
+
+  return isname(str, obj->name);
+}
+
+/* Splits a name into lowercased words for isname_keywords().  The list and
+ * the words are one allocation; free() it when done. */
+struct keyword_list *split_keywords(const char *namelist)
+{
+  struct keyword_list *kw;
+  const char *p;
+  char *mem, *text;
+  int count = 0, i;
+
+  for (p = namelist + strspn(namelist, WHITESPACE); *p;
+       p += strcspn(p, WHITESPACE), p += strspn(p, WHITESPACE))
+    count++;
+
+  CREATE(mem, char, sizeof(struct keyword_list) + count * sizeof(char *) +
+         strlen(namelist) + 1);
+  kw = (struct keyword_list *)mem;
+  kw->src = namelist;
+  kw->count = count;
+  kw->words = (char **)(kw + 1);
+  text = (char *)(kw->words + count);
+
+  for (i = 0, p = namelist + strspn(namelist, WHITESPACE); *p;
+       i++, p += strspn(p, WHITESPACE)) {
+    kw->words[i] = text;
+    for (; *p && !strchr(WHITESPACE, *p); p++)
+      *text++ = LOWER(*p);
+    *text++ = '\0';
+  }
+
+  return (kw);
+}
+
 static void aff_apply_modify(struct char_data *ch, byte loc, sbyte mod, char *msg)
 {
   switch (loc) {
@@ -278,18 +358,99 @@ void affect_total(struct char_data *ch)
   }
 }
 
+/* Timed affects in the order they wear off, keyed by the affect_update()
+ * pass that removes them, so a pass need only visit the characters that
+ * have something wearing off instead of counting down every affect. */
+static struct dg_queue *affect_queue = NULL;
+static long affect_clock = 0;	/* affect_update() passes so far */
+
+/* Starts an affect_update() pass. */
+void affect_tick(void)
+{
+  affect_clock++;
+}
+
+/* Returns a character with an affect to wear off on this pass, or NULL once
+ * there are none left. */
+struct char_data *next_affect_expiry(void)
+{
+  if (!affect_queue || queue_key(affect_queue) > affect_clock)
+    return (NULL);
+
+  return (affect_queue->heap[0]->data);
+}
+
+/* TRUE if af wears off on the current affect_update() pass. */
+bool affect_expired(struct affected_type *af)
+{
+  return (af->expiry != NULL && af->expires <= affect_clock);
+}
+
+/* What the duration of a character's affect has counted down to: -1 for a
+ * permanent affect, 0 during its last hour.  An affect held off the queue
+ * keeps what it has left in its duration field. */
+int affect_duration(struct affected_type *af)
+{
+  if (!af->expiry)
+    return (af->duration);
+
+  return (MAX(af->expires - affect_clock - 1, 0));
+}
+
+/* Puts a timed affect on the expiry queue to wear off once its duration has
+ * counted down. */
+static void queue_affect(struct char_data *ch, struct affected_type *af)
+{
+  if (!affect_queue)
+    affect_queue = queue_init();
+  af->expires = affect_clock + MAX(af->duration, 0) + 1;
+  af->expiry = queue_enq(affect_queue, ch, af->expires);
+}
+
+/* Takes a character's timed affects off the expiry queue while it is out of
+ * the game, at the menu, so they stop counting down. */
+void affect_hold(struct char_data *ch)
+{
+  struct affected_type *af;
+
+  for (af = ch->affected; af; af = af->next)
+    if (af->expiry) {
+      af->duration = affect_duration(af);
+      queue_deq(affect_queue, af->expiry);
+      af->expiry = NULL;
+    }
+}
+
+/* Puts held affects back on the expiry queue as a character enters the
+ * game. */
+void affect_resume(struct char_data *ch)
+{
+  struct affected_type *af;
+
+  for (af = ch->affected; af; af = af->next)
+    if (!af->expiry && af->duration != -1)
+      queue_affect(ch, af);
+}
+
 /* Insert an affect_type in a char_data structure. Automatically sets
  * apropriate bits and apply's */
 void affect_to_char(struct char_data *ch, struct affected_type *af)
 {
   struct affected_type *affected_alloc;
 
-  CREATE(affected_alloc, struct affected_type, 1);
+  affected_alloc = slab_alloc(&affect_slab);
 
   *affected_alloc = *af;
   affected_alloc->next = ch->affected;
   ch->affected = affected_alloc;
 
+  /* A duration of -1 never runs out; any other counts down once an hour and
+   * the affect goes on the pass after it reaches 0.  A character not yet in
+   * the world, such as one being loaded, holds it until affect_resume(). */
+  affected_alloc->expiry = NULL;
+  if (af->duration != -1 && IN_ROOM(ch) != NOWHERE)
+    queue_affect(ch, affected_alloc);
+
   affect_modify_ar(ch, af->location, af->modifier, af->bitvector, TRUE);
   affect_total(ch);
 }
@@ -308,7 +469,9 @@ void affect_remove(struct char_data *ch, struct affected_type *af)
 
   affect_modify_ar(ch, af->location, af->modifier, af->bitvector, FALSE);
   REMOVE_FROM_LIST(af, ch->affected, next);
-  free(af);
+  if (af->expiry)
+    queue_deq(affect_queue, af->expiry);
+  slab_free(&affect_slab, af);
   affect_total(ch);
 }
 
@@ -348,9 +511,9 @@ void affect_join(struct char_data *ch, struct affected_type *af,
 
     if ((hjp->spell == af->spell) && (hjp->location == af->location)) {
       if (add_dur)
-	af->duration += hjp->duration;
+	af->duration += affect_duration(hjp);
       else if (avg_dur)
-        af->duration = (af->duration+hjp->duration)/2;
+        af->duration = (af->duration+affect_duration(hjp))/2;
       if (add_mod)
 	af->modifier += hjp->modifier;
       else if (avg_mod)
@@ -365,6 +528,57 @@ void affect_join(struct char_data *ch, struct affected_type *af,
     affect_to_char(ch, af);
 }
 
+/* Whether ch counts as a player in the zone it stands in: for zone resets
+ * (is_empty()), random and time triggers, and hibernation.  Immortals with
+ * nohassle on do not, so that builders can watch a zone reset around them.
+ * A switched immortal counts where their own body is. */
+static bool counts_in_zone(struct char_data *ch)
+{
+  if (IS_NPC(ch) || world[IN_ROOM(ch)].zone == NOWHERE)
+    return (FALSE);
+  if (GET_LEVEL(ch) >= LVL_IMMORT && PRF_FLAGGED(ch, PRF_NOHASSLE))
+    return (FALSE);
+
+  return (TRUE);
+}
+
+static void count_zone_player(struct char_data *ch)
+{
+  zone_rnum zone = world[IN_ROOM(ch)].zone;
+
+  if (ch->char_specials.zone_counted || !counts_in_zone(ch))
+    return;
+
+  ch->char_specials.zone_counted = TRUE;
+  /* The first player into a zone wakes it up. */
+  if (zone_table[zone].players++ == 0) {
+    zone_table[zone].empty_for = 0;
+    if (zone_table[zone].hibernating)
+      wake_zone(zone);
+  }
+}
+
+static void uncount_zone_player(struct char_data *ch)
+{
+  if (!ch->char_specials.zone_counted)
+    return;
+
+  ch->char_specials.zone_counted = FALSE;
+  zone_table[world[IN_ROOM(ch)].zone].players--;
+}
+
+/* Recounts ch in its zone after a change to its level or nohassle flag. */
+void update_zone_presence(struct char_data *ch)
+{
+  if (IN_ROOM(ch) == NOWHERE)
+    return;
+
+  if (counts_in_zone(ch))
+    count_zone_player(ch);
+  else
+    uncount_zone_player(ch);
+}
+
 /* move a player out of a room */
 void char_from_room(struct char_data *ch)
 {
@@ -385,6 +599,8 @@ void char_from_room(struct char_data *ch)
       if (GET_OBJ_VAL(GET_EQ(ch, WEAR_LIGHT), 2))	/* Light is ON */
 	world[IN_ROOM(ch)].light--;
 
+  uncount_zone_player(ch);
+
   REMOVE_FROM_LIST(ch, world[IN_ROOM(ch)].people, next_in_room);
   IN_ROOM(ch) = NOWHERE;
   ch->next_in_room = NULL;
@@ -400,6 +616,7 @@ void char_to_room(struct char_data *ch, room_rnum room)
     ch->next_in_room = world[room].people;
     world[room].people = ch;
     IN_ROOM(ch) = room;
+    count_zone_player(ch);
 
     autoquest_trigger_check(ch, 0, 0, AQ_ROOM_FIND);
     autoquest_trigger_check(ch, 0, 0, AQ_MOB_FIND);
@@ -650,7 +867,7 @@ struct char_data *get_char_room(char *name, int *number, room_rnum room)
     return (NULL);
 
   for (i = world[room].people; i && *number; i = i->next_in_room)
-    if (isname(name, i->player.name))
+    if (isname_char(name, i))
       if (--(*number) == 0)
 	return (i);
 
@@ -783,6 +1000,8 @@ void extract_obj(struct obj_data *obj)
   struct char_data *ch, *next = NULL;
   struct obj_data *temp;
 
+  clear_obj_timer(obj);
+
   if (obj->worn_by != NULL)
     if (unequip_char(obj->worn_by, obj->worn_on) != obj)
       log("SYSERR: Inconsistent worn_by and worn_on pointers!!");
@@ -836,8 +1055,8 @@ void extract_obj(struct obj_data *obj)
 static void update_object(struct obj_data *obj, int use)
 {
   /* dont update objects with a timer trigger */
-  if (!SCRIPT_CHECK(obj, OTRIG_TIMER) && (GET_OBJ_TIMER(obj) > 0))
-    GET_OBJ_TIMER(obj) -= use;
+  if (!SCRIPT_CHECK(obj, OTRIG_TIMER) && (obj_timer(obj) > 0))
+    set_obj_timer(obj, obj_timer(obj) - use);
   if (obj->contains)
     update_object(obj->contains, use);
   if (obj->next_content)
@@ -975,6 +1194,8 @@ void extract_char_final(struct char_data *ch)
     if (SCRIPT_MEM(ch))
       extract_script_mem(SCRIPT_MEM(ch));
   } else {
+    /* Affects stop counting down at the menu. */
+    affect_hold(ch);
     save_char(ch);
     Crash_delete_crashfile(ch);
   }
@@ -1096,7 +1317,7 @@ struct char_data *get_char_room_vis(struct char_data *ch, char *name, int *numbe
     return (get_player_vis(ch, name, NULL, FIND_CHAR_ROOM));
 
   for (i = world[IN_ROOM(ch)].people; i && *number; i = i->next_in_room)
-    if (isname(name, i->player.name))
+    if (isname_char(name, i))
       if (CAN_SEE(ch, i))
 	if (--(*number) == 0)
 	  return (i);
@@ -1123,7 +1344,7 @@ struct char_data *get_char_world_vis(struct char_data *ch, char *name, int *numb
   for (i = character_list; i && *number; i = i->next) {
     if (IN_ROOM(ch) == IN_ROOM(i))
       continue;
-    if (!isname(name, i->player.name))
+    if (!isname_char(name, i))
       continue;
     if (!CAN_SEE(ch, i))
       continue;
@@ -1159,7 +1380,7 @@ struct obj_data *get_obj_in_list_vis(struct char_data *ch, char *name, int *numb
     return (NULL);
 
   for (i = list; i && *number; i = i->next_content)
-    if (isname(name, i->name))
+    if (isname_obj(name, i))
       if (CAN_SEE_OBJ(ch, i))
 	if (--(*number) == 0)
 	  return (i);
@@ -1191,7 +1412,7 @@ struct obj_data *get_obj_vis(struct char_data *ch, char *name, int *number)
 
   /* ok.. no luck yet. scan the entire obj list   */
   for (i = object_list; i && *number; i = i->next)
-    if (isname(name, i->name))
+    if (isname_obj(name, i))
       if (CAN_SEE_OBJ(ch, i))
 	if (--(*number) == 0)
 	  return (i);
@@ -1212,7 +1433,7 @@ struct obj_data *get_obj_in_equip_vis(struct char_data *ch, char *arg, int *numb
     return (NULL);
 
   for (j = 0; j < NUM_WEARS; j++)
-    if (equipment[j] && CAN_SEE_OBJ(ch, equipment[j]) && isname(arg, equipment[j]->name))
+    if (equipment[j] && CAN_SEE_OBJ(ch, equipment[j]) && isname_obj(arg, equipment[j]))
       if (--(*number) == 0)
         return (equipment[j]);
 
@@ -1232,7 +1453,7 @@ int get_obj_pos_in_equip_vis(struct char_data *ch, char *arg, int *number, struc
     return (-1);
 
   for (j = 0; j < NUM_WEARS; j++)
-    if (equipment[j] && CAN_SEE_OBJ(ch, equipment[j]) && isname(arg, equipment[j]->name))
+    if (equipment[j] && CAN_SEE_OBJ(ch, equipment[j]) && isname_obj(arg, equipment[j]))
       if (--(*number) == 0)
         return (j);
 
@@ -1372,7 +1593,7 @@ int generic_find(char *arg, bitvector_t bitvector, struct char_data *ch,
 
   if (IS_SET(bitvector, FIND_OBJ_EQUIP)) {
     for (found = FALSE, i = 0; i < NUM_WEARS && !found; i++)
-      if (GET_EQ(ch, i) && isname(name, GET_EQ(ch, i)->name) && --number == 0) {
+      if (GET_EQ(ch, i) && isname_obj(name, GET_EQ(ch, i)) && --number == 0) {
 	*tar_obj = GET_EQ(ch, i);
 	found = TRUE;
       }
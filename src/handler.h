@@ -18,6 +18,12 @@ void	affect_to_char(struct char_data *ch, struct affected_type *af);
 void	affect_remove(struct char_data *ch, struct affected_type *af);
 void	affect_from_char(struct char_data *ch, int type);
 bool	affected_by_spell(struct char_data *ch, int type);
+int	affect_duration(struct affected_type *af);
+bool	affect_expired(struct affected_type *af);
+void	affect_tick(void);
+void	affect_hold(struct char_data *ch);
+void	affect_resume(struct char_data *ch);
+struct char_data *next_affect_expiry(void);
 void	affect_join(struct char_data *ch, struct affected_type *af,
 bool add_dur, bool avg_dur, bool add_mod, bool avg_mod);
 
@@ -25,6 +31,10 @@ bool add_dur, bool avg_dur, bool add_mod, bool avg_mod);
 const char *money_desc(int amount);
 struct obj_data *create_money(int amount);
 int	isname(const char *str, const char *namelist);
+int	isname_keywords(const char *str, const struct keyword_list *kw);
+int	isname_char(const char *str, struct char_data *ch);
+int	isname_obj(const char *str, struct obj_data *obj);
+struct keyword_list *split_keywords(const char *namelist);
 int	is_name(const char *str, const char *namelist);
 char	*fname(const char *namelist);
 int	get_number(char **name);
@@ -53,6 +63,7 @@ struct char_data *get_char_num(mob_rnum nr);
 
 void	char_from_room(struct char_data *ch);
 void	char_to_room(struct char_data *ch, room_rnum room);
+void	update_zone_presence(struct char_data *ch);
 void	extract_char(struct char_data *ch);
 void	extract_char_final(struct char_data *ch);
 void	extract_pending_chars(void);
@@ -743,7 +743,7 @@ static struct obj_data *Obj_from_store(struct obj_file_elem object, int *locatio
   for(taeller = 0; taeller < EF_ARRAY_MAX; taeller++)
     GET_OBJ_EXTRA(obj)[taeller] = object.extra_flags[taeller];
   GET_OBJ_WEIGHT(obj) = object.weight;
-  GET_OBJ_TIMER(obj) = object.timer;
+  set_obj_timer(obj, object.timer);
   for(taeller = 0; taeller < AF_ARRAY_MAX; taeller++)
     GET_OBJ_AFFECT(obj)[taeller] = object.bitvector[taeller];
 
@@ -40,6 +40,7 @@
 #include "mud_event.h"
 #include "clan.h"
 #include "boards.h"
+#include "slab.h"
 
 /* local (file scope) functions */
 static int perform_dupe_check(struct descriptor_data *d);
@@ -50,12 +51,37 @@ static int _parse_name(char *arg, char *name);
 static bool perform_new_char_dupe_check(struct descriptor_data *d);
 /* sort_commands utility */
 static int sort_commands_helper(const void *a, const void *b);
+static void build_command_trie(void);
+static int find_command_trie_child(int node, char letter);
+static int add_command_trie_node(int parent, char letter);
+static int find_command_trie_node(const char *prefix);
+static int find_abbrev_command(struct char_data *ch, const char *arg);
 
 /* globals defined here, used here and elsewhere */
 int *cmd_sort_info = NULL;
 
 struct command_info *complete_cmd_info;
 
+/* Prefix trie over complete_cmd_info, so a typed abbreviation is resolved in
+ * O(length) instead of by scanning every command and social.  Nodes live in
+ * one array, node 0 being the root (the empty prefix). */
+struct cmd_trie_node {
+  char letter;  /* last character of the prefix this node stands for */
+  int child;    /* first child node, or -1 */
+  int sibling;  /* next node with the same parent, or -1 */
+  int exact;    /* first command named exactly this prefix, or -1 */
+  int first;    /* start of this node's commands in cmd_trie_cmds */
+  int count;    /* number of commands starting with this prefix */
+};
+
+static struct cmd_trie_node *cmd_trie = NULL;
+static int cmd_trie_nodes = 0, cmd_trie_max = 0;
+/* Every node's commands in the order command_interpreter() prefers them:
+ * regular commands before socials, each in complete_cmd_info order. */
+static int *cmd_trie_cmds = NULL;
+/* Index of the "\n" entry that ends complete_cmd_info. */
+static int cmd_trie_end = 0;
+
 /* This is the Master Command List. You can put new commands in, take commands
  * out, change the order they appear in, etc.  You can adjust the "priority"
  * of commands simply by changing the order they appear in the command list.
@@ -450,6 +476,8 @@ void sort_commands(void) {
     num_of_cmds++;
   num_of_cmds++; /* \n */
 
+  if (cmd_sort_info)
+    free(cmd_sort_info);
   CREATE(cmd_sort_info, int, num_of_cmds);
 
   for (a = 0; a < num_of_cmds; a++)
@@ -457,13 +485,151 @@ void sort_commands(void) {
 
   /* Don't sort the RESERVED or \n entries. */
   qsort(cmd_sort_info + 1, num_of_cmds - 2, sizeof(int), sort_commands_helper);
+
+  build_command_trie();
+}
+
+static int find_command_trie_child(int node, char letter) {
+  for (node = cmd_trie[node].child; node >= 0 && cmd_trie[node].letter < letter;
+       node = cmd_trie[node].sibling)
+    ;
+
+  return (node >= 0 && cmd_trie[node].letter == letter ? node : -1);
+}
+
+static int add_command_trie_node(int parent, char letter) {
+  int node, prev, next;
+
+  if ((node = find_command_trie_child(parent, letter)) >= 0)
+    return (node);
+
+  if (cmd_trie_nodes == cmd_trie_max) {
+    cmd_trie_max *= 2;
+    RECREATE(cmd_trie, struct cmd_trie_node, cmd_trie_max);
+  }
+
+  node = cmd_trie_nodes++;
+  cmd_trie[node].letter = letter;
+  cmd_trie[node].child = -1;
+  cmd_trie[node].exact = -1;
+  cmd_trie[node].first = cmd_trie[node].count = 0;
+
+  /* Keep siblings in character order. */
+  for (prev = -1, next = cmd_trie[parent].child;
+       next >= 0 && cmd_trie[next].letter < letter;
+       prev = next, next = cmd_trie[next].sibling)
+    ;
+  cmd_trie[node].sibling = next;
+  if (prev < 0)
+    cmd_trie[parent].child = node;
+  else
+    cmd_trie[prev].sibling = node;
+
+  return (node);
+}
+
+/* (Re)builds the command trie for the current complete_cmd_info. */
+static void build_command_trie(void) {
+  int pass, social, cmd, node, total = 0;
+  const char *c;
+
+  free_command_trie();
+
+  for (cmd_trie_end = 0; *complete_cmd_info[cmd_trie_end].command != '\n';
+       cmd_trie_end++)
+    ;
+
+  cmd_trie_max = 256;
+  cmd_trie_nodes = 1;
+  CREATE(cmd_trie, struct cmd_trie_node, cmd_trie_max);
+  cmd_trie[0].child = cmd_trie[0].sibling = cmd_trie[0].exact = -1;
+
+  /* Pass 0 creates the nodes and counts the commands under each, pass 1
+   * fills in the command lists.  Regular commands go in before socials so
+   * every list comes out in priority order. */
+  for (pass = 0; pass < 2; pass++) {
+    if (pass == 1) {
+      CREATE(cmd_trie_cmds, int, total);
+      for (node = 0, total = 0; node < cmd_trie_nodes; node++) {
+        cmd_trie[node].first = total;
+        total += cmd_trie[node].count;
+        cmd_trie[node].count = 0;
+      }
+    }
+
+    for (social = 0; social < 2; social++)
+      for (cmd = 0; cmd < cmd_trie_end; cmd++) {
+        if ((complete_cmd_info[cmd].command_pointer == do_action) != social)
+          continue;
+
+        for (node = 0, c = complete_cmd_info[cmd].command;; c++) {
+          if (pass == 1)
+            cmd_trie_cmds[cmd_trie[node].first + cmd_trie[node].count] = cmd;
+          cmd_trie[node].count++;
+          total++;
+
+          if (!*c)
+            break;
+          if (pass == 0)
+            node = add_command_trie_node(node, *c);
+          else
+            node = find_command_trie_child(node, *c);
+        }
+
+        if (pass == 0 && (cmd_trie[node].exact < 0 || cmd < cmd_trie[node].exact))
+          cmd_trie[node].exact = cmd;
+      }
+  }
+}
+
+void free_command_trie(void) {
+  if (cmd_trie)
+    free(cmd_trie);
+  if (cmd_trie_cmds)
+    free(cmd_trie_cmds);
+  cmd_trie = NULL;
+  cmd_trie_cmds = NULL;
+  cmd_trie_nodes = cmd_trie_max = 0;
+}
+
+/* Returns the trie node for a prefix, or -1 if no command starts with it.
+ * The trie is built on demand, since find_command() is used during boot
+ * before sort_commands() and right after the command list is rebuilt. */
+static int find_command_trie_node(const char *prefix) {
+  int node = 0;
+
+  if (!cmd_trie)
+    build_command_trie();
+
+  for (; *prefix && node >= 0; prefix++)
+    node = find_command_trie_child(node, *prefix);
+
+  return (node);
+}
+
+/* The command arg abbreviates: the first regular command, or failing that
+ * the first social, that starts with arg and that ch is allowed to use.
+ * Returns the index of the "\n" entry if there is none. */
+static int find_abbrev_command(struct char_data *ch, const char *arg) {
+  int node, i, cmd;
+
+  if ((node = find_command_trie_node(arg)) < 0)
+    return (cmd_trie_end);
+
+  for (i = 0; i < cmd_trie[node].count; i++) {
+    cmd = cmd_trie_cmds[cmd_trie[node].first + i];
+    if (GET_LEVEL(ch) >= complete_cmd_info[cmd].minimum_level)
+      return (cmd);
+  }
+
+  return (cmd_trie_end);
 }
 
 /* This is the actual command interpreter called from game_loop() in comm.c
  * It makes sure you are the proper level and position to execute the command,
  * then calls the appropriate function. */
 void command_interpreter(struct char_data *ch, char *argument) {
-  int cmd, length;
+  int cmd;
   char *line;
   char arg[MAX_INPUT_LENGTH];
 
@@ -503,43 +669,34 @@ void command_interpreter(struct char_data *ch, char *argument) {
       return;
   }
 
-  for (length = strlen(arg), cmd = 0; *complete_cmd_info[cmd].command != '\n';
-       cmd++)
-    if (complete_cmd_info[cmd].command_pointer != do_action &&
-        !strncmp(complete_cmd_info[cmd].command, arg, length))
-      if (GET_LEVEL(ch) >= complete_cmd_info[cmd].minimum_level)
-        break;
-
-  /* it's not a 'real' command, so it's a social */
-
-  if (*complete_cmd_info[cmd].command == '\n')
-    for (length = strlen(arg), cmd = 0; *complete_cmd_info[cmd].command != '\n';
-         cmd++)
-      if (complete_cmd_info[cmd].command_pointer == do_action &&
-          !strncmp(complete_cmd_info[cmd].command, arg, length))
-        if (GET_LEVEL(ch) >= complete_cmd_info[cmd].minimum_level)
-          break;
+  /* Regular commands take priority over socials. */
+  cmd = find_abbrev_command(ch, arg);
 
   if (*complete_cmd_info[cmd].command == '\n') {
-    int found = 0;
+    int found = 0, node, i;
     send_to_char(ch, "%s", CONFIG_HUH);
 
-    for (cmd = 0; *cmd_info[cmd].command != '\n'; cmd++) {
-      if (*arg != *cmd_info[cmd].command ||
-          cmd_info[cmd].minimum_level > GET_LEVEL(ch))
-        continue;
-
-      /* Only apply levenshtein counts if the command is not a trigger command.
-       */
-      if ((levenshtein_distance(arg, cmd_info[cmd].command) <= 2) &&
-          (cmd_info[cmd].minimum_level >= 0)) {
-        if (!found) {
-          send_to_char(ch, "\r\nDid you mean:\r\n");
-          found = 1;
+    /* Suggest regular commands sharing the first letter; socials are last in
+     * the trie lists. */
+    if ((node = find_command_trie_child(0, *arg)) >= 0)
+      for (i = 0; i < cmd_trie[node].count; i++) {
+        cmd = cmd_trie_cmds[cmd_trie[node].first + i];
+        if (complete_cmd_info[cmd].command_pointer == do_action)
+          break;
+        if (complete_cmd_info[cmd].minimum_level > GET_LEVEL(ch))
+          continue;
+
+        /* Only apply levenshtein counts if the command is not a trigger
+         * command. */
+        if ((levenshtein_distance(arg, complete_cmd_info[cmd].command) <= 2) &&
+            (complete_cmd_info[cmd].minimum_level >= 0)) {
+          if (!found) {
+            send_to_char(ch, "\r\nDid you mean:\r\n");
+            found = 1;
+          }
+          send_to_char(ch, "  %s\r\n", complete_cmd_info[cmd].command);
         }
-        send_to_char(ch, "  %s\r\n", cmd_info[cmd].command);
       }
-    }
   } else if (!IS_NPC(ch) && PLR_FLAGGED(ch, PLR_FROZEN) &&
              GET_LEVEL(ch) < LVL_IMPL)
     send_to_char(ch, "You try, but the mind-numbing cold prevents you...\r\n");
@@ -942,13 +1099,9 @@ void half_chop(char *string, char *arg1, char *arg2) {
 
 /* Used in specprocs, mostly.  (Exactly) matches "command" to cmd number */
 int find_command(const char *command) {
-  int cmd;
+  int node = find_command_trie_node(command);
 
-  for (cmd = 0; *complete_cmd_info[cmd].command != '\n'; cmd++)
-    if (!strcmp(complete_cmd_info[cmd].command, command))
-      return (cmd);
-
-  return (-1);
+  return (node >= 0 ? cmd_trie[node].exact : -1);
 }
 
 int special(struct char_data *ch, int cmd, char *arg) {
@@ -1254,6 +1407,7 @@ int enter_player_game(struct descriptor_data *d) {
   d->character->next = character_list;
   character_list = d->character;
   char_to_room(d->character, load_room);
+  affect_resume(d->character);
   load_result = Crash_load(d->character);
 
   /* set a clan, if applicable */
@@ -1347,7 +1501,7 @@ void nanny(struct descriptor_data *d, char *arg) {
     return;
   case CON_GET_NAME: /* wait for input of name */
     if (d->character == NULL) {
-      CREATE(d->character, struct char_data, 1);
+      d->character = slab_alloc(&char_slab);
       clear_char(d->character);
       CREATE(d->character->player_specials, struct player_special_data, 1);
 
@@ -1385,7 +1539,7 @@ void nanny(struct descriptor_data *d, char *arg) {
             write_to_output(d, "Invalid name, please try another.\r\nName: ");
             return;
           }
-          CREATE(d->character, struct char_data, 1);
+          d->character = slab_alloc(&char_slab);
           clear_char(d->character);
           CREATE(d->character->player_specials, struct player_special_data, 1);
 
@@ -1663,7 +1817,6 @@ void nanny(struct descriptor_data *d, char *arg) {
     /* Now GET_NAME() will work properly. */
     init_char(d->character);
     save_char(d->character);
-    save_player_index();
     write_to_output(d, "%s\r\n*** PRESS RETURN: ", motd);
     STATE(d) = CON_RMOTD;
     /* make sure the last log is updated correctly. */
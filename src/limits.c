@@ -26,6 +26,20 @@
 /* local file scope function prototypes */
 static int graf(int grafage, int p0, int p1, int p2, int p3, int p4, int p5, int p6);
 static void check_idling(struct char_data *ch);
+static int resting_in_hibernation(struct char_data *ch);
+static void timer_wheel_link(struct obj_data **link, struct obj_data *obj);
+static void decay_corpse(struct obj_data *j);
+
+/* Ticks point_update() has run, for catching up hibernating zones and for
+ * the object timer wheel. */
+static long point_ticks = 0;
+
+/* Objects with a timer running, in the slot of the pass it runs out on,
+ * so a tick only looks at the objects due instead of the whole object
+ * list.  A timer longer than the wheel is passed over once per turn. */
+#define TIMER_WHEEL_SIZE  256
+static struct obj_data *timer_wheel[TIMER_WHEEL_SIZE];
+static struct obj_data *timers_due = NULL;	/* this pass's, being fired */
 
 
 /* When age < 15 return the value p0
@@ -296,6 +310,7 @@ void gain_exp_regardless(struct char_data *ch, int gain)
       else
 	send_to_char(ch, "You rise %d levels!\r\n", num_levels);
       set_title(ch, NULL);
+      update_zone_presence(ch);
     }
   }
   if (GET_LEVEL(ch) >= LVL_IMMORT && !PLR_FLAGGED(ch, PLR_NOWIZLIST))
@@ -375,16 +390,139 @@ static void check_idling(struct char_data *ch)
   }
 }
 
+/* A healthy mob in a hibernating zone has nothing to do on a tick but
+ * regenerate, which wake_zone() makes up for in one go. */
+static int resting_in_hibernation(struct char_data *ch)
+{
+  return (IS_NPC(ch) && IN_ROOM(ch) != NOWHERE &&
+          world[IN_ROOM(ch)].zone != NOWHERE &&
+          zone_table[world[IN_ROOM(ch)].zone].hibernating &&
+          GET_POS(ch) >= POS_STUNNED && !AFF_FLAGGED(ch, AFF_POISON) &&
+          !FIGHTING(ch));
+}
+
+/* Called once a zone has been empty of players for CONFIG_HIBERNATE_TIME
+ * minutes.  Its mobs stop acting and regenerating until wake_zone(). */
+void hibernate_zone(zone_rnum zone)
+{
+  zone_table[zone].hibernating = TRUE;
+  zone_table[zone].hibernated_at = point_ticks;
+}
+
+/* A player has entered a hibernating zone: give its mobs the hit points,
+ * mana and moves they would have regained while it slept. */
+void wake_zone(zone_rnum zone)
+{
+  struct char_data *i;
+  long ticks = point_ticks - zone_table[zone].hibernated_at;
+
+  zone_table[zone].hibernating = FALSE;
+
+  if (ticks <= 0)
+    return;
+
+  for (i = character_list; i; i = i->next) {
+    if (!IS_NPC(i) || IN_ROOM(i) == NOWHERE || world[IN_ROOM(i)].zone != zone)
+      continue;
+    if (GET_POS(i) < POS_STUNNED || AFF_FLAGGED(i, AFF_POISON))
+      continue;
+    GET_HIT(i) = MIN(GET_HIT(i) + MIN(ticks, GET_MAX_HIT(i)) * hit_gain(i), GET_MAX_HIT(i));
+    GET_MANA(i) = MIN(GET_MANA(i) + MIN(ticks, GET_MAX_MANA(i)) * mana_gain(i), GET_MAX_MANA(i));
+    GET_MOVE(i) = MIN(GET_MOVE(i) + MIN(ticks, GET_MAX_MOVE(i)) * move_gain(i), GET_MAX_MOVE(i));
+  }
+}
+
+static void timer_wheel_link(struct obj_data **link, struct obj_data *obj)
+{
+  obj->next_timed = *link;
+  obj->timed_link = link;
+  if (*link)
+    (*link)->timed_link = &obj->next_timed;
+  *link = obj;
+}
+
+/* Takes an object off the timer wheel.  Done before it is extracted, or
+ * copied over, and whenever its timer changes. */
+void clear_obj_timer(struct obj_data *obj)
+{
+  if (!obj->timed_link)
+    return;
+
+  *obj->timed_link = obj->next_timed;
+  if (obj->next_timed)
+    obj->next_timed->timed_link = obj->timed_link;
+  obj->next_timed = NULL;
+  obj->timed_link = NULL;
+}
+
+/* Sets the timer of an object in the game.  A timer counts down once a
+ * tick: a corpse decays when it reaches 0, or on the next tick if it is
+ * already there, and anything else fires its timer trigger. */
+void set_obj_timer(struct obj_data *obj, int timer)
+{
+  clear_obj_timer(obj);
+  GET_OBJ_TIMER(obj) = timer;
+
+  if (timer > 0)
+    obj->timer_expires = point_ticks + timer;
+  else if (IS_CORPSE(obj))
+    obj->timer_expires = point_ticks + 1;
+  else
+    return;
+
+  timer_wheel_link(&timer_wheel[obj->timer_expires & (TIMER_WHEEL_SIZE - 1)], obj);
+}
+
+/* What the timer of an object in the game has counted down to. */
+int obj_timer(struct obj_data *obj)
+{
+  if (!obj->timed_link || GET_OBJ_TIMER(obj) <= 0)
+    return (GET_OBJ_TIMER(obj));
+
+  return (MAX(obj->timer_expires - point_ticks, 0));
+}
+
+static void decay_corpse(struct obj_data *j)
+{
+  struct obj_data *jj, *next_thing2;
+
+  if (j->carried_by)
+    act("$p decays in your hands.", FALSE, j->carried_by, j, 0, TO_CHAR);
+  else if ((IN_ROOM(j) != NOWHERE) && (world[IN_ROOM(j)].people)) {
+    act("A quivering horde of maggots consumes $p.",
+        TRUE, world[IN_ROOM(j)].people, j, 0, TO_ROOM);
+    act("A quivering horde of maggots consumes $p.",
+        TRUE, world[IN_ROOM(j)].people, j, 0, TO_CHAR);
+  }
+  for (jj = j->contains; jj; jj = next_thing2) {
+    next_thing2 = jj->next_content;	/* Next in inventory */
+    obj_from_obj(jj);
+
+    if (j->in_obj)
+      obj_to_obj(jj, j->in_obj);
+    else if (j->carried_by)
+      obj_to_room(jj, IN_ROOM(j->carried_by));
+    else if (IN_ROOM(j) != NOWHERE)
+      obj_to_room(jj, IN_ROOM(j));
+    else
+      core_dump();
+  }
+  extract_obj(j);
+}
+
 /* Update PCs, NPCs, and objects */
 void point_update(void)
 {
   struct char_data *i, *next_char;
-  struct obj_data *j, *next_thing, *jj, *next_thing2;
+  struct obj_data *j, *next_thing;
 
   /* characters */
   for (i = character_list; i; i = next_char) {
     next_char = i->next;
 
+    if (resting_in_hibernation(i))
+      continue;
+
     gain_condition(i, HUNGER, -1);
     gain_condition(i, DRUNK, -1);
     gain_condition(i, THIRST, -1);
@@ -413,48 +551,24 @@ void point_update(void)
     }
   }
 
-  /* objects */
-  for (j = object_list; j; j = next_thing) {
-    next_thing = j->next;	/* Next in object list */
-
-    /* If this is a corpse */
-    if (IS_CORPSE(j)) {
-      /* timer count down */
-      if (GET_OBJ_TIMER(j) > 0)
-	GET_OBJ_TIMER(j)--;
-
-      if (!GET_OBJ_TIMER(j)) {
-
-	if (j->carried_by)
-	  act("$p decays in your hands.", FALSE, j->carried_by, j, 0, TO_CHAR);
-	else if ((IN_ROOM(j) != NOWHERE) && (world[IN_ROOM(j)].people)) {
-	  act("A quivering horde of maggots consumes $p.",
-	      TRUE, world[IN_ROOM(j)].people, j, 0, TO_ROOM);
-	  act("A quivering horde of maggots consumes $p.",
-	      TRUE, world[IN_ROOM(j)].people, j, 0, TO_CHAR);
-	}
-	for (jj = j->contains; jj; jj = next_thing2) {
-	  next_thing2 = jj->next_content;	/* Next in inventory */
-	  obj_from_obj(jj);
-
-	  if (j->in_obj)
-	    obj_to_obj(jj, j->in_obj);
-	  else if (j->carried_by)
-	    obj_to_room(jj, IN_ROOM(j->carried_by));
-	  else if (IN_ROOM(j) != NOWHERE)
-	    obj_to_room(jj, IN_ROOM(j));
-	  else
-	    core_dump();
-	}
-	extract_obj(j);
-      }
+  /* objects: move this pass's slot aside, as firing one timer may purge or
+   * set the timers of others, then fire them */
+  point_ticks++;
+  for (j = timer_wheel[point_ticks & (TIMER_WHEEL_SIZE - 1)]; j; j = next_thing) {
+    next_thing = j->next_timed;
+    if (j->timer_expires <= point_ticks) {
+      clear_obj_timer(j);
+      timer_wheel_link(&timers_due, j);
     }
-    /* If the timer is set, count it down and at 0, try the trigger
-     * note to .rej hand-patchers: make this last in your point-update() */
-    else if (GET_OBJ_TIMER(j)>0) {
-      GET_OBJ_TIMER(j)--;
-      if (!GET_OBJ_TIMER(j))
-        timer_otrigger(j);
+  }
+
+  while ((j = timers_due) != NULL) {
+    clear_obj_timer(j);
+    if (IS_CORPSE(j))
+      decay_corpse(j);
+    else {
+      GET_OBJ_TIMER(j) = 0;
+      timer_otrigger(j);
     }
   }
 
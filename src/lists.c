@@ -11,6 +11,7 @@
 #include "utils.h"
 #include "db.h"
 #include "dg_event.h"
+#include "slab.h"
 
 static struct iterator_data Iterator;
 static bool loop = FALSE;
@@ -45,7 +46,7 @@ static struct item_data * create_item(void)
 {
   struct item_data *pNewItem;
 
-  CREATE(pNewItem, struct item_data, 1);
+  pNewItem = slab_alloc(&list_item_slab);
 
   pNewItem->pNextItem = NULL;
   pNewItem->pPrevItem = NULL;
@@ -129,7 +130,7 @@ void remove_from_list(void * pContent, struct list_data * pList)
     pList->pFirstItem = NULL;
     pList->pLastItem  = NULL;
   }
-  free(pRemovedItem);
+  slab_free(&list_item_slab, pRemovedItem);
 }
 
 /** Merges an iterator with a list
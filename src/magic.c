@@ -60,21 +60,22 @@ void affect_update(void)
   struct affected_type *af, *next;
   struct char_data *i;
 
-  for (i = character_list; i; i = i->next)
+  affect_tick();
+
+  /* Only characters with an affect wearing off are visited.  Each one's
+   * affects go in list order, so a spell with several affects still gives
+   * its message once, when the last of them goes. */
+  while ((i = next_affect_expiry()) != NULL)
     for (af = i->affected; af; af = next) {
       next = af->next;
-      if (af->duration >= 1)
-	af->duration--;
-      else if (af->duration == -1)	/* No action */
-	;
-      else {
-	if ((af->spell > 0) && (af->spell <= MAX_SPELLS))
-	  if (!af->next || (af->next->spell != af->spell) ||
-	      (af->next->duration > 0))
-	    if (spell_info[af->spell].wear_off_msg)
-	      send_to_char(i, "%s\r\n", spell_info[af->spell].wear_off_msg);
-	affect_remove(i, af);
-      }
+      if (!affect_expired(af))
+	continue;
+      if ((af->spell > 0) && (af->spell <= MAX_SPELLS))
+	if (!af->next || (af->next->spell != af->spell) ||
+	    (af->next->expiry && !affect_expired(af->next)))
+	  if (spell_info[af->spell].wear_off_msg)
+	    send_to_char(i, "%s\r\n", spell_info[af->spell].wear_off_msg);
+      affect_remove(i, af);
     }
 }
 
@@ -28,6 +28,16 @@ static int mail_recip_ok(const char *name);
 static void write_mail_record(FILE *mail_file, struct mail_t *record);
 static void free_mail_record(struct mail_t *record);
 static struct mail_t *read_mail_record(FILE *mail_file);
+static mail_index_type *find_mail_index(long recipient);
+static void add_mail_index(long recipient, long position);
+static long remove_mail_index(long recipient);
+static void mark_mail_deleted(FILE *mail_file, long position);
+
+/* The mail index: who has mail waiting, and where in the file it is. */
+static mail_index_type *mail_index[MAIL_HASH_SIZE];
+static int mail_dead = 0;	/* deleted messages still in the file */
+
+#define MAIL_HASH(recipient)	((unsigned long)(recipient) & (MAIL_HASH_SIZE - 1))
 
 static int mail_recip_ok(const char *name)
 {
@@ -49,7 +59,7 @@ static void free_mail_record(struct mail_t *record)
 
 static struct mail_t *read_mail_record(FILE *mail_file)
 {
-  char line[READ_SIZE];
+  char line[READ_SIZE], mark;
   long sender, recipient;
   time_t sent_time;
   struct mail_t *record;
@@ -57,7 +67,8 @@ static struct mail_t *read_mail_record(FILE *mail_file)
   if (!get_line(mail_file, line))
   	return NULL;
 
-  if (sscanf(line, "### %ld %ld %ld", &recipient, &sender, (long *)&sent_time) != 3) {
+  if (sscanf(line, "#%c# %ld %ld %ld", &mark, &recipient, &sender, (long *)&sent_time) != 4 ||
+      (mark != '#' && mark != MAIL_DELETED_MARK)) {
   	log("Mail system - fatal error - malformed mail header");
   	log("Line was: %s", line);
   	return NULL;
@@ -69,6 +80,7 @@ static struct mail_t *read_mail_record(FILE *mail_file)
   record->sender = sender;
   record->sent_time = sent_time;
   record->body = fread_string(mail_file, "read mail record");
+  record->deleted = (mark == MAIL_DELETED_MARK);
 
   return record;
 }
@@ -83,6 +95,101 @@ static void write_mail_record(FILE *mail_file, struct mail_t *record)
                      record->body );
 }
 
+static mail_index_type *find_mail_index(long recipient)
+{
+  mail_index_type *entry;
+
+  for (entry = mail_index[MAIL_HASH(recipient)]; entry; entry = entry->next)
+    if (entry->recipient == recipient)
+      return entry;
+  return NULL;
+}
+
+/* Remember that a message for recipient starts at position in the mail file.
+ * Messages are received in the order they were added. */
+static void add_mail_index(long recipient, long position)
+{
+  mail_index_type *entry;
+  position_list_type *pos, **tail;
+
+  if (!(entry = find_mail_index(recipient))) {
+    CREATE(entry, mail_index_type, 1);
+    entry->recipient = recipient;
+    entry->next = mail_index[MAIL_HASH(recipient)];
+    mail_index[MAIL_HASH(recipient)] = entry;
+  }
+
+  CREATE(pos, position_list_type, 1);
+  pos->position = position;
+  for (tail = &entry->list_start; *tail; tail = &(*tail)->next)
+    ;
+  *tail = pos;
+}
+
+/* Take the oldest message for recipient out of the index, returning its
+ * position in the mail file or -1 if there is none. */
+static long remove_mail_index(long recipient)
+{
+  mail_index_type *entry, **prev;
+  position_list_type *pos;
+  long position;
+
+  for (prev = &mail_index[MAIL_HASH(recipient)]; (entry = *prev); prev = &entry->next)
+    if (entry->recipient == recipient)
+      break;
+
+  if (!entry || !(pos = entry->list_start))
+    return -1;
+
+  position = pos->position;
+  entry->list_start = pos->next;
+  free(pos);
+
+  if (!entry->list_start) {
+    *prev = entry->next;
+    free(entry);
+  }
+  return position;
+}
+
+void free_mail_index(void)
+{
+  mail_index_type *entry;
+  position_list_type *pos;
+  int i;
+
+  for (i = 0; i < MAIL_HASH_SIZE; i++)
+    while ((entry = mail_index[i])) {
+      mail_index[i] = entry->next;
+      while ((pos = entry->list_start)) {
+        entry->list_start = pos->next;
+        free(pos);
+      }
+      free(entry);
+    }
+  mail_dead = 0;
+}
+
+/* Mark the message starting at position as deleted by overwriting one
+ * character of its header, so nothing else in the file has to move. */
+static void mark_mail_deleted(FILE *mail_file, long position)
+{
+  char line[READ_SIZE];
+  long start;
+
+  /* position may point at blank lines left before the header */
+  fseek(mail_file, position, SEEK_SET);
+  do {
+    start = ftell(mail_file);
+    if (!fgets(line, sizeof(line), mail_file))
+      return;
+  } while (strncmp(line, "###", 3));
+
+  fseek(mail_file, start + 1, SEEK_SET);
+  fputc(MAIL_DELETED_MARK, mail_file);
+  mail_dead++;
+}
+
 /* int scan_file(none)
  * Returns false if mail file is corrupted or true if everything correct.
  *
@@ -92,24 +199,34 @@ int scan_file(void)
 {
   FILE *mail_file;
   int count = 0;
+  long position;
   struct mail_t *record;
 
+  free_mail_index();
+
   if (!(mail_file = fopen(MAIL_FILE, "r"))) {
     log("   Mail file non-existant... creating new file.");
     touch(MAIL_FILE);
     return TRUE;
   }
 
+  position = ftell(mail_file);
   record = read_mail_record(mail_file);
 
   while (record) {
+    if (record->deleted)
+      mail_dead++;
+    else {
+      add_mail_index(record->recipient, position);
+      count++;
+    }
     free_mail_record(record);
+    position = ftell(mail_file);
     record = read_mail_record(mail_file);
-    count++;
   }
 
   fclose(mail_file);
- 	log("   Mail file read -- %d messages.", count);
+ 	log("   Mail file read -- %d messages, %d deleted.", count, mail_dead);
  	return TRUE;
 }
 
@@ -120,27 +237,7 @@ int scan_file(void)
  * A simple little function which tells you if the player has mail or not. */
 int has_mail(long recipient)
 {
-  FILE *mail_file;
-  struct mail_t *record;
-
-  if (!(mail_file = fopen(MAIL_FILE, "r"))) {
-    perror("read_delete: Mail file not accessible.");
-    return FALSE;
-  }
-
-  record = read_mail_record(mail_file);
-
-  while (record) {
-  	if (record->recipient == recipient) {
-  		free_mail_record(record);
-  		fclose(mail_file);
-  		return TRUE;
-    }
-    free_mail_record(record);
-    record = read_mail_record(mail_file);
-  }
-  fclose(mail_file);
-  return FALSE;
+  return find_mail_index(recipient) != NULL;
 }
 
 /* void store_mail(long #1, long #2, char * #3)
@@ -155,6 +252,7 @@ void store_mail(long to, long from, char *message_pointer)
 {
   FILE *mail_file;
   struct mail_t *record;
+  long position;
 
   if (!(mail_file = fopen(MAIL_FILE, "a"))) {
     perror("store_mail: Mail file not accessible.");
@@ -167,52 +265,49 @@ void store_mail(long to, long from, char *message_pointer)
   record->sent_time = time(0);
   record->body = message_pointer;
 
+  fseek(mail_file, 0, SEEK_END);
+  position = ftell(mail_file);
   write_mail_record(mail_file, record);
   free(record); /* don't free the body */
-  fclose(mail_file);
+  if (fclose(mail_file) == 0)
+    add_mail_index(to, position);
+  else
+    perror("store_mail: Mail file not written.");
 }
 
 /* char *read_delete(long #1)
  * #1 - The id number of the person we're checking mail for.
  * Returns the message text of the mail received.
  *
- * Retrieves one messsage for a player. The mail is then discarded from
- * the file. Expects mail to exist. */
+ * Retrieves one messsage for a player. The mail is then marked as deleted in
+ * the file, which compact_mail() clears out later. Expects mail to exist. */
 char *read_delete(long recipient)
 {
-  FILE *mail_file, *new_file;
-  struct mail_t *record, *record_to_keep = NULL;
+  FILE *mail_file;
+  struct mail_t *record_to_keep = NULL;
   char buf[MAX_STRING_LENGTH];
+  long position;
 
-  if (!(mail_file = fopen(MAIL_FILE, "r"))) {
-    perror("read_delete: Mail file not accessible.");
-    return strdup("Mail system malfunction - please report this");
-  }
+  /* Always drop the index entry, so a bad one can't be handed out forever. */
+  if ((position = remove_mail_index(recipient)) < 0)
+    return strdup("Mail system error - please report");
 
-  if (!(new_file = fopen(MAIL_FILE_TMP, "w"))) {
-    perror("read_delete: new Mail file not accessible.");
-    fclose(mail_file);
+  if (!(mail_file = fopen(MAIL_FILE, "r+"))) {
+    perror("read_delete: Mail file not accessible.");
     return strdup("Mail system malfunction - please report this");
   }
 
-  record = read_mail_record(mail_file);
+  fseek(mail_file, position, SEEK_SET);
+  record_to_keep = read_mail_record(mail_file);
 
-  while (record) {
-  	if (!record_to_keep && record->recipient == recipient) {
-  		record_to_keep = record;
-  		record = read_mail_record(mail_file);
-  		continue; /* don't write and free this one just yet */
-    }
-    write_mail_record(new_file, record);
-    free_mail_record(record);
-    record = read_mail_record(mail_file);
-  }
-
-  if (!record_to_keep)
+  if (!record_to_keep || record_to_keep->deleted || record_to_keep->recipient != recipient) {
+    log("SYSERR: Mail index for %ld points at the wrong message (offset %ld).", recipient, position);
   	sprintf(buf, "Mail system error - please report");
-  else {
+  } else {
     char timestr[25], *from, *to;
 
+    mark_mail_deleted(mail_file, position);
+
     strftime(timestr, sizeof(timestr), "%c", localtime(&(record_to_keep->sent_time)));
 
     from = get_name_by_id(record_to_keep->sender);
@@ -230,18 +325,58 @@ char *read_delete(long recipient)
              to ? to : "Unknown",
              from ? from : "Unknown",
              record_to_keep->body ? record_to_keep->body : "No message" );
-
-    free_mail_record(record_to_keep);
   }
+  if (record_to_keep)
+    free_mail_record(record_to_keep);
   fclose(mail_file);
-  fclose(new_file);
-
-  remove(MAIL_FILE);
-  rename(MAIL_FILE_TMP, MAIL_FILE);
 
   return strdup(buf);
 }
 
+/* Rewrites the mail file without its deleted messages and rebuilds the index
+ * to match. This reads and writes the whole file, so it is only done at
+ * shutdown, where the time does not stall the game. */
+void compact_mail(void)
+{
+  FILE *mail_file, *new_file;
+  struct mail_t *record;
+  long position;
+  int removed = mail_dead;
+
+  if (no_mail || !mail_dead)
+    return;
+
+  if (!(mail_file = fopen(MAIL_FILE, "r"))) {
+    perror("compact_mail: Mail file not accessible.");
+    return;
+  }
+
+  if (!(new_file = fopen(MAIL_FILE_TMP, "w"))) {
+    perror("compact_mail: new Mail file not accessible.");
+    fclose(mail_file);
+    return;
+  }
+
+  free_mail_index();
+
+  while ((record = read_mail_record(mail_file))) {
+    if (!record->deleted) {
+      position = ftell(new_file);
+      write_mail_record(new_file, record);
+      add_mail_index(record->recipient, position);
+    }
+    free_mail_record(record);
+  }
+  fclose(mail_file);
+
+  if (fclose(new_file) != 0 || rename(MAIL_FILE_TMP, MAIL_FILE) != 0) {
+    perror("compact_mail: Mail file not replaced");
+    scan_file();	/* the old file is still there, index it again */
+    return;
+  }
+  log("Mail file compacted -- %d deleted messages removed.", removed);
+}
+
 /* spec_proc for a postmaster using the above routines.  By Jeremy Elson */
 SPECIAL(postmaster)
 {
@@ -27,6 +27,13 @@
 /* size of mail file allocation blocks		*/
 #define BLOCK_SIZE 100
 
+/* number of buckets in the in-memory mail index (a power of two) */
+#define MAIL_HASH_SIZE 256
+
+/* deleted messages stay in the mail file, marked with this character in
+ * place of the second '#' of their header, until shutdown compacts the file */
+#define MAIL_DELETED_MARK '-'
+
 /* General, publicly available functions */
 SPECIAL(postmaster);
 
@@ -42,12 +49,15 @@ int	has_mail(long recipient);
 void	store_mail(long to, long from, char *message_pointer);
 char	*read_delete(long recipient);
 void    notify_if_playing(struct char_data *from, int recipient_id);
+void	compact_mail(void);
+void	free_mail_index(void);
 
 struct mail_t {
 	long recipient;
 	long sender;
 	time_t sent_time;
 	char *body;
+	bool deleted;
 };
 
 /* old stuff below */
@@ -91,12 +101,14 @@ typedef struct header_block_type_d header_block_type;
 typedef struct data_block_type_d data_block_type;
 
 struct position_list_type_d {
-   long	position;
+   long	position;			/* file offset of the message	*/
    struct position_list_type_d *next;
 };
 
 typedef struct position_list_type_d position_list_type;
 
+/* One per recipient with mail waiting, chained in a bucket of the mail index.
+ * The positions are in the order the messages were sent. */
 struct mail_index_type_d {
    long recipient;			/* who is this mail for?	*/
    position_list_type *list_start;	/* list of mail positions	*/
@@ -39,6 +39,13 @@ void mobile_activity(void)
     if (!IS_MOB(ch))
       continue;
 
+    /* Nobody is around to see a mob in a hibernating zone, unless it is
+     * busy with a fight or a hunt it carried out of an awake one. */
+    if (IN_ROOM(ch) != NOWHERE && world[IN_ROOM(ch)].zone != NOWHERE &&
+        zone_table[world[IN_ROOM(ch)].zone].hibernating &&
+        !FIGHTING(ch) && !HUNTING(ch) && !ch->desc)
+      continue;
+
     /* Examine call for special procedure */
     if (MOB_FLAGGED(ch, MOB_SPEC) && !no_specials) {
       if (mob_index[GET_MOB_RNUM(ch)].func == NULL) {
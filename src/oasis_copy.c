@@ -23,6 +23,8 @@
 #include "improved-edit.h"
 #include "constants.h"
 #include "dg_scripts.h"
+#include "strpool.h"
+#include "graph.h"
 
 /* Local, filescope function prototypes */
 /* Utility function for buildwalk */
@@ -198,11 +200,12 @@ ACMD(do_dig)
     if (W_EXIT(IN_ROOM(ch), dir)) {
       /* free the old pointers, if any */
       if (W_EXIT(IN_ROOM(ch), dir)->general_description)
-        free(W_EXIT(IN_ROOM(ch), dir)->general_description);
+        str_release(W_EXIT(IN_ROOM(ch), dir)->general_description);
       if (W_EXIT(IN_ROOM(ch), dir)->keyword)
-        free(W_EXIT(IN_ROOM(ch), dir)->keyword);
+        str_release(W_EXIT(IN_ROOM(ch), dir)->keyword);
       free(W_EXIT(IN_ROOM(ch), dir));
       W_EXIT(IN_ROOM(ch), dir) = NULL;
+      invalidate_paths();
       add_to_save_list(zone_table[world[IN_ROOM(ch)].zone].number, SL_WLD);
       send_to_char(ch, "You remove the exit to the %s.\r\n", dirs[dir]);
       return;
@@ -270,6 +273,7 @@ ACMD(do_dig)
   W_EXIT(IN_ROOM(ch), dir)->keyword = NULL;
   W_EXIT(IN_ROOM(ch), dir)->to_room = rrnum;
   add_to_save_list(zone_table[world[IN_ROOM(ch)].zone].number, SL_WLD);
+  invalidate_paths();
 
   send_to_char(ch, "You make an exit %s to room %d (%s).\r\n",
                    dirs[dir], rvnum, world[rrnum].name);
@@ -291,21 +295,12 @@ ACMD(do_dig)
 /* For buildwalk. Finds the next free vnum in the zone */
 static room_vnum redit_find_new_vnum(zone_rnum zone)
 {
-  room_vnum vnum = genolc_zone_bottom(zone);
-  room_rnum rnum = real_room(vnum);
-
-  if (rnum == NOWHERE)
-    return vnum;
+  room_vnum vnum;
 
-  for(;;) {
-    if (vnum > zone_table[zone].top)
-      return(NOWHERE);
-    if (rnum > top_of_world || world[rnum].number > vnum)
-      break;
-    rnum++;
-    vnum++;
-  }
-  return(vnum);
+  for (vnum = genolc_zone_bottom(zone); vnum <= zone_table[zone].top; vnum++)
+    if (real_room(vnum) == NOWHERE)
+      return(vnum);
+  return(NOWHERE);
 }
 
 int buildwalk(struct char_data *ch, int dir)
@@ -355,6 +350,7 @@ int buildwalk(struct char_data *ch, int dir)
       EXIT(ch, dir)->to_room = rnum;
       CREATE(world[rnum].dir_option[rev_dir[dir]], struct room_direction_data, 1);
       world[rnum].dir_option[rev_dir[dir]]->to_room = IN_ROOM(ch);
+      invalidate_paths();
 
       /* Report room creation to user */
       send_to_char(ch, "%sRoom #%d created by BuildWalk.%s\r\n", yel, vnum, nrm);
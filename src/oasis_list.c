@@ -92,6 +92,8 @@ static void perform_mob_level_list(struct char_data * ch, char *arg)
 
   len = snprintf(buf, sizeof(buf), "Listing mobiles of level %s%d%s\r\n", QYEL, mob_level, QNRM);
   for (num = 0; num <= top_of_mobt; num++) {
+    if (mob_index[num].vnum == NOBODY)	/* Deleted in OLC. */
+      continue;
     if ((mob_proto[num].player.level) == mob_level) {
       if ((mob = read_mobile(num, REAL)) != NULL) {
         char_to_room(mob, 0);
@@ -342,6 +344,8 @@ static void perform_obj_name_list(struct char_data * ch, char *arg)
   "Index VNum    Num   Object Name                                Object Type\r\n"
   "----- ------- ----- ------------------------------------------ ----------------\r\n", arg);
   for (num = 0; num <= top_of_objt; num++) {
+    if (obj_index[num].vnum == NOTHING)	/* Deleted in OLC. */
+      continue;
     if (is_name(arg, obj_proto[num].name)) {
       ov = obj_index[num].vnum;
       tmp_len = snprintf(buf+len, sizeof(buf)-len, "%s%4d%s) %s[%s%5d%s] %s(%s%3d%s)%s %-*s%s [%s]%s%s\r\n",
@@ -505,7 +509,7 @@ ACMD(do_oasis_links)
   zone_vnum zvnum;
   room_rnum nr, to_room;
   room_vnum first, last;
-  int j;
+  int i, j;
   char arg[MAX_INPUT_LENGTH];
 
   skip_spaces(&argument);
@@ -534,7 +538,10 @@ ACMD(do_oasis_links)
   first = zone_table[zrnum].bot;
 
   send_to_char(ch, "Zone %d is linked to the following zones:\r\n", zvnum);
-  for (nr = 0; nr <= top_of_world && (GET_ROOM_VNUM(nr) <= last); nr++) {
+  for (i = 0; i < world_vnum_count; i++) {
+    nr = world_vnum_order[i];
+    if (GET_ROOM_VNUM(nr) > last)
+      break;
     if (GET_ROOM_VNUM(nr) >= first) {
       for (j = 0; j < DIR_COUNT; j++) {
 	if (world[nr].dir_option[j]) {
@@ -556,7 +563,7 @@ static void list_rooms(struct char_data *ch, zone_rnum rnum, room_vnum vmin, roo
 {
   room_rnum i;
   room_vnum bottom, top;
-  int j, counter = 0;
+  int n, j, counter = 0;
   size_t len;
   char buf[MAX_STRING_LENGTH];
 
@@ -577,7 +584,8 @@ static void list_rooms(struct char_data *ch, zone_rnum rnum, room_vnum vmin, roo
   if (!top_of_world)
     return;
 
-  for (i = 0; i <= top_of_world; i++) {
+  for (n = 0; n < world_vnum_count; n++) {
+    i = world_vnum_order[n];
 
     /** Check to see if this room is one of the ones needed to be listed.    **/
     if ((world[i].number >= bottom) && (world[i].number <= top)) {
@@ -618,7 +626,7 @@ static void list_mobiles(struct char_data *ch, zone_rnum rnum, mob_vnum vmin, mo
 {
   mob_rnum i;
   mob_vnum bottom, top;
-  int counter = 0;
+  int n, counter = 0;
   size_t len;
   char buf[MAX_STRING_LENGTH];
 
@@ -638,7 +646,8 @@ static void list_mobiles(struct char_data *ch, zone_rnum rnum, mob_vnum vmin, mo
   if (!top_of_mobt)
     return;
 
-  for (i = 0; i <= top_of_mobt; i++) {
+  for (n = 0; n < mob_vnum_count; n++) {
+    i = mob_vnum_order[n];
     if (mob_index[i].vnum >= bottom && mob_index[i].vnum <= top) {
       counter++;
 
@@ -665,7 +674,7 @@ static void list_objects(struct char_data *ch, zone_rnum rnum, obj_vnum vmin, ob
   obj_rnum i;
   obj_vnum bottom, top;
   char buf[MAX_STRING_LENGTH];
-  int counter = 0;
+  int n, counter = 0;
   size_t len;
 
   if (rnum != NOWHERE) {
@@ -684,7 +693,8 @@ static void list_objects(struct char_data *ch, zone_rnum rnum, obj_vnum vmin, ob
   if (!top_of_objt)
     return;
 
-  for (i = 0; i <= top_of_objt; i++) {
+  for (n = 0; n < obj_vnum_count; n++) {
+    i = obj_vnum_order[n];
     if (obj_index[i].vnum >= bottom && obj_index[i].vnum <= top) {
       counter++;
 
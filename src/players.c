@@ -22,6 +22,7 @@
 #include "config.h" /* for pclean_criteria[] */
 #include "dg_scripts.h" /* To enable saving of player variables to disk */
 #include "quest.h"
+#include "savequeue.h"
 
 #define LOAD_HIT	0
 #define LOAD_MANA	1
@@ -41,47 +42,132 @@ static void load_quests(FILE *fl, struct char_data *ch);
 static void load_HMVS(struct char_data *ch, const char *line, int mode);
 static void write_aliases_ascii(FILE *file, struct char_data *ch);
 static void read_aliases_ascii(FILE *file, struct char_data *ch, int count);
+static unsigned int ptable_name_hash(const char *name);
+static unsigned int ptable_id_hash(long id);
+static void ptable_hash_add(int *hash, unsigned int key, int pos);
+static void rebuild_ptable_hash(void);
+static void remove_player_from_index(int pos);
+static int parse_index_line(char *line, int pos);
+static int replay_player_journal(void);
+static void append_player_journal(const char *record);
+
+/* Changes to the player index since it was last written in full. */
+static FILE *player_journal = NULL;
+static int journal_records = 0;
+
+/* Hash indexes into player_table by lowercased name and by id. Both are open
+ * addressing tables of player_table positions, with -1 for an empty slot.
+ * An entry whose name or id has since changed is left where it is: lookups
+ * check the key against player_table and skip it, and the next rebuild drops
+ * it. */
+#define PTABLE_HASH_MIN 256
+static int *ptable_by_name = NULL;
+static int *ptable_by_id = NULL;
+static int ptable_hash_size = 0;	/* slots in each table, a power of two */
+static int ptable_hash_used = 0;	/* slots in use, stale ones included */
+
+/* Read one index line into player_table[pos]. Returns FALSE on a line that
+ * is cut short, as the last journal record can be after a crash. */
+static int parse_index_line(char *line, int pos)
+{
+  char arg2[80], bits[64];
+  long id, last;
+  int level;
+
+  if (sscanf(line, "%ld %79s %d %63s %ld", &id, arg2, &level, bits, &last) != 5)
+    return (FALSE);
+
+  if (pos > top_of_p_table)
+    top_of_p_table = pos;
+  else if (player_table[pos].name)
+    free(player_table[pos].name);
+  player_table[pos].id = id;
+  player_table[pos].name = strdup(arg2);
+  player_table[pos].level = level;
+  player_table[pos].flags = asciiflag_conv(bits);
+  player_table[pos].last = (time_t)last;
+  if (id > top_idnum)
+    top_idnum = id;
+  return (TRUE);
+}
+
+/* Apply the index journal on top of the table read from the index file.
+ * Every record either sets the whole entry for a name or removes the name,
+ * so replaying a record twice is harmless. Returns the records applied. */
+static int replay_player_journal(void)
+{
+  FILE *fl;
+  char journal_name[50], line[256], *name;
+  int count = 0, pos;
+
+  sprintf(journal_name, "%s%s", LIB_PLRFILES, PLR_JOURNAL_FILE);
+  if (!(fl = fopen(journal_name, "r")))
+    return (0);
+
+  while (get_line(fl, line)) {
+    if (*line == '-') {
+      name = line + 1;
+      skip_spaces(&name);
+      if ((pos = get_ptable_by_name(name)) >= 0)
+        remove_player_from_index(pos);
+    } else if (*line == '+') {
+      char arg2[80];
+
+      if (sscanf(line + 1, "%*d %79s", arg2) != 1)
+        continue;
+      if ((pos = get_ptable_by_name(arg2)) < 0) {
+        pos = top_of_p_table + 1;
+        RECREATE(player_table, struct player_index_element, pos + 1);
+        player_table[pos].name = NULL;
+      }
+      if (!parse_index_line(line + 1, pos))
+        continue;
+      index_player_entry(pos);
+    } else
+      continue;
+    count++;
+  }
+  fclose(fl);
+  return (count);
+}
 
 /* New version to build player index for ASCII Player Files. Generate index
  * table for the player file. */
 void build_player_index(void)
 {
-  int rec_count = 0, i;
+  int rec_count = 0, i = 0;
   FILE *plr_index;
-  char index_name[40], line[256], bits[64];
-  char arg2[80];
+  char index_name[40], line[256];
+
+  player_table = NULL;
+  top_of_p_table = -1;
 
   sprintf(index_name, "%s%s", LIB_PLRFILES, INDEX_FILE);
-  if (!(plr_index = fopen(index_name, "r"))) {
-    top_of_p_table = -1;
+  if (!(plr_index = fopen(index_name, "r")))
     log("No player index file!  First new char will be IMP!");
-    return;
-  }
-
-  while (get_line(plr_index, line))
-    if (*line != '~')
-      rec_count++;
-  rewind(plr_index);
-
-  if (rec_count == 0) {
-    player_table = NULL;
-    top_of_p_table = -1;
-    return;
+  else {
+    while (get_line(plr_index, line))
+      if (*line != '~')
+        rec_count++;
+    rewind(plr_index);
+
+    if (rec_count > 0)
+      CREATE(player_table, struct player_index_element, rec_count);
+    while (i < rec_count && get_line(plr_index, line))
+      if (*line != '~' && parse_index_line(line, i))
+        i++;
+    fclose(plr_index);
   }
-
-  CREATE(player_table, struct player_index_element, rec_count);
-  for (i = 0; i < rec_count; i++) {
-    get_line(plr_index, line);
-    sscanf(line, "%ld %s %d %s %ld", &player_table[i].id, arg2,
-      &player_table[i].level, bits, (long *)&player_table[i].last);
-    CREATE(player_table[i].name, char, strlen(arg2) + 1);
-    strcpy(player_table[i].name, arg2);
-    player_table[i].flags = asciiflag_conv(bits);
-    top_idnum = MAX(top_idnum, player_table[i].id);
+  top_of_p_file = top_of_p_table;
+  rebuild_ptable_hash();
+
+  /* Fold what was journaled since into a fresh index, so the journal starts
+   * out empty. */
+  if ((journal_records = replay_player_journal()) > 0) {
+    log("Replayed %d player index journal record%s.", journal_records,
+        journal_records == 1 ? "" : "s");
+    save_player_index();
   }
-
-  fclose(plr_index);
-  top_of_p_file = top_of_p_table = i - 1;
 }
 
 /* Create a new entry in the in-memory index table for the player file. If the
@@ -109,6 +195,10 @@ int create_entry(char *name)
 
   /* clear the bitflag in case we have garbage data */
   player_table[pos].flags = 0;
+  player_table[pos].level = 0;
+  player_table[pos].last = 0;
+
+  index_player_entry(pos);
 
   return (pos);
 }
@@ -146,17 +236,23 @@ static void remove_player_from_index(int pos)
     free(player_table);
     player_table = NULL;
   }
+
+  /* Everything after pos has moved down one. */
+  rebuild_ptable_hash();
 }
 
-/* This function necessary to save a seperate ASCII player index */
+/* Write the whole player index, then empty the journal that it now covers.
+ * The index goes to a temporary file first so that a crash part way leaves
+ * the old index and the journal to replay on top of it. */
 void save_player_index(void)
 {
   int i;
-  char index_name[50], bits[64];
+  char index_name[50], temp_name[60], journal_name[50], bits[64];
   FILE *index_file;
 
   sprintf(index_name, "%s%s", LIB_PLRFILES, INDEX_FILE);
-  if (!(index_file = fopen(index_name, "w"))) {
+  sprintf(temp_name, "%s%s", index_name, SAVE_TEMP_SUFFIX);
+  if (!(index_file = fopen(temp_name, "w"))) {
     log("SYSERR: Could not write player index file");
     return;
   }
@@ -170,7 +266,70 @@ void save_player_index(void)
     }
   fprintf(index_file, "~\n");
 
-  fclose(index_file);
+  if (fclose(index_file) || rename(temp_name, index_name)) {
+    log("SYSERR: Could not write player index file: %s", strerror(errno));
+    remove(temp_name);
+    return;
+  }
+
+  if (player_journal) {
+    fclose(player_journal);
+    player_journal = NULL;
+  }
+  sprintf(journal_name, "%s%s", LIB_PLRFILES, PLR_JOURNAL_FILE);
+  if (remove(journal_name) && errno != ENOENT)
+    log("SYSERR: Could not remove player index journal: %s", strerror(errno));
+  journal_records = 0;
+}
+
+/* Append one record to the index journal, and write the whole index instead
+ * once the journal has grown as long as the index itself. */
+static void append_player_journal(const char *record)
+{
+  char journal_name[50];
+
+  if (!player_journal) {
+    sprintf(journal_name, "%s%s", LIB_PLRFILES, PLR_JOURNAL_FILE);
+    if (!(player_journal = fopen(journal_name, "a"))) {
+      log("SYSERR: Could not open player index journal: %s", strerror(errno));
+      save_player_index();
+      return;
+    }
+  }
+
+  fputs(record, player_journal);
+  if (fflush(player_journal)) {
+    log("SYSERR: Could not write player index journal: %s", strerror(errno));
+    save_player_index();
+    return;
+  }
+
+  if (++journal_records > MAX(PLR_JOURNAL_MIN, top_of_p_table + 1))
+    save_player_index();
+}
+
+/* Record the current index entry at pos, as saved by save_char(). */
+void journal_player_entry(int pos)
+{
+  char record[256], bits[64];
+
+  if (pos < 0 || pos > top_of_p_table || !*player_table[pos].name)
+    return;
+
+  sprintascii(bits, player_table[pos].flags);
+  snprintf(record, sizeof(record), "+ %ld %s %d %s %ld\n", player_table[pos].id,
+        player_table[pos].name, player_table[pos].level, *bits ? bits : "0",
+        (long)player_table[pos].last);
+  append_player_journal(record);
+}
+
+/* Record that a name has left the index, deleted or renamed. */
+void journal_player_removal(const char *name)
+{
+  char record[256];
+
+  snprintf(record, sizeof(record), "- %s\n", name);
+  append_player_journal(record);
 }
 
 void free_player_index(void)
@@ -187,37 +346,122 @@ void free_player_index(void)
   free(player_table);
   player_table = NULL;
   top_of_p_table = 0;
+
+  if (ptable_by_name)
+    free(ptable_by_name);
+  if (ptable_by_id)
+    free(ptable_by_id);
+  ptable_by_name = ptable_by_id = NULL;
+  ptable_hash_size = ptable_hash_used = 0;
 }
 
-long get_ptable_by_name(const char *name)
+/* Case insensitive FNV-1a, so that names hash the same however typed. */
+static unsigned int ptable_name_hash(const char *name)
+{
+  unsigned int h = 2166136261U;
+
+  for (; *name; name++)
+    h = (h ^ (unsigned char)LOWER(*name)) * 16777619U;
+  return (h);
+}
+
+/* Fibonacci hashing, folded so the low bits used for the slot are mixed. */
+static unsigned int ptable_id_hash(long id)
+{
+  unsigned int h = (unsigned int)id * 2654435769U;
+
+  return (h ^ (h >> 16));
+}
+
+static void ptable_hash_add(int *hash, unsigned int key, int pos)
 {
   int i;
 
+  for (i = key & (ptable_hash_size - 1); hash[i] != -1; i = (i + 1) & (ptable_hash_size - 1))
+    if (hash[i] == pos)
+      return;
+  hash[i] = pos;
+}
+
+/* Size the hash tables for the current player_table and fill them afresh. */
+static void rebuild_ptable_hash(void)
+{
+  int i, size = PTABLE_HASH_MIN;
+
+  while (size < 4 * (top_of_p_table + 1))
+    size <<= 1;
+
+  if (size != ptable_hash_size) {
+    if (ptable_by_name)
+      free(ptable_by_name);
+    if (ptable_by_id)
+      free(ptable_by_id);
+    CREATE(ptable_by_name, int, size);
+    CREATE(ptable_by_id, int, size);
+    ptable_hash_size = size;
+  }
+  for (i = 0; i < size; i++)
+    ptable_by_name[i] = ptable_by_id[i] = -1;
+
+  ptable_hash_used = 0;
   for (i = 0; i <= top_of_p_table; i++)
-    if (!str_cmp(player_table[i].name, name))
-      return (i);
+    index_player_entry(i);
+}
+
+/* Make player_table[pos] findable by its current name and id. Called
+ * whenever either of them is set. */
+void index_player_entry(int pos)
+{
+  if (pos < 0 || pos > top_of_p_table || !player_table)
+    return;
+
+  /* Keep at least half of each table empty, counting stale entries. */
+  if (2 * (ptable_hash_used + 1) > ptable_hash_size) {
+    rebuild_ptable_hash();	/* which indexes pos along with the rest */
+    return;
+  }
+
+  ptable_hash_add(ptable_by_name, ptable_name_hash(player_table[pos].name), pos);
+  ptable_hash_add(ptable_by_id, ptable_id_hash(player_table[pos].id), pos);
+  ptable_hash_used++;
+}
+
+long get_ptable_by_name(const char *name)
+{
+  int i, pos;
+
+  if (!ptable_hash_size || !name)
+    return (-1);
+
+  for (i = ptable_name_hash(name) & (ptable_hash_size - 1);
+       (pos = ptable_by_name[i]) != -1; i = (i + 1) & (ptable_hash_size - 1))
+    if (pos <= top_of_p_table && !str_cmp(player_table[pos].name, name))
+      return (pos);
 
   return (-1);
 }
 
 long get_id_by_name(const char *name)
 {
-  int i;
+  long pos;
 
-  for (i = 0; i <= top_of_p_table; i++)
-    if (!str_cmp(player_table[i].name, name))
-      return (player_table[i].id);
+  if ((pos = get_ptable_by_name(name)) < 0)
+    return (-1);
 
-  return (-1);
+  return (player_table[pos].id);
 }
 
 char *get_name_by_id(long id)
 {
-  int i;
+  int i, pos;
 
-  for (i = 0; i <= top_of_p_table; i++)
-    if (player_table[i].id == id)
-      return (player_table[i].name);
+  if (!ptable_hash_size)
+    return (NULL);
+
+  for (i = ptable_id_hash(id) & (ptable_hash_size - 1);
+       (pos = ptable_by_id[i]) != -1; i = (i + 1) & (ptable_hash_size - 1))
+    if (pos <= top_of_p_table && player_table[pos].id == id)
+      return (player_table[pos].name);
 
   return (NULL);
 }
@@ -240,6 +484,7 @@ int load_char(const char *name, struct char_data *ch)
   else {
     if (!get_filename(filename, sizeof(filename), PLR_FILE, player_table[id].name))
       return (-1);
+    save_wait(filename);
     if (!(fl = fopen(filename, "r"))) {
       mudlog(NRM, LVL_GOD, TRUE, "SYSERR: Couldn't open player file %s", filename);
       return (-1);
@@ -453,7 +698,7 @@ int load_char(const char *name, struct char_data *ch)
           if ((t_rnum = real_trigger(atoi(line))) != NOTHING) {
             t = read_trigger(t_rnum);
           if (!SCRIPT(ch))
-            CREATE(SCRIPT(ch), struct script_data, 1);
+            SCRIPT(ch) = create_script(ch, MOB_TRIGGER);
           add_trigger(SCRIPT(ch), t, -1);
           }
          }
@@ -523,7 +768,7 @@ void save_char(struct char_data * ch)
 
   if (!get_filename(filename, sizeof(filename), PLR_FILE, GET_NAME(ch)))
     return;
-  if (!(fl = fopen(filename, "w"))) {
+  if (!(fl = save_open(filename))) {
     mudlog(NRM, LVL_GOD, TRUE, "SYSERR: Couldn't open player file %s for write", filename);
     return;
   }
@@ -543,6 +788,7 @@ void save_char(struct char_data * ch)
   for (aff = ch->affected, i = 0; i < MAX_AFFECT; i++) {
     if (aff) {
       tmp_aff[i] = *aff;
+      tmp_aff[i].duration = affect_duration(aff);
       for (j=0; j<AF_ARRAY_MAX; j++)
         tmp_aff[i].bitvector[j] = aff->bitvector[j];
       tmp_aff[i].next = 0;
@@ -694,7 +940,7 @@ void save_char(struct char_data * ch)
   write_aliases_ascii(fl, ch);
   save_char_vars_ascii(fl, ch);
 
-  fclose(fl);
+  save_close(fl);
 
   /* More char_to_store code to add spell and eq affections back in. */
   for (i = 0; i < MAX_AFFECT; i++) {
@@ -743,7 +989,7 @@ void save_char(struct char_data * ch)
     REMOVE_BIT(player_table[id].flags, PINDEX_NOWIZLIST);
 
   if (player_table[id].flags != i || save_index)
-    save_player_index();
+    journal_player_entry(id);
 }
 
 /* Separate a 4-character id tag from the data it precedes */
@@ -778,20 +1024,21 @@ void remove_player(int pfilepos)
 
   /* Unlink all player-owned files */
   for (i = 0; i < MAX_FILES; i++) {
-    if (get_filename(filename, sizeof(filename), i, player_table[pfilepos].name))
+    if (get_filename(filename, sizeof(filename), i, player_table[pfilepos].name)) {
+      save_wait(filename);
       unlink(filename);
+    }
   }
 
   strftime(timestr, sizeof(timestr), "%c", localtime(&(player_table[pfilepos].last)));
   log("PCLEAN: %s Lev: %d Last: %s",
 	player_table[pfilepos].name, player_table[pfilepos].level,
 	timestr);
+  journal_player_removal(player_table[pfilepos].name);
   player_table[pfilepos].name[0] = '\0';
 
   /* Update index table. */
   remove_player_from_index(pfilepos);
-
-  save_player_index();
 }
 
 void clean_pfiles(void)
@@ -0,0 +1,158 @@
+/**************************************************************************
+ *  File: profiler.c                                        Part of tbaMUD *
+ *  Usage: Timing of the game loop and heartbeat phases.                   *
+ *                                                                         *
+ *  All rights reserved.  See license for complete information.            *
+ *                                                                         *
+ *  Copyright (C) 1993, 94 by the Trustees of the Johns Hopkins University *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ **************************************************************************/
+
+#include "conf.h"
+#include "sysdep.h"
+#include "structs.h"
+#include "utils.h"
+#include "comm.h"
+#include "profiler.h"
+
+/* Each phase keeps a ring of its most recent run times (in microseconds) so
+ * 'show heartbeat' can report rolling percentiles, plus the worst run since
+ * boot and the time spent in the current pulse for overrun reports. */
+struct phase_profile {
+  long samples[PROFILE_SAMPLES]; /* ring buffer of recent run times */
+  int next;                      /* next slot to overwrite */
+  int count;                     /* valid samples, up to PROFILE_SAMPLES */
+  unsigned long calls;           /* runs since boot */
+  long max;                      /* worst run since boot */
+  long this_pulse;               /* time spent during the current pulse */
+  struct timeval start;          /* when the current run began */
+};
+
+static const char *pulse_phase_names[NUM_PULSE_PHASES] = {
+    "input",    "commands", "output",   "events",  "scripts",
+    "zones",    "mobiles",  "violence", "affects", "points",
+    "autosave", "heartbeat", "pulse"};
+
+static struct phase_profile phases[NUM_PULSE_PHASES];
+static unsigned long total_overruns = 0;  /* pulses over budget since boot */
+static unsigned long recent_overruns = 0; /* since the last overrun log */
+static time_t last_overrun_log = 0;
+
+static void profile_now(struct timeval *tv);
+static long profile_usec(struct timeval *start, struct timeval *end);
+static int compare_samples(const void *a, const void *b);
+
+/* Use the monotonic clock when we have it, so a clock step from NTP does not
+ * show up as a giant (or negative) phase time. */
+static void profile_now(struct timeval *tv) {
+#if defined(CLOCK_MONOTONIC) && !defined(CIRCLE_WINDOWS)
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  tv->tv_sec = ts.tv_sec;
+  tv->tv_usec = ts.tv_nsec / 1000;
+#else
+  gettimeofday(tv, (struct timezone *)0);
+#endif
+}
+
+static long profile_usec(struct timeval *start, struct timeval *end) {
+  long usec;
+
+  usec = (end->tv_sec - start->tv_sec) * 1000000L +
+         (end->tv_usec - start->tv_usec);
+
+  return (MAX(usec, 0));
+}
+
+void profile_begin(int phase) { profile_now(&phases[phase].start); }
+
+void profile_end(int phase) {
+  struct phase_profile *p = &phases[phase];
+  struct timeval now;
+  long usec;
+
+  profile_now(&now);
+  usec = profile_usec(&p->start, &now);
+
+  p->samples[p->next] = usec;
+  p->next = (p->next + 1) % PROFILE_SAMPLES;
+  if (p->count < PROFILE_SAMPLES)
+    p->count++;
+
+  p->calls++;
+  p->max = MAX(p->max, usec);
+  p->this_pulse += usec;
+}
+
+/* Called once per game_loop() pass after PHASE_PULSE has been ended.  Counts
+ * passes that blew the OPT_USEC budget and, at most once every
+ * OVERRUN_LOG_INTERVAL seconds, logs which phase was to blame. */
+void profile_pulse_done(void) {
+  int i, worst = -1;
+  time_t now;
+
+  if (phases[PHASE_PULSE].this_pulse > OPT_USEC) {
+    total_overruns++;
+    recent_overruns++;
+
+    now = time(0);
+    if (now - last_overrun_log >= OVERRUN_LOG_INTERVAL) {
+      /* The heartbeat and pulse phases contain the others; skip them. */
+      for (i = 0; i < PHASE_HEARTBEAT; i++)
+        if (worst < 0 || phases[i].this_pulse > phases[worst].this_pulse)
+          worst = i;
+
+      log("Pulse overrun: %ld usec (budget %d), slowest phase %s at %ld usec; "
+          "%lu overrun%s since last report.",
+          phases[PHASE_PULSE].this_pulse, OPT_USEC, pulse_phase_names[worst],
+          phases[worst].this_pulse, recent_overruns,
+          recent_overruns == 1 ? "" : "s");
+      last_overrun_log = now;
+      recent_overruns = 0;
+    }
+  }
+
+  for (i = 0; i < NUM_PULSE_PHASES; i++)
+    phases[i].this_pulse = 0;
+}
+
+static int compare_samples(const void *a, const void *b) {
+  long x = *(const long *)a, y = *(const long *)b;
+
+  return (x > y) - (x < y);
+}
+
+void show_heartbeat_profile(struct char_data *ch) {
+  long sorted[PROFILE_SAMPLES];
+  unsigned long missed;
+  int i, n;
+
+  send_to_char(ch,
+               "Heartbeat profile (usec, last %d runs of each phase):\r\n"
+               "Phase          Calls       p50       p99       max\r\n"
+               "-----------------------------------------------------\r\n",
+               PROFILE_SAMPLES);
+
+  for (i = 0; i < NUM_PULSE_PHASES; i++) {
+    if (!(n = phases[i].count)) {
+      send_to_char(ch, "%-10s %9lu %9s %9s %9s\r\n", pulse_phase_names[i],
+                   phases[i].calls, "-", "-", "-");
+      continue;
+    }
+
+    memcpy(sorted, phases[i].samples, n * sizeof(long));
+    qsort(sorted, n, sizeof(long), compare_samples);
+
+    send_to_char(ch, "%-10s %9lu %9ld %9ld %9ld\r\n", pulse_phase_names[i],
+                 phases[i].calls, sorted[n * 50 / 100],
+                 sorted[MIN(n - 1, n * 99 / 100)], phases[i].max);
+  }
+
+  /* Every missed pulse is made up by an extra heartbeat in the same pass. */
+  missed = phases[PHASE_HEARTBEAT].calls - phases[PHASE_PULSE].calls;
+
+  send_to_char(ch, "Budget %d usec per pulse: %lu overruns, %lu missed pulses "
+                   "since boot.\r\n",
+               OPT_USEC, total_overruns, missed);
+}
@@ -0,0 +1,44 @@
+/**
+* @file profiler.h
+* Per-pulse phase timing for the game loop and heartbeat.
+*
+* Part of the core tbaMUD source code distribution, which is a derivative
+* of, and continuation of, CircleMUD.
+*
+* All rights reserved.  See license for complete information.
+* Copyright (C) 1993, 94 by the Trustees of the Johns Hopkins University
+* CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.
+*/
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+/* Timed phases of a pulse.  Keep pulse_phase_names[] in profiler.c in sync. */
+#define PHASE_INPUT      0  /**< Polling sockets and reading input */
+#define PHASE_COMMANDS   1  /**< Interpreting queued commands */
+#define PHASE_OUTPUT     2  /**< Flushing output and prompts */
+#define PHASE_EVENTS     3  /**< event_process() */
+#define PHASE_SCRIPTS    4  /**< script_trigger_check() */
+#define PHASE_ZONES      5  /**< zone_update() */
+#define PHASE_MOBILES    6  /**< mobile_activity() */
+#define PHASE_VIOLENCE   7  /**< perform_violence() */
+#define PHASE_AFFECTS    8  /**< affect_update() */
+#define PHASE_POINTS     9  /**< point_update() */
+#define PHASE_AUTOSAVE   10 /**< Crash_save_all() and House_save_all() */
+#define PHASE_HEARTBEAT  11 /**< One complete heartbeat() */
+#define PHASE_PULSE      12 /**< One game_loop() pass, excluding the sleep */
+/** Total number of timed phases. */
+#define NUM_PULSE_PHASES 13
+
+/** How many of the most recent runs of each phase the percentiles cover. */
+#define PROFILE_SAMPLES  512
+
+/** Minimum number of seconds between two pulse overrun log messages. */
+#define OVERRUN_LOG_INTERVAL 60
+
+/* Functions */
+void profile_begin(int phase);
+void profile_end(int phase);
+void profile_pulse_done(void);
+void show_heartbeat_profile(struct char_data *ch);
+
+#endif /* _PROFILER_H_ */
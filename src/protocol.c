@@ -40,7 +40,7 @@ static void Write( descriptor_t *apDescriptor, const char *apData )
 {
    if ( apDescriptor != NULL)
    {
-      if ( apDescriptor->pProtocol->WriteOOB > 0 || *(apDescriptor->output) == '\0' )
+      if ( apDescriptor->pProtocol->WriteOOB > 0 || apDescriptor->output == NULL )
       {
          apDescriptor->pProtocol->WriteOOB = 2;
       }
@@ -61,24 +61,13 @@ static void InfoMessage( descriptor_t *apDescriptor, const char *apData )
 
 static void CompressStart( descriptor_t *apDescriptor )
 {
-   /* If your mud uses MCCP (Mud Client Compression Protocol), you need to 
-    * call whatever function normally starts compression from here - the 
-    * ReportBug() call should then be deleted.
-    * 
-    * Otherwise you can just ignore this function.
-    */
-   ReportBug( "CompressStart() in protocol.c is being called, but it doesn't do anything!\n" );
+   /* The per-descriptor zlib stream lives in comm.c. */
+   mccp_start( apDescriptor );
 }
 
 static void CompressEnd( descriptor_t *apDescriptor )
 {
-   /* If your mud uses MCCP (Mud Client Compression Protocol), you need to 
-    * call whatever function normally starts compression from here - the 
-    * ReportBug() call should then be deleted.
-    * 
-    * Otherwise you can just ignore this function.
-    */
-   ReportBug( "CompressEnd() in protocol.c is being called, but it doesn't do anything!\n" );
+   mccp_end( apDescriptor );
 }
 
 /******************************************************************************
@@ -1523,7 +1512,8 @@ static void Negotiate( descriptor_t *apDescriptor )
       Write(apDescriptor, DoMXP);
 
 #ifdef USING_MCCP
-      Write(apDescriptor, WillMCCP);
+      if ( CONFIG_MCCP_LEVEL > 0 )
+         Write(apDescriptor, WillMCCP);
 #endif // USING_MCCP
    }
 }
@@ -17,9 +17,7 @@ typedef struct descriptor_data descriptor_t;
  If your mud supports MCCP (compression), uncomment the next line.
  ******************************************************************************/
 
-/*
 #define USING_MCCP
-*/
 
 /******************************************************************************
  If your offer a Mudlet GUI for autoinstallation, put the path/filename here.
@@ -0,0 +1,485 @@
+/**************************************************************************
+ *  File: savequeue.c                                       Part of tbaMUD *
+ *  Usage: Background writer for player and rent files.                    *
+ *                                                                         *
+ *  All rights reserved.  See license for complete information.            *
+ *                                                                         *
+ *  Copyright (C) 1993, 94 by the Trustees of the Johns Hopkins University *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ **************************************************************************/
+
+#include "conf.h"
+#include "sysdep.h"
+#include "structs.h"
+#include "utils.h"
+#include "comm.h"
+#include "savequeue.h"
+
+/* Saves are formatted on the game thread into an in-memory stream opened by
+ * save_open().  save_close() hands the finished buffer to a writer thread,
+ * which writes it to a temporary file, fsyncs it and renames it over the
+ * old file, so neither a slow disk nor a crash mid-write can hurt the game
+ * or the file.  A second save of a file that is still queued replaces the
+ * queued contents instead of writing the file twice.  Anything that reads,
+ * renames or removes a saved file must call save_wait() on it first. */
+
+/* A save still being formatted. */
+struct open_save {
+  FILE *fl;                /* the in-memory stream */
+  char *path;              /* file it will replace */
+  char *data;              /* stream buffer, valid after fclose() */
+  size_t len;              /* bytes in data */
+  struct open_save *next;
+};
+
+/* A formatted save waiting for the writer. */
+struct save_job {
+  char *path;
+  char *data;
+  size_t len;
+  long queued;             /* when it was queued, in microseconds */
+  struct save_job *next;
+};
+
+static struct open_save *open_saves = NULL;
+
+static struct save_job *writing = NULL; /* the job the writer holds */
+static int queue_depth = 0;
+
+/* Statistics for 'show saves'. */
+static unsigned long saves_queued = 0;    /* handed to the writer */
+static unsigned long saves_coalesced = 0; /* replaced a queued save */
+static unsigned long saves_written = 0;
+static unsigned long saves_failed = 0;
+static unsigned long save_stalls = 0;     /* saves that waited for room */
+static long stall_usec = 0;               /* time spent in those waits */
+static int max_depth = 0;
+static long write_samples[SAVE_SAMPLES];  /* ring of recent write times */
+static int write_next = 0, write_count = 0;
+static long write_max = 0;
+static long delay_max = 0;                /* longest time a save sat queued */
+
+/* The last failed write, logged by the game thread. */
+static char error_path[MAX_INPUT_LENGTH];
+static int error_errno = 0;
+static bool error_pending = FALSE;
+
+#ifdef CIRCLE_SAVE_THREAD
+static struct save_job *queue_head = NULL, *queue_tail = NULL;
+static pthread_t save_thread;
+static pthread_mutex_t save_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t save_work = PTHREAD_COND_INITIALIZER; /* queue grew */
+static pthread_cond_t save_done = PTHREAD_COND_INITIALIZER; /* job written */
+static bool save_thread_running = FALSE;
+static bool save_thread_stop = FALSE;
+# define SAVE_LOCK()   pthread_mutex_lock(&save_lock)
+# define SAVE_UNLOCK() pthread_mutex_unlock(&save_lock)
+#else
+# define SAVE_LOCK()
+# define SAVE_UNLOCK()
+#endif
+
+static long save_usec(void);
+static void sync_parent_dir(const char *path);
+static int write_save_file(const char *path, const char *data, size_t len);
+static void record_write(struct save_job *job, long start, int err);
+static void write_job(struct save_job *job);
+static void free_job(struct save_job *job);
+static int compare_samples(const void *a, const void *b);
+#ifdef CIRCLE_SAVE_THREAD
+static void *save_writer(void *arg);
+static bool save_pending(const char *path);
+#endif
+
+static long save_usec(void) {
+#if defined(CLOCK_MONOTONIC) && !defined(CIRCLE_WINDOWS)
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (ts.tv_sec * 1000000L + ts.tv_nsec / 1000);
+#else
+  struct timeval tv;
+
+  gettimeofday(&tv, (struct timezone *)0);
+  return (tv.tv_sec * 1000000L + tv.tv_usec);
+#endif
+}
+
+/* The rename is only durable once the directory holding it is on disk. */
+static void sync_parent_dir(const char *path) {
+  char dir[MAX_INPUT_LENGTH];
+  const char *slash;
+  int fd;
+
+  if (!(slash = strrchr(path, '/')))
+    strcpy(dir, "."); /* strcpy: OK */
+  else
+    snprintf(dir, sizeof(dir), "%.*s", (int)(slash - path), path);
+
+  if ((fd = open(dir, O_RDONLY)) < 0)
+    return;
+  fsync(fd);
+  close(fd);
+}
+
+/* Writes data to path by way of a temporary file.  Returns 0, or the errno
+ * of the step that failed, in which case the old file is left alone. */
+static int write_save_file(const char *path, const char *data, size_t len) {
+  char temp[MAX_INPUT_LENGTH];
+  size_t done = 0;
+  ssize_t n;
+  int fd, err = 0;
+
+  snprintf(temp, sizeof(temp), "%s%s", path, SAVE_TEMP_SUFFIX);
+  if ((fd = open(temp, O_WRONLY | O_CREAT | O_TRUNC, 0666)) < 0)
+    return (errno);
+
+  while (done < len) {
+    if ((n = write(fd, data + done, len - done)) < 0) {
+      if (errno == EINTR)
+        continue;
+      err = errno;
+      break;
+    }
+    done += n;
+  }
+  if (!err && fsync(fd) < 0)
+    err = errno;
+  if (close(fd) < 0 && !err)
+    err = errno;
+  if (!err && rename(temp, path) < 0)
+    err = errno;
+
+  if (err)
+    unlink(temp);
+  else
+    sync_parent_dir(path);
+
+  return (err);
+}
+
+/* Call with the lock held. */
+static void record_write(struct save_job *job, long start, int err) {
+  long now = save_usec();
+
+  if (err) {
+    saves_failed++;
+    snprintf(error_path, sizeof(error_path), "%s", job->path);
+    error_errno = err;
+    error_pending = TRUE;
+    return;
+  }
+
+  saves_written++;
+  write_samples[write_next] = now - start;
+  write_next = (write_next + 1) % SAVE_SAMPLES;
+  if (write_count < SAVE_SAMPLES)
+    write_count++;
+  if (now - start > write_max)
+    write_max = now - start;
+  if (start - job->queued > delay_max)
+    delay_max = start - job->queued;
+}
+
+/* Writes a job straight from the game thread, when there is no writer. */
+static void write_job(struct save_job *job) {
+  long start = save_usec();
+  int err = write_save_file(job->path, job->data, job->len);
+
+  record_write(job, start, err);
+  free_job(job);
+  save_queue_check();
+}
+
+static void free_job(struct save_job *job) {
+  free(job->path);
+  free(job->data);
+  free(job);
+}
+
+#ifdef CIRCLE_SAVE_THREAD
+static void *save_writer(void *arg) {
+  struct save_job *job;
+  long start;
+  int err;
+
+  SAVE_LOCK();
+  for (;;) {
+    while (!queue_head && !save_thread_stop)
+      pthread_cond_wait(&save_work, &save_lock);
+    if (!(job = queue_head))
+      break; /* stopping, and everything is written */
+
+    if (!(queue_head = job->next))
+      queue_tail = NULL;
+    queue_depth--;
+    writing = job;
+    SAVE_UNLOCK();
+
+    start = save_usec();
+    err = write_save_file(job->path, job->data, job->len);
+
+    SAVE_LOCK();
+    record_write(job, start, err);
+    writing = NULL;
+    pthread_cond_broadcast(&save_done);
+    free_job(job);
+  }
+  SAVE_UNLOCK();
+
+  return (NULL);
+}
+
+/* Call with the lock held. */
+static bool save_pending(const char *path) {
+  struct save_job *job;
+
+  if (writing && !strcmp(writing->path, path))
+    return (TRUE);
+  for (job = queue_head; job; job = job->next)
+    if (!strcmp(job->path, path))
+      return (TRUE);
+  return (FALSE);
+}
+#endif
+
+void init_save_queue(void) {
+#ifdef CIRCLE_SAVE_THREAD
+  int err;
+
+  save_thread_stop = FALSE;
+  if ((err = pthread_create(&save_thread, NULL, save_writer, NULL)) != 0) {
+    log("SYSERR: Cannot start the save writer, saving synchronously: %s",
+        strerror(err));
+    return;
+  }
+  save_thread_running = TRUE;
+#endif
+}
+
+/* Writes everything still queued and stops the writer.  Later saves are
+ * written synchronously. */
+void shutdown_save_queue(void) {
+#ifdef CIRCLE_SAVE_THREAD
+  if (!save_thread_running)
+    return;
+
+  SAVE_LOCK();
+  save_thread_stop = TRUE;
+  pthread_cond_signal(&save_work);
+  SAVE_UNLOCK();
+
+  pthread_join(save_thread, NULL);
+  save_thread_running = FALSE;
+#endif
+  save_queue_check();
+}
+
+/* Opens a stream to use in place of fopen(path, "w").  Nothing reaches the
+ * disk until save_close(). */
+FILE *save_open(const char *path) {
+  struct open_save *os;
+
+  CREATE(os, struct open_save, 1);
+  if (!(os->fl = open_memstream(&os->data, &os->len))) {
+    log("SYSERR: save_open: %s: %s", path, strerror(errno));
+    free(os);
+    return (NULL);
+  }
+  os->path = strdup(path);
+  os->next = open_saves;
+  open_saves = os;
+
+  return (os->fl);
+}
+
+/* Finishes a stream from save_open() and queues it to replace its file.
+ * Returns 0, or EOF if the stream could not be finished. */
+int save_close(FILE *fl) {
+  struct open_save *os, *prev = NULL;
+  struct save_job *job;
+
+  for (os = open_saves; os && os->fl != fl; prev = os, os = os->next)
+    ;
+  if (!os) {
+    log("SYSERR: save_close: stream was not opened with save_open()");
+    return (fclose(fl));
+  }
+  if (prev)
+    prev->next = os->next;
+  else
+    open_saves = os->next;
+
+  if (fclose(fl) != 0) {
+    log("SYSERR: save_close: %s: %s", os->path, strerror(errno));
+    free(os->path);
+    free(os->data);
+    free(os);
+    return (EOF);
+  }
+
+  CREATE(job, struct save_job, 1);
+  job->path = os->path;
+  job->data = os->data;
+  job->len = os->len;
+  job->queued = save_usec();
+  free(os);
+
+#ifdef CIRCLE_SAVE_THREAD
+  if (save_thread_running) {
+    struct save_job *j;
+    long start;
+
+    SAVE_LOCK();
+    for (j = queue_head; j; j = j->next)
+      if (!strcmp(j->path, job->path))
+        break;
+    if (j) {
+      /* Not written yet, so the new contents simply take its place. */
+      free(j->data);
+      j->data = job->data;
+      j->len = job->len;
+      job->data = NULL;
+      saves_coalesced++;
+    } else {
+      if (queue_depth >= SAVE_QUEUE_MAX) {
+        save_stalls++;
+        start = save_usec();
+        while (queue_depth >= SAVE_QUEUE_MAX)
+          pthread_cond_wait(&save_done, &save_lock);
+        stall_usec += save_usec() - start;
+      }
+      if (queue_tail)
+        queue_tail->next = job;
+      else
+        queue_head = job;
+      queue_tail = job;
+      max_depth = MAX(max_depth, ++queue_depth);
+      saves_queued++;
+      pthread_cond_signal(&save_work);
+    }
+    SAVE_UNLOCK();
+
+    if (j)
+      free_job(job);
+    save_queue_check();
+    return (0);
+  }
+#endif
+
+  saves_queued++;
+  write_job(job);
+  return (0);
+}
+
+/* Throws away a stream from save_open(), leaving the file as it was. */
+void save_abort(FILE *fl) {
+  struct open_save *os, *prev = NULL;
+
+  for (os = open_saves; os && os->fl != fl; prev = os, os = os->next)
+    ;
+  fclose(fl);
+  if (!os)
+    return;
+  if (prev)
+    prev->next = os->next;
+  else
+    open_saves = os->next;
+  free(os->path);
+  free(os->data);
+  free(os);
+}
+
+/* Blocks until no save of path is queued or being written. */
+void save_wait(const char *path) {
+#ifdef CIRCLE_SAVE_THREAD
+  if (!save_thread_running)
+    return;
+
+  SAVE_LOCK();
+  while (save_pending(path))
+    pthread_cond_wait(&save_done, &save_lock);
+  SAVE_UNLOCK();
+#endif
+}
+
+/* Blocks until every queued save is on disk. */
+void save_flush(void) {
+#ifdef CIRCLE_SAVE_THREAD
+  if (!save_thread_running)
+    return;
+
+  SAVE_LOCK();
+  while (queue_head || writing)
+    pthread_cond_wait(&save_done, &save_lock);
+  SAVE_UNLOCK();
+#endif
+  save_queue_check();
+}
+
+/* Logs a failed write.  The writer thread cannot log safely itself. */
+void save_queue_check(void) {
+  char path[MAX_INPUT_LENGTH];
+  int err;
+
+  SAVE_LOCK();
+  if (!error_pending) {
+    SAVE_UNLOCK();
+    return;
+  }
+  strcpy(path, error_path); /* strcpy: OK (same size) */
+  err = error_errno;
+  error_pending = FALSE;
+  SAVE_UNLOCK();
+
+  mudlog(BRF, LVL_IMMORT, TRUE, "SYSERR: Couldn't write %s: %s", path,
+         strerror(err));
+}
+
+static int compare_samples(const void *a, const void *b) {
+  long x = *(const long *)a, y = *(const long *)b;
+
+  return (x < y ? -1 : x > y ? 1 : 0);
+}
+
+void show_save_queue(struct char_data *ch) {
+  long sorted[SAVE_SAMPLES];
+  char now_writing[MAX_INPUT_LENGTH];
+  int count, depth;
+  bool threaded = FALSE;
+
+#ifdef CIRCLE_SAVE_THREAD
+  threaded = save_thread_running;
+#endif
+
+  SAVE_LOCK();
+  count = write_count;
+  memcpy(sorted, write_samples, sizeof(long) * count);
+  depth = queue_depth;
+  snprintf(now_writing, sizeof(now_writing), "%s",
+           writing ? writing->path : "nothing");
+
+  send_to_char(ch,
+               "Save writer: %s\r\n"
+               "  Queued now : %d (most %d, limit %d), writing %s\r\n"
+               "  Saves      : %lu queued, %lu coalesced, %lu written, "
+               "%lu failed\r\n"
+               "  Stalls     : %lu, %ld ms in total\r\n",
+               threaded ? "background thread" : "synchronous", depth,
+               max_depth, SAVE_QUEUE_MAX, now_writing, saves_queued,
+               saves_coalesced, saves_written, saves_failed, save_stalls,
+               stall_usec / 1000);
+  if (error_errno)
+    send_to_char(ch, "  Last error : %s: %s\r\n", error_path,
+                 strerror(error_errno));
+  if (count) {
+    qsort(sorted, count, sizeof(long), compare_samples);
+    send_to_char(ch,
+                 "  Write time : %ld us median, %ld us p99, %ld us max "
+                 "(last %d)\r\n"
+                 "  Queue delay: %ld us max\r\n",
+                 sorted[count / 2], sorted[(count * 99) / 100], write_max,
+                 count, delay_max);
+  }
+  SAVE_UNLOCK();
+}
@@ -0,0 +1,36 @@
+/**
+* @file savequeue.h
+* Background writer for player and rent files.
+*
+* Part of the core tbaMUD source code distribution, which is a derivative
+* of, and continuation of, CircleMUD.
+*
+* All rights reserved.  See license for complete information.
+* Copyright (C) 1993, 94 by the Trustees of the Johns Hopkins University
+* CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.
+*/
+#ifndef _SAVEQUEUE_H_
+#define _SAVEQUEUE_H_
+
+/** Files waiting to be written before a new save blocks the game until the
+ * writer catches up. */
+#define SAVE_QUEUE_MAX     128
+
+/** Suffix of the file a save is written to before it replaces the old one. */
+#define SAVE_TEMP_SUFFIX   ".tmp"
+
+/** How many of the most recent writes the 'show saves' percentiles cover. */
+#define SAVE_SAMPLES       256
+
+/* Functions */
+void init_save_queue(void);
+void shutdown_save_queue(void);
+FILE *save_open(const char *path);
+int save_close(FILE *fl);
+void save_abort(FILE *fl);
+void save_wait(const char *path);
+void save_flush(void);
+void save_queue_check(void);
+void show_save_queue(struct char_data *ch);
+
+#endif /* _SAVEQUEUE_H_ */
@@ -256,7 +256,7 @@ static int evaluate_expression(struct obj_data *obj, char *expr) {
             break;
           }
         if (*extra_bits[eindex] == '\n')
-          push(&vals, isname(name, obj->name));
+          push(&vals, isname_obj(name, obj));
       } else {
         if (temp != OPER_OPEN_PAREN)
           while (top(&ops) > temp)
@@ -385,7 +385,7 @@ static struct obj_data *get_slide_obj_vis(struct char_data *ch, char *name,
     return (NULL);
 
   for (i = list, j = 1; i && (j <= number); i = i->next_content)
-    if (isname(tmp, i->name))
+    if (isname_obj(tmp, i))
       if (CAN_SEE_OBJ(ch, i) && !same_obj(last_match, i)) {
         if (j == number)
           return (i);
@@ -952,7 +952,7 @@ static void shopping_list(char *arg, struct char_data *ch,
           cnt++;
         else {
           lindex++;
-          if (!*name || isname(name, last_obj->name)) {
+          if (!*name || isname_obj(name, last_obj)) {
             strncat(buf,
                     list_object(last_obj, cnt, lindex, shop_nr, keeper, ch),
                     sizeof(buf) - len - 1); /* strncat: OK */
@@ -973,7 +973,7 @@ static void shopping_list(char *arg, struct char_data *ch,
   else if (*name && !found) /* nothing the char was looking for was found */
     send_to_char(ch, "Presently, none of those are for sale.\r\n");
   else {
-    if (!*name || isname(name, last_obj->name)) /* show last obj */
+    if (!*name || isname_obj(name, last_obj)) /* show last obj */
       if (len < sizeof(buf))
         strncat(buf, list_object(last_obj, cnt, lindex, shop_nr, keeper, ch),
                 sizeof(buf) - len - 1); /* strncat: OK */
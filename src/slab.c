@@ -0,0 +1,206 @@
+/**************************************************************************
+ *  File: slab.c                                            Part of tbaMUD *
+ *  Usage: Free list allocators for characters, objects and the like.      *
+ *                                                                         *
+ *  All rights reserved.  See license for complete information.            *
+ *                                                                         *
+ *  Copyright (C) 1993, 94 by the Trustees of the Johns Hopkins University *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ **************************************************************************/
+
+#include "conf.h"
+#include "sysdep.h"
+#include "structs.h"
+#include "utils.h"
+#include "comm.h"
+#include "dg_scripts.h"
+#include "dg_event.h"
+#include "lists.h"
+#include "slab.h"
+
+/* Zone resets, combat and scripts make and free characters, objects,
+ * affects, triggers, list nodes and events by the thousand.  Each kind has
+ * a slab here: freed structures go on a free list and are handed out again
+ * before any new memory is asked for, so the heap is not cut up by them and
+ * the memory they use stays at its high-water mark rather than creeping.
+ * Blocks are never given back until shutdown.
+ *
+ * A slot from slab_alloc() is zeroed, as CREATE() would leave it, and must
+ * go back to the same slab with slab_free(), never to free(). */
+
+struct slab_block {
+  struct slab_block *next;
+  char *mem;
+};
+
+struct slab char_slab = SLAB("characters", struct char_data);
+struct slab obj_slab = SLAB("objects", struct obj_data);
+struct slab affect_slab = SLAB("affects", struct affected_type);
+/* Trigger prototypes are parsed on the boot threads. */
+struct slab trig_slab = {"triggers", sizeof(struct trig_data), TRUE, NULL, NULL,
+                         0, 0, 0, 0};
+struct slab list_item_slab = SLAB("list items", struct item_data);
+struct slab event_slab = SLAB("events", struct event);
+struct slab q_element_slab = SLAB("queue elements", struct q_element);
+
+static struct slab *slabs[] = {&char_slab,      &obj_slab,   &affect_slab,
+                               &trig_slab,      &list_item_slab,
+                               &event_slab,     &q_element_slab};
+
+#define NUM_SLABS (int)(sizeof(slabs) / sizeof(slabs[0]))
+
+#ifdef CIRCLE_PARALLEL_BOOT
+static pthread_mutex_t slab_lock = PTHREAD_MUTEX_INITIALIZER;
+#define SLAB_LOCK(s)                                                           \
+  do {                                                                         \
+    if ((s)->threaded)                                                         \
+      pthread_mutex_lock(&slab_lock);                                          \
+  } while (0)
+#define SLAB_UNLOCK(s)                                                         \
+  do {                                                                         \
+    if ((s)->threaded)                                                         \
+      pthread_mutex_unlock(&slab_lock);                                        \
+  } while (0)
+#else
+#define SLAB_LOCK(s)
+#define SLAB_UNLOCK(s)
+#endif
+
+/* Local functions */
+static int slab_per_block(struct slab *s);
+static void grow_slab(struct slab *s);
+#ifdef SLAB_POISON
+static int slot_poisoned(struct slab *s, void *ptr);
+#endif
+
+/* Slots per block: enough to fill SLAB_BLOCK_SIZE, and never fewer than 16
+ * for the large structures. */
+static int slab_per_block(struct slab *s) {
+  return (MAX(SLAB_BLOCK_SIZE / s->size, 16));
+}
+
+static void grow_slab(struct slab *s) {
+  struct slab_block *block;
+  int i, n = slab_per_block(s);
+  char *slot;
+
+  CREATE(block, struct slab_block, 1);
+  CREATE(block->mem, char, s->size * n);
+  block->next = s->blocks;
+  s->blocks = block;
+
+  /* Linked back to front, so the block is handed out in address order. */
+  for (i = n - 1; i >= 0; i--) {
+    slot = block->mem + i * s->size;
+#ifdef SLAB_POISON
+    memset(slot, SLAB_POISON_BYTE, s->size);
+#endif
+    *(void **)slot = s->free_list;
+    s->free_list = slot;
+  }
+  s->free += n;
+}
+
+#ifdef SLAB_POISON
+/* TRUE if everything past the free list link still holds the poison. */
+static int slot_poisoned(struct slab *s, void *ptr) {
+  unsigned char *p = (unsigned char *)ptr + sizeof(void *);
+  unsigned char *end = (unsigned char *)ptr + s->size;
+
+  for (; p < end; p++)
+    if (*p != SLAB_POISON_BYTE)
+      return (FALSE);
+
+  return (TRUE);
+}
+#endif
+
+void *slab_alloc(struct slab *s) {
+  void *ptr;
+
+  SLAB_LOCK(s);
+  if (!s->free_list)
+    grow_slab(s);
+
+  ptr = s->free_list;
+  s->free_list = *(void **)ptr;
+  s->free--;
+  s->allocs++;
+  if (++s->live > s->high_water)
+    s->high_water = s->live;
+  SLAB_UNLOCK(s);
+
+#ifdef SLAB_POISON
+  if (!slot_poisoned(s, ptr))
+    log("SYSERR: slab_alloc: %s slot %p was written to after it was freed.",
+        s->name, ptr);
+#endif
+  memset(ptr, 0, s->size);
+
+  return (ptr);
+}
+
+void slab_free(struct slab *s, void *ptr) {
+  if (!ptr)
+    return;
+
+#ifdef SLAB_POISON
+  if (slot_poisoned(s, ptr)) {
+    log("SYSERR: slab_free: %s slot %p freed twice.", s->name, ptr);
+    return;
+  }
+  memset(ptr, SLAB_POISON_BYTE, s->size);
+#endif
+
+  SLAB_LOCK(s);
+  *(void **)ptr = s->free_list;
+  s->free_list = ptr;
+  s->free++;
+  s->live--;
+  SLAB_UNLOCK(s);
+}
+
+/* Gives every block back at shutdown.  Nothing may use a slot after this. */
+void free_slabs(void) {
+  struct slab_block *block, *next;
+  int i;
+
+  for (i = 0; i < NUM_SLABS; i++) {
+    for (block = slabs[i]->blocks; block; block = next) {
+      next = block->next;
+      free(block->mem);
+      free(block);
+    }
+    slabs[i]->blocks = NULL;
+    slabs[i]->free_list = NULL;
+    slabs[i]->live = slabs[i]->free = 0;
+  }
+}
+
+void show_slabs(struct char_data *ch) {
+  struct slab *s;
+  size_t bytes, total = 0;
+  int i;
+
+  send_to_char(ch,
+               "Slab            Size     Live     Free  High water       "
+               "Allocs     Memory\r\n"
+               "--------------  ----  -------  -------  ----------  "
+               "-----------  ---------\r\n");
+  for (i = 0; i < NUM_SLABS; i++) {
+    s = slabs[i];
+    bytes = (size_t)(s->live + s->free) * s->size;
+    total += bytes;
+    send_to_char(ch, "%-14s  %4d  %7d  %7d  %10d  %11lu  %8luk\r\n", s->name,
+                 (int)s->size, s->live, s->free, s->high_water, s->allocs,
+                 (unsigned long)(bytes / 1024));
+  }
+  send_to_char(ch, "Total %luk in blocks of %dk.%s\r\n",
+               (unsigned long)(total / 1024), SLAB_BLOCK_SIZE / 1024,
+#ifdef SLAB_POISON
+               "  Freed slots are poisoned."
+#else
+               ""
+#endif
+  );
+}
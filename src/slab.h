@@ -0,0 +1,60 @@
+/**
+* @file slab.h
+* Free list allocators for the structures the game makes and frees all the
+* time.
+*
+* Part of the core tbaMUD source code distribution, which is a derivative
+* of, and continuation of, CircleMUD.
+*
+* All rights reserved.  See license for complete information.
+* Copyright (C) 1993, 94 by the Trustees of the Johns Hopkins University
+* CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.
+*/
+#ifndef _SLAB_H_
+#define _SLAB_H_
+
+/** Slabs grow by blocks of about this many bytes. */
+#define SLAB_BLOCK_SIZE  65536
+
+/** Define to fill freed slots with SLAB_POISON_BYTE and check they are still
+ * filled when handed out again, which catches writes through a pointer to
+ * something already freed and reads of it soon crash.  Freeing a slot
+ * twice is caught as well.  Always on with MEMORY_DEBUG. */
+/* #define SLAB_POISON */
+#ifdef MEMORY_DEBUG
+#define SLAB_POISON
+#endif
+#define SLAB_POISON_BYTE 0x5A
+
+struct slab_block;
+
+/** A free list of one kind of structure, carved out of large blocks. */
+struct slab {
+  const char *name;          /**< What it holds, for 'show slabs'. */
+  size_t size;               /**< Size of one slot. */
+  bool threaded;             /**< Used by the boot threads, so locked. */
+  void *free_list;           /**< Free slots, linked through their first word. */
+  struct slab_block *blocks; /**< Every block carved up for this slab. */
+  int live;                  /**< Slots handed out. */
+  int free;                  /**< Slots on the free list. */
+  int high_water;            /**< Most slots ever handed out at once. */
+  unsigned long allocs;      /**< Slots ever handed out. */
+};
+
+#define SLAB(name, type) { (name), sizeof(type), FALSE, NULL, NULL, 0, 0, 0, 0 }
+
+extern struct slab char_slab;
+extern struct slab obj_slab;
+extern struct slab affect_slab;
+extern struct slab trig_slab;
+extern struct slab list_item_slab;
+extern struct slab event_slab;
+extern struct slab q_element_slab;
+
+/* Functions */
+void *slab_alloc(struct slab *s);
+void slab_free(struct slab *s, void *ptr);
+void free_slabs(void);
+void show_slabs(struct char_data *ch);
+
+#endif /* _SLAB_H_ */
@@ -0,0 +1,880 @@
+/**************************************************************************
+ *  File: snapshot.c                                        Part of tbaMUD *
+ *  Usage: Compiled snapshots of the world and help files for fast boots.  *
+ *                                                                         *
+ *  All rights reserved.  See license for complete information.            *
+ *                                                                         *
+ *  Copyright (C) 1993, 94 by the Trustees of the Johns Hopkins University *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ **************************************************************************/
+
+#include "conf.h"
+#include "sysdep.h"
+#include "structs.h"
+#include "utils.h"
+#include "comm.h"
+#include "db.h"
+#include "dg_scripts.h"
+#include "savequeue.h"
+#include "slab.h"
+#include "snapshot.h"
+#include "strpool.h"
+
+/* Once the world files have been parsed at boot, the records they produced
+ * are written to a snapshot: each structure as it sits in memory, followed
+ * by the strings and lists it points to.  The snapshot names every file it
+ * was built from, with its size and modification time.  On the next boot,
+ * if those all still match and the snapshot was written by this build, it
+ * is mapped into memory and the structures are copied out of it with their
+ * pointers rebuilt, instead of the text being parsed again.  Strings are
+ * copied to the heap, since OLC and destroy_db() free them.
+ *
+ * Editing a world file changes its time, so the next boot parses the text
+ * and writes a new snapshot.  Deleting a snapshot forces the same.  Help
+ * entries have a snapshot of their own, as they are loaded separately. */
+
+#define SNAPSHOT_MAGIC "tbasnap"
+
+/* Structure sizes in the header; a snapshot with other sizes is not read. */
+#define SNAP_LAYOUT_MAX 12
+
+struct snapshot_header {
+  char magic[8];
+  int version;
+  char build[32];                /* when this snapshot.c was compiled */
+  int layout[SNAP_LAYOUT_MAX];
+  int diagonal_dirs;             /* exits are dropped without them */
+  long long length;              /* bytes after the header */
+  unsigned long long hash;       /* of those bytes */
+};
+
+/* A file a snapshot was built from. */
+struct snapshot_source {
+  char *path;
+  long long size;                /* -1 if it could not be read */
+  long long mtime;
+};
+
+struct snapshot_sources {
+  struct snapshot_source *list;
+  int num;
+  bool ok;                       /* every index file was read */
+};
+
+/* A snapshot mapped into memory. */
+struct snapshot_reader {
+  char *map;
+  size_t maplen;
+  const char *pos, *end;
+  bool bad;                      /* a read ran off the end */
+};
+
+static const char *world_prefixes[] = {ZON_PREFIX, TRG_PREFIX, WLD_PREFIX,
+                                       MOB_PREFIX, OBJ_PREFIX};
+static const char *help_prefixes[] = {HLP_PREFIX};
+
+/* Files the world and help were loaded from, taken before they are parsed. */
+static struct snapshot_sources world_sources, help_sources;
+
+/* Local functions */
+#ifdef CIRCLE_SNAPSHOT
+static void init_header(struct snapshot_header *hdr);
+static unsigned long long snapshot_hash(const char *data, size_t len);
+#endif
+static void free_sources(struct snapshot_sources *s);
+static void add_source(struct snapshot_sources *s, const char *path);
+static int collect_sources(struct snapshot_sources *s, const char **prefixes,
+                           int num);
+static int open_snapshot(const char *path, struct snapshot_sources *s,
+                         struct snapshot_reader *r);
+static void close_snapshot(struct snapshot_reader *r, const char *path);
+static void write_snapshot(const char *path, struct snapshot_sources *s,
+                           void (*write_body)(FILE *fl));
+static void read_raw(struct snapshot_reader *r, void *dst, size_t len);
+static int read_int(struct snapshot_reader *r);
+static int read_count(struct snapshot_reader *r, size_t unit);
+static char *read_string(struct snapshot_reader *r);
+static char *read_pooled_string(struct snapshot_reader *r);
+static void write_int(FILE *fl, int i);
+static void write_string(FILE *fl, const char *str);
+static struct extra_descr_data *read_ex_descs(struct snapshot_reader *r);
+static void write_ex_descs(FILE *fl, struct extra_descr_data *ex);
+static struct trig_proto_list *read_proto_script(struct snapshot_reader *r);
+static void write_proto_script(FILE *fl, struct trig_proto_list *list);
+static void read_zones(struct snapshot_reader *r);
+static void write_zones(FILE *fl);
+static void read_triggers(struct snapshot_reader *r);
+static void write_triggers(FILE *fl);
+static void read_rooms(struct snapshot_reader *r);
+static void write_rooms(FILE *fl);
+static void read_mobiles(struct snapshot_reader *r);
+static void write_mobiles(FILE *fl);
+static void read_objects(struct snapshot_reader *r);
+static void write_objects(FILE *fl);
+static void write_world(FILE *fl);
+static void write_help(FILE *fl);
+static int help_owner_cmp(const void *a, const void *b);
+
+#ifdef CIRCLE_SNAPSHOT
+static void init_header(struct snapshot_header *hdr) {
+  memset(hdr, 0, sizeof(*hdr));
+  strncpy(hdr->magic, SNAPSHOT_MAGIC, sizeof(hdr->magic));
+  hdr->version = SNAPSHOT_VERSION;
+  strncpy(hdr->build, __DATE__ " " __TIME__, sizeof(hdr->build) - 1);
+  hdr->layout[0] = sizeof(struct room_data);
+  hdr->layout[1] = sizeof(struct room_direction_data);
+  hdr->layout[2] = sizeof(struct extra_descr_data);
+  hdr->layout[3] = sizeof(struct char_data);
+  hdr->layout[4] = sizeof(struct obj_data);
+  hdr->layout[5] = sizeof(struct index_data);
+  hdr->layout[6] = sizeof(struct zone_data);
+  hdr->layout[7] = sizeof(struct reset_com);
+  hdr->layout[8] = sizeof(struct trig_data);
+  hdr->layout[9] = sizeof(struct cmdlist_element);
+  hdr->layout[10] = sizeof(struct help_index_element);
+  hdr->layout[11] = sizeof(void *);
+  hdr->diagonal_dirs = CONFIG_DIAGONAL_DIRS;
+}
+
+/* FNV-1a, a word at a time. */
+static unsigned long long snapshot_hash(const char *data, size_t len) {
+  unsigned long long h = 14695981039346656037ULL, w;
+
+  for (; len >= sizeof(w); data += sizeof(w), len -= sizeof(w)) {
+    memcpy(&w, data, sizeof(w));
+    h = (h ^ w) * 1099511628211ULL;
+  }
+  while (len--)
+    h = (h ^ (unsigned char)*data++) * 1099511628211ULL;
+
+  return (h);
+}
+#endif
+
+static void free_sources(struct snapshot_sources *s) {
+  int i;
+
+  for (i = 0; i < s->num; i++)
+    free(s->list[i].path);
+  if (s->list)
+    free(s->list);
+  s->list = NULL;
+  s->num = 0;
+  s->ok = FALSE;
+}
+
+static void add_source(struct snapshot_sources *s, const char *path) {
+  struct snapshot_source *src;
+  struct stat st;
+
+  RECREATE(s->list, struct snapshot_source, s->num + 1);
+  src = &s->list[s->num++];
+  src->path = strdup(path);
+  if (stat(path, &st) < 0) {
+    src->size = -1;
+    src->mtime = 0;
+  } else {
+    src->size = st.st_size;
+    src->mtime = st.st_mtime;
+  }
+}
+
+/* Lists the index files under each prefix and every file they name, the
+ * same way index_boot() reads them.  Problems are left for index_boot() to
+ * report. */
+static int collect_sources(struct snapshot_sources *s, const char **prefixes,
+                           int num) {
+  char path[PATH_MAX], name[PATH_MAX - 100];
+  FILE *index;
+  int i;
+
+  free_sources(s);
+
+  for (i = 0; i < num; i++) {
+    snprintf(path, sizeof(path), "%s%s", prefixes[i],
+             mini_mud ? MINDEX_FILE : INDEX_FILE);
+    if (!(index = fopen(path, "r")))
+      return (FALSE);
+    add_source(s, path);
+
+    *name = '\0';
+    while (fscanf(index, "%s\n", name) == 1 && *name != '$') {
+      snprintf(path, sizeof(path), "%s%s", prefixes[i], name);
+      add_source(s, path);
+    }
+    if (*name != '$') {
+      fclose(index);
+      return (FALSE);
+    }
+    fclose(index);
+  }
+
+  return (s->ok = TRUE);
+}
+
+/* Maps a snapshot and checks that it can be used in place of the files in
+ * s.  Leaves r at the first record if so. */
+static int open_snapshot(const char *path, struct snapshot_sources *s,
+                         struct snapshot_reader *r) {
+#ifdef CIRCLE_SNAPSHOT
+  struct snapshot_header hdr, want;
+  struct stat st;
+  const char *reason = NULL;
+  char *src;
+  long long size, mtime;
+  int fd, i;
+
+  memset(r, 0, sizeof(*r));
+  if (!s->ok)
+    return (FALSE);
+
+  if ((fd = open(path, O_RDONLY)) < 0) {
+    if (errno != ENOENT)
+      log("SYSERR: Opening snapshot %s: %s", path, strerror(errno));
+    return (FALSE);
+  }
+  if (fstat(fd, &st) < 0 || st.st_size < (off_t)sizeof(hdr)) {
+    log("Not using snapshot %s: it is truncated.", path);
+    close(fd);
+    return (FALSE);
+  }
+  r->maplen = st.st_size;
+  r->map = mmap(NULL, r->maplen, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (r->map == MAP_FAILED) {
+    log("SYSERR: Mapping snapshot %s: %s", path, strerror(errno));
+    r->map = NULL;
+    return (FALSE);
+  }
+  r->pos = r->map + sizeof(hdr);
+  r->end = r->map + r->maplen;
+
+  memcpy(&hdr, r->map, sizeof(hdr));
+  init_header(&want);
+  want.length = hdr.length;
+  want.hash = hdr.hash;
+  if (memcmp(&hdr, &want, sizeof(hdr)))
+    reason = "it was written by another build";
+  else if (hdr.length != (long long)(r->maplen - sizeof(hdr)) ||
+           hdr.hash != snapshot_hash(r->pos, hdr.length))
+    reason = "it is corrupt";
+  else if (read_int(r) != s->num)
+    reason = "the files it was built from have changed";
+  else
+    for (i = 0; i < s->num && !reason; i++) {
+      src = read_string(r);
+      read_raw(r, &size, sizeof(size));
+      read_raw(r, &mtime, sizeof(mtime));
+      if (!src || strcmp(src, s->list[i].path) || size != s->list[i].size ||
+          mtime != s->list[i].mtime)
+        reason = "the files it was built from have changed";
+      if (src)
+        free(src);
+    }
+
+  if (reason) {
+    log("Not using snapshot %s: %s.", path, reason);
+    munmap(r->map, r->maplen);
+    r->map = NULL;
+    return (FALSE);
+  }
+  return (TRUE);
+#else
+  return (FALSE);
+#endif
+}
+
+/* A snapshot that passed its checks but did not read back cleanly can only
+ * come from a bug in the writer.  Half the world has been built from it by
+ * then, so remove it and stop; the next boot parses the files. */
+static void close_snapshot(struct snapshot_reader *r, const char *path) {
+#ifdef CIRCLE_SNAPSHOT
+  if (r->map)
+    munmap(r->map, r->maplen);
+  r->map = NULL;
+#endif
+  if (r->bad || r->pos != r->end) {
+    log("SYSERR: Snapshot %s does not match its own contents, removing it.",
+        path);
+    remove(path);
+    exit(1);
+  }
+}
+
+/* Formats a snapshot in memory and hands it to the save writer. */
+static void write_snapshot(const char *path, struct snapshot_sources *s,
+                           void (*write_body)(FILE *fl)) {
+#ifdef CIRCLE_SNAPSHOT
+  struct snapshot_header hdr;
+  char *data = NULL;
+  size_t len = 0;
+  FILE *body, *fl;
+  int i;
+
+  if (!s->ok)
+    return;
+
+  if (!(body = open_memstream(&data, &len))) {
+    log("SYSERR: Formatting snapshot %s: %s", path, strerror(errno));
+    return;
+  }
+  write_int(body, s->num);
+  for (i = 0; i < s->num; i++) {
+    write_string(body, s->list[i].path);
+    fwrite(&s->list[i].size, sizeof(s->list[i].size), 1, body);
+    fwrite(&s->list[i].mtime, sizeof(s->list[i].mtime), 1, body);
+  }
+  write_body(body);
+
+  if (ferror(body) | fclose(body)) {
+    log("SYSERR: Formatting snapshot %s: %s", path, strerror(errno));
+    if (data)
+      free(data);
+    return;
+  }
+
+  init_header(&hdr);
+  hdr.length = len;
+  hdr.hash = snapshot_hash(data, len);
+
+  if ((fl = save_open(path)) != NULL) {
+    fwrite(&hdr, sizeof(hdr), 1, fl);
+    fwrite(data, 1, len, fl);
+    save_close(fl);
+  }
+  free(data);
+#endif
+}
+
+static void read_raw(struct snapshot_reader *r, void *dst, size_t len) {
+  if (r->bad || (size_t)(r->end - r->pos) < len) {
+    r->bad = TRUE;
+    memset(dst, 0, len);
+    return;
+  }
+  memcpy(dst, r->pos, len);
+  r->pos += len;
+}
+
+static int read_int(struct snapshot_reader *r) {
+  int i;
+
+  read_raw(r, &i, sizeof(i));
+  return (i);
+}
+
+/* Reads a count of records taking at least unit bytes each. */
+static int read_count(struct snapshot_reader *r, size_t unit) {
+  int num = read_int(r);
+
+  if (num < 0 || (size_t)num > (size_t)(r->end - r->pos) / unit) {
+    r->bad = TRUE;
+    return (0);
+  }
+  return (num);
+}
+
+static char *read_string(struct snapshot_reader *r) {
+  int len = read_int(r);
+  char *str;
+
+  if (len < 0 || r->bad)
+    return (NULL);
+  if ((size_t)len > (size_t)(r->end - r->pos)) {
+    r->bad = TRUE;
+    return (NULL);
+  }
+  CREATE(str, char, len + 1);
+  memcpy(str, r->pos, len);
+  r->pos += len;
+
+  return (str);
+}
+
+/* As read_string(), for world and prototype text that lives in the pool. */
+static char *read_pooled_string(struct snapshot_reader *r) {
+  int len = read_int(r);
+  char *str;
+
+  if (len < 0 || r->bad)
+    return (NULL);
+  if ((size_t)len > (size_t)(r->end - r->pos)) {
+    r->bad = TRUE;
+    return (NULL);
+  }
+  str = str_intern_len(r->pos, len);
+  r->pos += len;
+
+  return (str);
+}
+
+static void write_int(FILE *fl, int i) {
+  fwrite(&i, sizeof(i), 1, fl);
+}
+
+static void write_string(FILE *fl, const char *str) {
+  int len = str ? strlen(str) : -1;
+
+  write_int(fl, len);
+  if (len > 0)
+    fwrite(str, 1, len, fl);
+}
+
+static struct extra_descr_data *read_ex_descs(struct snapshot_reader *r) {
+  struct extra_descr_data *head = NULL, **tail = &head;
+  int num = read_count(r, 2 * sizeof(int));
+
+  while (num--) {
+    CREATE(*tail, struct extra_descr_data, 1);
+    (*tail)->keyword = read_pooled_string(r);
+    (*tail)->description = read_pooled_string(r);
+    tail = &(*tail)->next;
+  }
+  return (head);
+}
+
+static void write_ex_descs(FILE *fl, struct extra_descr_data *ex) {
+  struct extra_descr_data *e;
+  int num = 0;
+
+  for (e = ex; e; e = e->next)
+    num++;
+  write_int(fl, num);
+  for (e = ex; e; e = e->next) {
+    write_string(fl, e->keyword);
+    write_string(fl, e->description);
+  }
+}
+
+static struct trig_proto_list *read_proto_script(struct snapshot_reader *r) {
+  struct trig_proto_list *head = NULL, **tail = &head;
+  int num = read_count(r, sizeof(int));
+
+  while (num--) {
+    CREATE(*tail, struct trig_proto_list, 1);
+    (*tail)->vnum = read_int(r);
+    tail = &(*tail)->next;
+  }
+  return (head);
+}
+
+static void write_proto_script(FILE *fl, struct trig_proto_list *list) {
+  struct trig_proto_list *t;
+  int num = 0;
+
+  for (t = list; t; t = t->next)
+    num++;
+  write_int(fl, num);
+  for (t = list; t; t = t->next)
+    write_int(fl, t->vnum);
+}
+
+/* Each record is written as the structure itself, pointers and all, then
+ * whatever those pointers lead to.  Readers copy the structure back and
+ * replace the pointers that were followed.  Any other pointer in a
+ * prototype is NULL when the snapshot is written, as nothing has been
+ * loaded from it yet. */
+
+static void read_zones(struct snapshot_reader *r) {
+  int num = read_count(r, sizeof(struct zone_data)), i, j, cmds;
+  struct zone_data *z;
+
+  if (!num) {
+    r->bad = TRUE;
+    return;
+  }
+  CREATE(zone_table, struct zone_data, num);
+  top_of_zone_table = num - 1;
+
+  for (i = 0; i < num; i++) {
+    z = &zone_table[i];
+    read_raw(r, z, sizeof(*z));
+    z->name = read_string(r);
+    z->builders = read_string(r);
+    z->cmd = NULL;
+    if ((cmds = read_count(r, sizeof(struct reset_com))) > 0) {
+      CREATE(z->cmd, struct reset_com, cmds);
+      read_raw(r, z->cmd, sizeof(struct reset_com) * cmds);
+      for (j = 0; j < cmds; j++) {
+        z->cmd[j].sarg1 = read_string(r);
+        z->cmd[j].sarg2 = read_string(r);
+      }
+    }
+  }
+}
+
+static void write_zones(FILE *fl) {
+  struct zone_data *z;
+  int i, j, cmds;
+
+  write_int(fl, top_of_zone_table + 1);
+  for (i = 0; i <= top_of_zone_table; i++) {
+    z = &zone_table[i];
+    fwrite(z, sizeof(*z), 1, fl);
+    write_string(fl, z->name);
+    write_string(fl, z->builders);
+    for (cmds = 0; z->cmd && z->cmd[cmds++].command != 'S';)
+      ;
+    write_int(fl, cmds);
+    if (cmds)
+      fwrite(z->cmd, sizeof(struct reset_com), cmds, fl);
+    for (j = 0; j < cmds; j++) {
+      write_string(fl, z->cmd[j].sarg1);
+      write_string(fl, z->cmd[j].sarg2);
+    }
+  }
+}
+
+static void read_triggers(struct snapshot_reader *r) {
+  int num = read_count(r, sizeof(struct index_data) + sizeof(struct trig_data));
+  int i, lines;
+  struct cmdlist_element **tail;
+  struct index_data *t_index;
+  struct trig_data *trig;
+
+  top_of_trigt = num;
+  if (!num)
+    return;
+  CREATE(trig_index, struct index_data *, num);
+
+  for (i = 0; i < num; i++) {
+    CREATE(t_index, struct index_data, 1);
+    trig = slab_alloc(&trig_slab);
+    read_raw(r, t_index, sizeof(*t_index));
+    read_raw(r, trig, sizeof(*trig));
+    t_index->number = 0;
+    t_index->func = NULL;
+    t_index->farg = NULL;
+    t_index->proto = trig;
+
+    trig->name = read_string(r);
+    trig->arglist = read_string(r);
+    trig->cmdlist = trig->curr_state = NULL;
+    for (tail = &trig->cmdlist, lines = read_count(r, sizeof(int)); lines--;
+         tail = &(*tail)->next) {
+      CREATE(*tail, struct cmdlist_element, 1);
+      (*tail)->cmd = read_string(r);
+    }
+    compile_trigger(trig);
+    trig->wait_event = NULL;
+    trig->var_list = NULL;
+    trig->next = trig->next_in_world = NULL;
+    trig_index[i] = t_index;
+  }
+}
+
+static void write_triggers(FILE *fl) {
+  struct cmdlist_element *cle;
+  struct trig_data *trig;
+  int i, lines;
+
+  write_int(fl, top_of_trigt);
+  for (i = 0; i < top_of_trigt; i++) {
+    trig = trig_index[i]->proto;
+    fwrite(trig_index[i], sizeof(struct index_data), 1, fl);
+    fwrite(trig, sizeof(struct trig_data), 1, fl);
+    write_string(fl, trig->name);
+    write_string(fl, trig->arglist);
+    for (lines = 0, cle = trig->cmdlist; cle; cle = cle->next)
+      lines++;
+    write_int(fl, lines);
+    for (cle = trig->cmdlist; cle; cle = cle->next)
+      write_string(fl, cle->cmd);
+  }
+}
+
+static void read_rooms(struct snapshot_reader *r) {
+  int num = read_count(r, sizeof(struct room_data)), i, dir;
+  struct room_direction_data *exit;
+  struct room_data *room;
+
+  if (!num) {
+    r->bad = TRUE;
+    return;
+  }
+  CREATE(world, struct room_data, num);
+  top_of_world = num - 1;
+
+  for (i = 0; i < num; i++) {
+    room = &world[i];
+    read_raw(r, room, sizeof(*room));
+    room->name = read_pooled_string(r);
+    room->description = read_pooled_string(r);
+    room->ex_description = read_ex_descs(r);
+    for (dir = 0; dir < NUM_OF_DIRS; dir++) {
+      room->dir_option[dir] = NULL;
+      if (!read_int(r))
+        continue;
+      CREATE(exit, struct room_direction_data, 1);
+      read_raw(r, exit, sizeof(*exit));
+      exit->general_description = read_pooled_string(r);
+      exit->keyword = read_pooled_string(r);
+      room->dir_option[dir] = exit;
+    }
+    room->func = NULL;
+    room->proto_script = read_proto_script(r);
+    room->script = NULL;
+    room->contents = NULL;
+    room->people = NULL;
+    room->events = NULL;
+  }
+}
+
+static void write_rooms(FILE *fl) {
+  struct room_direction_data *exit;
+  struct room_data *room;
+  int i, dir;
+
+  write_int(fl, top_of_world + 1);
+  for (i = 0; i <= top_of_world; i++) {
+    room = &world[i];
+    fwrite(room, sizeof(*room), 1, fl);
+    write_string(fl, room->name);
+    write_string(fl, room->description);
+    write_ex_descs(fl, room->ex_description);
+    for (dir = 0; dir < NUM_OF_DIRS; dir++) {
+      exit = room->dir_option[dir];
+      write_int(fl, exit != NULL);
+      if (!exit)
+        continue;
+      fwrite(exit, sizeof(*exit), 1, fl);
+      write_string(fl, exit->general_description);
+      write_string(fl, exit->keyword);
+    }
+    write_proto_script(fl, room->proto_script);
+  }
+}
+
+static void read_mobiles(struct snapshot_reader *r) {
+  int num = read_count(r, sizeof(struct index_data) + sizeof(struct char_data));
+  struct char_data *mob;
+  int i;
+
+  if (!num) {
+    r->bad = TRUE;
+    return;
+  }
+  CREATE(mob_index, struct index_data, num);
+  CREATE(mob_proto, struct char_data, num);
+  top_of_mobt = num - 1;
+
+  for (i = 0; i < num; i++) {
+    read_raw(r, &mob_index[i], sizeof(struct index_data));
+    mob_index[i].number = 0;
+    mob_index[i].func = NULL;
+    mob_index[i].farg = NULL;
+    mob_index[i].proto = NULL;
+
+    mob = &mob_proto[i];
+    read_raw(r, mob, sizeof(*mob));
+    mob->player.name = read_pooled_string(r);
+    mob->player.keywords = str_keywords(mob->player.name);
+    mob->player.short_descr = read_pooled_string(r);
+    mob->player.long_descr = read_pooled_string(r);
+    mob->player.description = read_pooled_string(r);
+    mob->player.title = read_string(r);
+    mob->player_specials = &dummy_mob;
+    mob->proto_script = read_proto_script(r);
+    mob->script = NULL;
+  }
+}
+
+static void write_mobiles(FILE *fl) {
+  struct char_data *mob;
+  int i;
+
+  write_int(fl, top_of_mobt + 1);
+  for (i = 0; i <= top_of_mobt; i++) {
+    mob = &mob_proto[i];
+    fwrite(&mob_index[i], sizeof(struct index_data), 1, fl);
+    fwrite(mob, sizeof(*mob), 1, fl);
+    write_string(fl, mob->player.name);
+    write_string(fl, mob->player.short_descr);
+    write_string(fl, mob->player.long_descr);
+    write_string(fl, mob->player.description);
+    write_string(fl, mob->player.title);
+    write_proto_script(fl, mob->proto_script);
+  }
+}
+
+static void read_objects(struct snapshot_reader *r) {
+  int num = read_count(r, sizeof(struct index_data) + sizeof(struct obj_data));
+  struct obj_data *obj;
+  int i;
+
+  if (!num) {
+    r->bad = TRUE;
+    return;
+  }
+  CREATE(obj_index, struct index_data, num);
+  CREATE(obj_proto, struct obj_data, num);
+  top_of_objt = num - 1;
+
+  for (i = 0; i < num; i++) {
+    read_raw(r, &obj_index[i], sizeof(struct index_data));
+    obj_index[i].number = 0;
+    obj_index[i].func = NULL;
+    obj_index[i].farg = NULL;
+    obj_index[i].proto = NULL;
+
+    obj = &obj_proto[i];
+    read_raw(r, obj, sizeof(*obj));
+    obj->name = read_pooled_string(r);
+    obj->keywords = str_keywords(obj->name);
+    obj->description = read_pooled_string(r);
+    obj->short_description = read_pooled_string(r);
+    obj->action_description = read_pooled_string(r);
+    obj->ex_description = read_ex_descs(r);
+    obj->proto_script = read_proto_script(r);
+    obj->script = NULL;
+  }
+}
+
+static void write_objects(FILE *fl) {
+  struct obj_data *obj;
+  int i;
+
+  write_int(fl, top_of_objt + 1);
+  for (i = 0; i <= top_of_objt; i++) {
+    obj = &obj_proto[i];
+    fwrite(&obj_index[i], sizeof(struct index_data), 1, fl);
+    fwrite(obj, sizeof(*obj), 1, fl);
+    write_string(fl, obj->name);
+    write_string(fl, obj->description);
+    write_string(fl, obj->short_description);
+    write_string(fl, obj->action_description);
+    write_ex_descs(fl, obj->ex_description);
+    write_proto_script(fl, obj->proto_script);
+  }
+}
+
+/* Loads the zones, triggers, rooms, mobiles and objects from the world
+ * snapshot, as boot_world() would leave them after renumbering.  Returns
+ * FALSE, having loaded nothing, if the files have to be parsed instead. */
+int load_world_snapshot(void) {
+  struct snapshot_reader r;
+  room_rnum i;
+
+  collect_sources(&world_sources, world_prefixes,
+                  sizeof(world_prefixes) / sizeof(world_prefixes[0]));
+  if (!open_snapshot(WORLD_SNAPSHOT_FILE, &world_sources, &r))
+    return (FALSE);
+
+  log("Loading world from snapshot %s.", WORLD_SNAPSHOT_FILE);
+  read_zones(&r);
+  read_triggers(&r);
+  read_rooms(&r);
+  read_mobiles(&r);
+  read_objects(&r);
+  close_snapshot(&r, WORLD_SNAPSHOT_FILE);
+
+  map_zone_vnums();
+  sort_vnum_order(DB_BOOT_WLD);
+  sort_vnum_order(DB_BOOT_MOB);
+  sort_vnum_order(DB_BOOT_OBJ);
+
+  for (i = 0; i <= top_of_world; i++)
+    if (world[i].proto_script)
+      assign_triggers(&world[i], WLD_TRIGGER);
+
+  log("   %d zones, %d triggers, %d rooms, %d mobs, %d objs.",
+      top_of_zone_table + 1, top_of_trigt, top_of_world + 1, top_of_mobt + 1,
+      top_of_objt + 1);
+  return (TRUE);
+}
+
+static void write_world(FILE *fl) {
+  write_zones(fl);
+  write_triggers(fl);
+  write_rooms(fl);
+  write_mobiles(fl);
+  write_objects(fl);
+}
+
+/* Called once the world files have been parsed and renumbered. */
+void save_world_snapshot(void) {
+  write_snapshot(WORLD_SNAPSHOT_FILE, &world_sources, write_world);
+}
+
+/* Several keywords of one help entry share its text, and the table is
+ * sorted by keyword, so the text is written with the first keyword that
+ * uses it and the others refer back to that one. */
+struct help_owner {
+  const char *entry;
+  int index;
+};
+
+static int help_owner_cmp(const void *a, const void *b) {
+  const struct help_owner *x = a, *y = b;
+
+  if (x->entry != y->entry)
+    return (x->entry < y->entry ? -1 : 1);
+  return (x->index - y->index);
+}
+
+int load_help_snapshot(void) {
+  struct snapshot_reader r;
+  int num, i, owner;
+
+  collect_sources(&help_sources, help_prefixes,
+                  sizeof(help_prefixes) / sizeof(help_prefixes[0]));
+  if (!open_snapshot(HELP_SNAPSHOT_FILE, &help_sources, &r))
+    return (FALSE);
+
+  if ((num = read_count(&r, sizeof(struct help_index_element))) > 0)
+    CREATE(help_table, struct help_index_element, num);
+  top_of_helpt = num;
+
+  for (i = 0; i < num; i++) {
+    read_raw(&r, &help_table[i], sizeof(struct help_index_element));
+    help_table[i].index = NULL;
+    help_table[i].keywords = read_string(&r);
+    if ((owner = read_int(&r)) == i)
+      help_table[i].entry = read_string(&r);
+    else if (owner >= 0 && owner < i)
+      help_table[i].entry = help_table[owner].entry;
+    else {
+      help_table[i].entry = NULL;
+      r.bad = TRUE;
+    }
+  }
+  close_snapshot(&r, HELP_SNAPSHOT_FILE);
+
+  log("   %d entries from snapshot %s.", top_of_helpt, HELP_SNAPSHOT_FILE);
+  return (TRUE);
+}
+
+static void write_help(FILE *fl) {
+  struct help_owner *owners;
+  int *owner_of, i, j;
+
+  write_int(fl, top_of_helpt);
+  if (!top_of_helpt)
+    return;
+
+  CREATE(owners, struct help_owner, top_of_helpt);
+  CREATE(owner_of, int, top_of_helpt);
+  for (i = 0; i < top_of_helpt; i++) {
+    owners[i].entry = help_table[i].entry;
+    owners[i].index = i;
+  }
+  qsort(owners, top_of_helpt, sizeof(struct help_owner), help_owner_cmp);
+  for (i = 0; i < top_of_helpt; i = j)
+    for (j = i; j < top_of_helpt && owners[j].entry == owners[i].entry; j++)
+      owner_of[owners[j].index] = owners[i].index;
+
+  for (i = 0; i < top_of_helpt; i++) {
+    fwrite(&help_table[i], sizeof(struct help_index_element), 1, fl);
+    write_string(fl, help_table[i].keywords);
+    write_int(fl, owner_of[i]);
+    if (owner_of[i] == i)
+      write_string(fl, help_table[i].entry);
+  }
+  free(owners);
+  free(owner_of);
+}
+
+/* Called once the help files have been parsed and sorted at boot. */
+void save_help_snapshot(void) {
+  write_snapshot(HELP_SNAPSHOT_FILE, &help_sources, write_help);
+}
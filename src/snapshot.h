@@ -0,0 +1,25 @@
+/**
+* @file snapshot.h
+* Compiled snapshots of the world and help files, for fast boots.
+*
+* Part of the core tbaMUD source code distribution, which is a derivative
+* of, and continuation of, CircleMUD.
+*
+* All rights reserved.  See license for complete information.
+* Copyright (C) 1993, 94 by the Trustees of the Johns Hopkins University
+* CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.
+*/
+#ifndef _SNAPSHOT_H_
+#define _SNAPSHOT_H_
+
+/** Bump whenever the parsers change what they store for a record, so older
+ * snapshots are parsed again instead of loaded. */
+#define SNAPSHOT_VERSION   1
+
+/* Functions */
+int load_world_snapshot(void);
+void save_world_snapshot(void);
+int load_help_snapshot(void);
+void save_help_snapshot(void);
+
+#endif /* _SNAPSHOT_H_ */
@@ -558,7 +558,7 @@ ACMD(do_cast)
 
     if (!target && IS_SET(SINFO.targets, TAR_OBJ_EQUIP)) {
       for (i = 0; !target && i < NUM_WEARS; i++)
-	if (GET_EQ(ch, i) && isname(t, GET_EQ(ch, i)->name)) {
+	if (GET_EQ(ch, i) && isname_obj(t, GET_EQ(ch, i))) {
 	  tobj = GET_EQ(ch, i);
 	  target = TRUE;
 	}
@@ -162,7 +162,7 @@ ASPELL(spell_summon)
 }
 
 /* Used by the locate object spell to check the alias list on objects */
-static int isname_obj(char *search, char *list)
+static int isname_locate(char *search, char *list)
 {
   char *found_in_list; /* But could be something like 'ring' in 'shimmering.' */
   char searchname[128];
@@ -225,7 +225,7 @@ ASPELL(spell_locate_object)
   j = GET_LEVEL(ch) / 2;  /* # items to show = twice char's level */
 
   for (i = object_list; i && (j > 0); i = i->next) {
-    if (!isname_obj(name, i->name))
+    if (!isname_locate(name, i->name))
       continue;
 
   send_to_char(ch, "%c%s", UPPER(*i->short_description), i->short_description + 1);
@@ -0,0 +1,309 @@
+/**************************************************************************
+ *  File: strpool.c                                         Part of tbaMUD *
+ *  Usage: Shared, reference counted copies of world text.                 *
+ *                                                                         *
+ *  All rights reserved.  See license for complete information.            *
+ *                                                                         *
+ *  Copyright (C) 1993, 94 by the Trustees of the Johns Hopkins University *
+ *  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+ **************************************************************************/
+
+#include "conf.h"
+#include "sysdep.h"
+#include "structs.h"
+#include "utils.h"
+#include "comm.h"
+#include "handler.h"
+#include "strpool.h"
+
+/* Room, exit, extra description, mobile and object prototype text is kept
+ * here, one copy of each distinct string, so the many rooms and prototypes
+ * that share a description or a keyword list share the memory as well.
+ * The loaders and the OLC save paths put strings in with str_intern(), and
+ * whatever frees them must use str_release() instead of free().
+ *
+ * A pooled string must never be changed in place.  Working copies that OLC
+ * and the string editor change are ordinary strings, and str_release()
+ * frees a string that is not in the pool as free() would, so code that may
+ * hold either kind can always release.
+ *
+ * Strings are packed into large blocks rather than allocated one by one, as
+ * the malloc header and rounding on tens of thousands of short keyword lists
+ * would cost about as much as sharing saves.  The space of a string nobody
+ * references any more is not reused; OLC edits are rare enough that this is
+ * only reported, by 'show strings'.
+ *
+ * A pooled keyword list can also carry the words of it split out for
+ * isname(), made the first time str_keywords() asks for them.  As the space
+ * of a pooled string is never reused, a character or object can tell the
+ * split list still belongs to its name by comparing the addresses.  Split
+ * lists are kept until shutdown, even once their string is released.
+ *
+ * World files are parsed on several threads at boot, so the pool is locked
+ * whenever it is used. */
+
+/* The text follows the header in the block. */
+struct pooled_string {
+  struct pooled_string *next;   /* next in the hash chain */
+  unsigned int hash;
+  int refs;
+  struct keyword_list *keywords; /* split by str_keywords(), or NULL */
+};
+
+#define POOL_TEXT(ps)  ((char *)((ps) + 1))
+/* Block space taken by a string of len bytes, kept aligned for the header. */
+#define POOL_SPACE(len) \
+  ((sizeof(struct pooled_string) + (len) + sizeof(void *)) & ~(sizeof(void *) - 1))
+
+struct pool_block {
+  struct pool_block *next;
+  size_t size, used;
+  char *mem;
+};
+
+static struct pooled_string **pool_table = NULL;
+static unsigned int pool_buckets = 0;
+static struct pool_block *pool_blocks = NULL;
+
+/* Statistics for 'show strings'. */
+static int pool_strings = 0;          /* distinct strings held */
+static long pool_refs = 0;            /* references to them */
+static long pool_bytes = 0;           /* text held, terminators included */
+static long pool_saved = 0;           /* text the extra references would use */
+static long pool_released = 0;        /* block space of released strings */
+static long pool_allocated = 0;       /* block space in all */
+static unsigned long pool_lookups = 0, pool_hits = 0;
+static int pool_keyword_lists = 0;    /* split by str_keywords() */
+
+#ifdef CIRCLE_PARALLEL_BOOT
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+#define POOL_LOCK()   pthread_mutex_lock(&pool_lock)
+#define POOL_UNLOCK() pthread_mutex_unlock(&pool_lock)
+#else
+#define POOL_LOCK()
+#define POOL_UNLOCK()
+#endif
+
+/* Local functions */
+static unsigned int pool_hash(const char *str, size_t len);
+static void grow_pool(void);
+static struct pooled_string *pool_alloc(size_t len);
+
+/* FNV-1a. */
+static unsigned int pool_hash(const char *str, size_t len) {
+  unsigned int h = 2166136261U;
+
+  while (len--)
+    h = (h ^ (unsigned char)*str++) * 16777619U;
+
+  return (h);
+}
+
+static void grow_pool(void) {
+  struct pooled_string **table, *ps, *next;
+  unsigned int buckets, i;
+
+  buckets = pool_buckets ? pool_buckets * 2 : STRPOOL_MIN_BUCKETS;
+  CREATE(table, struct pooled_string *, buckets);
+
+  for (i = 0; i < pool_buckets; i++)
+    for (ps = pool_table[i]; ps; ps = next) {
+      next = ps->next;
+      ps->next = table[ps->hash & (buckets - 1)];
+      table[ps->hash & (buckets - 1)] = ps;
+    }
+
+  if (pool_table)
+    free(pool_table);
+  pool_table = table;
+  pool_buckets = buckets;
+}
+
+/* Carves room for a string of len bytes, terminator excluded, out of the
+ * current block.  Strings too long to share a block get one to themselves. */
+static struct pooled_string *pool_alloc(size_t len) {
+  struct pool_block *block = pool_blocks;
+  size_t need = POOL_SPACE(len);
+  struct pooled_string *ps;
+
+  if (!block || block->size - block->used < need) {
+    CREATE(block, struct pool_block, 1);
+    block->size = MAX(STRPOOL_BLOCK_SIZE, need);
+    CREATE(block->mem, char, block->size);
+    pool_allocated += block->size;
+
+    /* A block made for one long string must not replace the one being
+     * filled, or the rest of that one would be wasted. */
+    if (pool_blocks && block->size > STRPOOL_BLOCK_SIZE) {
+      block->next = pool_blocks->next;
+      pool_blocks->next = block;
+    } else {
+      block->next = pool_blocks;
+      pool_blocks = block;
+    }
+  }
+
+  ps = (struct pooled_string *)(block->mem + block->used);
+  block->used += need;
+
+  return (ps);
+}
+
+/* Returns the pooled copy of the first len bytes of str, with a reference
+ * for the caller. */
+char *str_intern_len(const char *str, size_t len) {
+  struct pooled_string *ps;
+  unsigned int hash;
+
+  if (!str)
+    return (NULL);
+
+  hash = pool_hash(str, len);
+
+  POOL_LOCK();
+  pool_lookups++;
+  if (pool_buckets)
+    for (ps = pool_table[hash & (pool_buckets - 1)]; ps; ps = ps->next)
+      if (ps->hash == hash && !strncmp(POOL_TEXT(ps), str, len) &&
+          !POOL_TEXT(ps)[len]) {
+        ps->refs++;
+        pool_refs++;
+        pool_hits++;
+        pool_saved += len + 1;
+        POOL_UNLOCK();
+        return (POOL_TEXT(ps));
+      }
+
+  if (pool_strings >= (int)pool_buckets * STRPOOL_LOAD)
+    grow_pool();
+
+  ps = pool_alloc(len);
+  ps->hash = hash;
+  ps->refs = 1;
+  ps->keywords = NULL;
+  memcpy(POOL_TEXT(ps), str, len);
+  POOL_TEXT(ps)[len] = '\0';
+  ps->next = pool_table[hash & (pool_buckets - 1)];
+  pool_table[hash & (pool_buckets - 1)] = ps;
+
+  pool_strings++;
+  pool_refs++;
+  pool_bytes += len + 1;
+  POOL_UNLOCK();
+
+  return (POOL_TEXT(ps));
+}
+
+char *str_intern(const char *str) {
+  return (str ? str_intern_len(str, strlen(str)) : NULL);
+}
+
+/* Pools a string from malloc(), which is freed.  Use the return value. */
+char *str_intern_move(char *str) {
+  char *pooled;
+
+  if (!str)
+    return (NULL);
+
+  pooled = str_intern(str);
+  free(str);
+
+  return (pooled);
+}
+
+/* Drops a reference to a pooled string, or frees any other string. */
+void str_release(char *str) {
+  struct pooled_string *ps, **link;
+  unsigned int hash;
+  size_t len;
+
+  if (!str)
+    return;
+
+  len = strlen(str);
+  hash = pool_hash(str, len);
+
+  POOL_LOCK();
+  if (pool_buckets)
+    for (link = &pool_table[hash & (pool_buckets - 1)]; (ps = *link) != NULL;
+         link = &ps->next)
+      if (POOL_TEXT(ps) == str) {
+        pool_refs--;
+        if (--ps->refs > 0)
+          pool_saved -= len + 1;
+        else {
+          *link = ps->next;
+          pool_strings--;
+          pool_bytes -= len + 1;
+          pool_released += POOL_SPACE(len);
+        }
+        POOL_UNLOCK();
+        return;
+      }
+  POOL_UNLOCK();
+
+  free(str);
+}
+
+/* Returns the keyword list split from a pooled string, splitting it the
+ * first time, or NULL if str is not in the pool. */
+struct keyword_list *str_keywords(const char *str) {
+  struct pooled_string *ps;
+  struct keyword_list *kw = NULL;
+  unsigned int hash;
+
+  if (!str)
+    return (NULL);
+
+  hash = pool_hash(str, strlen(str));
+
+  POOL_LOCK();
+  if (pool_buckets)
+    for (ps = pool_table[hash & (pool_buckets - 1)]; ps; ps = ps->next)
+      if (POOL_TEXT(ps) == str) {
+        if (!ps->keywords) {
+          ps->keywords = split_keywords(str);
+          pool_keyword_lists++;
+        }
+        kw = ps->keywords;
+        break;
+      }
+  POOL_UNLOCK();
+
+  return (kw);
+}
+
+void show_string_pool(struct char_data *ch) {
+  struct pooled_string *ps;
+  unsigned int i;
+  int chain, longest = 0;
+  long overhead;
+
+  POOL_LOCK();
+  for (i = 0; i < pool_buckets; i++) {
+    for (chain = 0, ps = pool_table[i]; ps; ps = ps->next)
+      chain++;
+    longest = MAX(longest, chain);
+  }
+  /* Everything allocated that is not live text: headers, padding, the unused
+   * end of each block and the hash table. */
+  overhead = pool_allocated - pool_bytes - pool_released +
+             (long)pool_buckets * (long)sizeof(struct pooled_string *);
+
+  send_to_char(ch,
+               "String pool: %d strings, %ld references\r\n"
+               "  Text held  : %ld bytes, plus %ld bytes of pool overhead\r\n"
+               "  Text shared: %ld bytes not stored twice (%ld%% of the "
+               "text referenced)\r\n"
+               "  Released   : %ld bytes no longer referenced\r\n"
+               "  Lookups    : %lu, %lu found an existing string\r\n"
+               "  Buckets    : %u, longest chain %d\r\n"
+               "  Keywords   : %d names split for isname()\r\n",
+               pool_strings, pool_refs, pool_bytes, overhead, pool_saved,
+               pool_bytes + pool_saved
+                   ? (pool_saved * 100) / (pool_bytes + pool_saved)
+                   : 0,
+               pool_released, pool_lookups, pool_hits, pool_buckets, longest,
+               pool_keyword_lists);
+  POOL_UNLOCK();
+}
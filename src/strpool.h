@@ -0,0 +1,30 @@
+/**
+* @file strpool.h
+* Shared, reference counted copies of world text.
+*
+* Part of the core tbaMUD source code distribution, which is a derivative
+* of, and continuation of, CircleMUD.
+*
+* All rights reserved.  See license for complete information.
+* Copyright (C) 1993, 94 by the Trustees of the Johns Hopkins University
+* CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.
+*/
+#ifndef _STRPOOL_H_
+#define _STRPOOL_H_
+
+/** Hash buckets the pool starts with; it doubles as it fills. */
+#define STRPOOL_MIN_BUCKETS  4096
+/** Average hash chain length at which the pool doubles its buckets. */
+#define STRPOOL_LOAD         2
+/** Strings are packed into blocks of this many bytes. */
+#define STRPOOL_BLOCK_SIZE   65536
+
+/* Functions */
+char *str_intern(const char *str);
+char *str_intern_len(const char *str, size_t len);
+char *str_intern_move(char *str);
+void str_release(char *str);
+struct keyword_list *str_keywords(const char *str);
+void show_string_pool(struct char_data *ch);
+
+#endif /* _STRPOOL_H_ */
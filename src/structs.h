@@ -602,6 +602,9 @@
 #define MAX_PROMPT_LENGTH 96     /**< Max length of prompt        */
 #define GARBAGE_SPACE 32         /**< Space for **OVERFLOW** etc  */
 #define SMALL_BUFSIZE 1024       /**< Static output buffer size   */
+#define OUT_BLOCK_SIZE 4096      /**< Size of one queued output block */
+/** Seconds mccp_drain() waits for the end of a compressed stream to go out */
+#define MCCP_DRAIN_TIMEOUT 2
 /** Max amount of output that can be buffered */
 #define LARGE_BUFSIZE (MAX_SOCK_BUF - GARBAGE_SPACE - MAX_PROMPT_LENGTH)
 
@@ -713,6 +716,15 @@ struct obj_affected_type {
   sbyte modifier; /**< How much it changes by              */
 };
 
+/** A name split into lowercased keywords once, so isname() need not split it
+ * on every call.  Lists belong to the string pool and are shared by every
+ * prototype and instance whose name is the same pooled string. */
+struct keyword_list {
+  const char *src; /**< The name that was split. */
+  int count;       /**< Number of keywords. */
+  char **words;    /**< The keywords. */
+};
+
 /** The Object structure. */
 struct obj_data {
   obj_rnum item_number; /**< The unique id of this object instance. */
@@ -722,6 +734,7 @@ struct obj_data {
   struct obj_affected_type affected[MAX_OBJ_AFFECT]; /**< affects */
 
   char *name;               /**< Keyword reference(s) for object. */
+  struct keyword_list *keywords; /**< name split up, if it is pooled */
   char *description;        /**< Shown when the object is lying in a room. */
   char *short_description;  /**< Shown when worn, carried, in a container */
   char *action_description; /**< Displays when (if) the object is used */
@@ -742,6 +755,12 @@ struct obj_data {
   struct char_data *sitting_here; /**< For furniture, who is sitting in it */
 
   struct list_data *events; /**< Used for object events */
+
+  /* Kept by set_obj_timer(); read the timer of a live object with
+   * obj_timer(). */
+  long timer_expires;               /**< point_update() pass the timer runs out on */
+  struct obj_data *next_timed;      /**< Next object in the same timer wheel slot */
+  struct obj_data **timed_link;     /**< What points at this one, NULL if untimed */
 };
 
 /** Instance info for an object that gets saved to disk.
@@ -864,6 +883,7 @@ struct pclean_criteria_data {
 struct char_player_data {
   char passwd[MAX_PWD_LENGTH + 1]; /**< PC's password */
   char *name;                      /**< PC / NPC name */
+  struct keyword_list *keywords;   /**< name split up, if it is pooled */
   char *short_descr;               /**< NPC 'actions' */
   char *long_descr;                /**< PC / NPC look description */
   char *description;               /**< NPC Extra descriptions */
@@ -935,6 +955,7 @@ struct char_special_data {
   int carry_weight; /**< Carried weight */
   byte carry_items; /**< Number of items carried */
   int timer;        /**< Timer for update */
+  bool zone_counted; /**< Counted in its zone's players; see handler.c */
 
   struct char_special_data_saved saved; /**< Constants saved for PCs. */
 };
@@ -998,6 +1019,10 @@ struct affected_type {
   byte location;   /**< Tells which ability to change(APPLY_XXX). */
   int bitvector[AF_ARRAY_MAX]; /**< Tells which bits to set (AFF_XXX). */
 
+  /* Kept by affect_to_char(); read what is left with affect_duration(). */
+  long expires;             /**< affect_update() pass it wears off on */
+  struct q_element *expiry; /**< Place in the expiry queue, NULL if permanent */
+
   struct affected_type *next; /**< The next affect in the list of affects. */
 };
 
@@ -1062,6 +1087,16 @@ struct txt_q {
   struct txt_block *tail; /**< ? */
 };
 
+/** A block of queued output. A descriptor's output is a chain of these, which
+ * process_output() hands to the kernel with one writev(). A partial write
+ * only advances start; nothing is moved. */
+struct out_block {
+  struct out_block *next;    /**< Next block in the chain or the free pool */
+  int start;                 /**< First byte not yet written */
+  int end;                   /**< End of the text in this block */
+  char text[OUT_BLOCK_SIZE]; /**< The output itself, not NUL terminated */
+};
+
 /** Master structure players. Holds the real players connection to the mud.
  * An analogy is the char_data is the body of the character, the descriptor_data
  * is the soul. */
@@ -1082,15 +1117,16 @@ struct descriptor_data {
   size_t max_str;                   /**< maximum size of string in modify-str	*/
   long mail_to;                     /**< name for mail system			*/
   int has_prompt;                   /**< is the user at a prompt?             */
+  bool output_blocked;              /**< socket full, waiting for EPOLLOUT  */
   char inbuf[MAX_RAW_INPUT_LENGTH]; /**< buffer for raw input		*/
   char last_input[MAX_INPUT_LENGTH]; /**< the last input */
-  char small_outbuf[SMALL_BUFSIZE];  /**< standard output buffer		*/
-  char *output;                      /**< ptr to the current output buffer	*/
+  struct out_block *output;          /**< queued output, NULL if none	*/
+  struct out_block *output_tail;     /**< block new output is added to	*/
   char **history;                    /**< History of commands, for ! mostly.	*/
   int history_pos;                   /**< Circular array position.		*/
-  int bufptr;                        /**< ptr to end of current output		*/
-  int bufspace;                      /**< space left in the output buffer	*/
-  struct txt_block *large_outbuf;    /**< ptr to large buffer, if we need it */
+  int bufptr;                        /**< bytes of output queued		*/
+  int bufspace;                      /**< space left before output overflows	*/
+  struct mccp_data *mccp;            /**< MCCP compression, NULL if none	*/
   struct txt_q input;                /**< q of unprocessed input		*/
   struct char_data *character;       /**< linked to char			*/
   struct char_data *original;        /**< original char if switched		*/
@@ -1342,6 +1378,8 @@ struct game_operation {
   int special_in_comm; /**< Enable use of a special character in communication
                           channels ? */
   int debug_mode;      /**< Current Debug Mode */
+  int mccp_level;      /**< MCCP compression level, 0 for no MCCP */
+  int hibernate_time;  /**< Minutes empty before a zone hibernates, 0 for never */
 };
 
 /** The Autowizard options. */
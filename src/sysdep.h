@@ -37,6 +37,13 @@
  * your MUD is freezing because of a non-blocking I/O problem. */
 /* #define POSIX_NONBLOCK_BROKEN */
 
+/* On systems with epoll(7) and timerfd(2) (Linux), the game loop waits for
+ * socket activity with epoll and is paced by a timerfd, so each pulse only
+ * touches descriptors that actually became ready and the player limit is no
+ * longer bound by FD_SETSIZE.  #define CIRCLE_USE_SELECT to fall back to the
+ * portable select() loop used on every other platform. */
+/* #define CIRCLE_USE_SELECT */
+
 /* The code prototypes library functions to avoid compiler warnings. (Operating
  * system header files *should* do this, but sometimes don't.) However, Circle's
  * prototypes cause the compilation to fail under some combinations of operating
@@ -189,6 +196,36 @@ struct in_addr {
 #include <sys/fcntl.h>
 #endif
 
+#if defined(HAVE_SYS_EPOLL_H) && defined(HAVE_SYS_TIMERFD_H) && \
+    !defined(CIRCLE_USE_SELECT)
+# define CIRCLE_EPOLL
+# include <sys/epoll.h>
+# include <sys/timerfd.h>
+#endif
+
+/* Player and rent files are written by a background thread unless
+ * CIRCLE_SYNC_SAVES is defined.  See savequeue.c. */
+#if defined(HAVE_PTHREAD_H) && !defined(CIRCLE_SYNC_SAVES)
+# define CIRCLE_SAVE_THREAD
+# include <pthread.h>
+#endif
+
+/* World files are parsed by a pool of threads at boot unless
+ * CIRCLE_SERIAL_BOOT is defined or the game is started with --serial-boot.
+ * See index_boot() in db.c. */
+#if defined(HAVE_PTHREAD_H) && !defined(CIRCLE_SERIAL_BOOT)
+# define CIRCLE_PARALLEL_BOOT
+# include <pthread.h>
+# include <setjmp.h>
+#endif
+
+/* The world and help files are loaded from a compiled snapshot when it is
+ * current, unless CIRCLE_NO_SNAPSHOT is defined.  See snapshot.c. */
+#if defined(HAVE_SYS_MMAN_H) && !defined(CIRCLE_NO_SNAPSHOT)
+# define CIRCLE_SNAPSHOT
+# include <sys/mman.h>
+#endif
+
 #ifdef HAVE_SYS_SOCKET_H
 # include <sys/socket.h>
 #endif
@@ -225,6 +262,12 @@ struct in_addr {
 
 #ifdef HAVE_SYS_UIO_H
 # include <sys/uio.h>
+#else
+/* Used by comm.c to gather output; written out piece by piece without it. */
+struct iovec {
+  void *iov_base;
+  size_t iov_len;
+};
 #endif
 
 #ifdef HAVE_SYS_STAT_H
@@ -202,6 +202,10 @@ void basic_mud_vlog(const char *format, va_list args)
   if (format == NULL)
     format = "SYSERR: log() received a NULL format.";
 
+  /* Held back while a boot thread parses a world file. */
+  if (boot_log_capture(format, args))
+    return;
+
   for (i=0;i<21;i++) timestr[i]=0;
   strftime(timestr, sizeof(timestr), "%b %d %H:%M:%S %Y", localtime(&ct));
 
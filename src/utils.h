@@ -135,6 +135,11 @@ void gain_exp(struct char_data *ch, int gain);
 void gain_exp_regardless(struct char_data *ch, int gain);
 void gain_condition(struct char_data *ch, int condition, int value);
 void point_update(void);
+void hibernate_zone(zone_rnum zone);
+void set_obj_timer(struct obj_data *obj, int timer);
+int obj_timer(struct obj_data *obj);
+void clear_obj_timer(struct obj_data *obj);
+void wake_zone(zone_rnum zone);
 void update_pos(struct char_data *victim);
 void run_autowiz(void);
 int increase_gold(struct char_data *ch, int amt);
@@ -778,7 +783,8 @@ void char_from_furniture(struct char_data *ch);
 #define GET_OBJ_VAL(obj, val) ((obj)->obj_flags.value[(val)])
 /** Weight of obj. */
 #define GET_OBJ_WEIGHT(obj) ((obj)->obj_flags.weight)
-/** Current timer of obj. */
+/** Timer obj was set to. For an object in the game, obj_timer() gives what
+ * it has counted down to, and set_obj_timer() must be used to change it. */
 #define GET_OBJ_TIMER(obj) ((obj)->obj_flags.timer)
 /** Real number of obj instance. */
 #define GET_OBJ_RNUM(obj) ((obj)->item_number)
@@ -1142,6 +1148,10 @@ void char_from_furniture(struct char_data *ch);
 #define CONFIG_SPECIAL_IN_COMM config_info.operation.special_in_comm
 /** Activate debug mode? */
 #define CONFIG_DEBUG_MODE config_info.operation.debug_mode
+/** MCCP compression level (0 disables MCCP) */
+#define CONFIG_MCCP_LEVEL config_info.operation.mccp_level
+/** Minutes a zone stays empty before it hibernates (0 never) */
+#define CONFIG_HIBERNATE_TIME config_info.operation.hibernate_time
 
 /* Autowiz */
 /** Use autowiz or not? */